@@ -0,0 +1,236 @@
+// Times the public API call by call: begin(), registration queries,
+// attachData(), sockets, HTTP(S) and MQTT. For every API it reports p50/p95/p99
+// latency, throughput where a payload is involved and, on ESP32, heap usage.
+// The results end with one line of JSON that can be saved per release and
+// compared for regressions; bytes_per_sec is rounded to whole bytes.
+//
+// On a board it measures the module on SerialAT; the URLs below must be
+// reachable. The host build (extras/host) compiles it with USE_SIMULATOR=1
+// against EC200USimulator (no hardware).
+#include <QuectelEC200U.h>
+
+#ifndef USE_SIMULATOR
+#define USE_SIMULATOR 0
+#endif
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+static const char APN[] = "internet";
+static const char HTTP_URL[] = "http://postman-echo.com/get";
+static const char HTTPS_URL[] = "https://postman-echo.com/get";
+static const char POST_URL[] = "http://postman-echo.com/post";
+static const char STREAM_URL[] = "http://httpbin.org/bytes/32768";
+static const char TCP_HOST[] = "tcpbin.com";
+static const int TCP_PORT = 4242;
+static const char MQTT_BROKER[] = "broker.hivemq.com";
+
+static const size_t MAX_RUNS = 32;
+static const size_t TCP_CHUNK = 1024;
+static const size_t SIM_BODY_BYTES = 1024;
+static const size_t SIM_STREAM_BYTES = 32768;
+
+#if USE_SIMULATOR
+#include <EC200USimulator.h>
+EC200USimulator sim(115200, 20);
+QuectelEC200U modem(sim);
+#elif defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && !USE_SIMULATOR
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+// One call of the API under test; adds the payload bytes it moved to 'bytes'
+typedef bool (*BenchFn)(size_t &bytes);
+
+static String results;      // The per-API JSON objects, comma-separated
+static uint32_t samples[MAX_RUNS];
+static int socketId = -1;
+static String payload;
+
+static void sortSamples(size_t n) {
+  for (size_t i = 1; i < n; i++) {
+    uint32_t v = samples[i];
+    size_t j = i;
+    while (j > 0 && samples[j - 1] > v) {
+      samples[j] = samples[j - 1];
+      j--;
+    }
+    samples[j] = v;
+  }
+}
+
+// Appends ,"key":value to the JSON object being built in 'obj'
+static void jsonField(String &obj, const char *key, unsigned long value) {
+  obj += ",\"";
+  obj += key;
+  obj += "\":";
+  obj += value;
+}
+
+// Nearest-rank percentile of the sorted samples
+static uint32_t percentile(size_t n, uint8_t pct) {
+  size_t rank = (pct * n + 99) / 100;
+  return samples[rank > 0 ? rank - 1 : 0];
+}
+
+static void bench(const char *api, size_t runs, BenchFn fn) {
+  if (runs > MAX_RUNS) {
+    runs = MAX_RUNS;
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  uint32_t freeBefore = ESP.getFreeHeap();
+#endif
+  size_t failures = 0;
+  size_t bytes = 0;
+  uint64_t totalUs = 0;
+  for (size_t i = 0; i < runs; i++) {
+    uint32_t t0 = micros();
+    if (!fn(bytes)) {
+      failures++;
+    }
+    samples[i] = micros() - t0;
+    totalUs += samples[i];
+  }
+  sortSamples(runs);
+
+  String r = "{\"api\":\"";
+  r += api;
+  r += "\"";
+  jsonField(r, "runs", runs);
+  jsonField(r, "failures", failures);
+  jsonField(r, "p50_us", percentile(runs, 50));
+  jsonField(r, "p95_us", percentile(runs, 95));
+  jsonField(r, "p99_us", percentile(runs, 99));
+  jsonField(r, "max_us", samples[runs - 1]);
+  float bytesPerSec = (bytes > 0 && totalUs > 0) ? bytes * 1000000.0f / totalUs : 0;
+  if (bytes > 0) {
+    jsonField(r, "bytes", bytes);
+    jsonField(r, "bytes_per_sec", (unsigned long)(bytesPerSec + 0.5f));
+  }
+#if defined(ARDUINO_ARCH_ESP32)
+  // The low-water mark is global: the peak is exact when this API set a new
+  // low and an upper bound otherwise.
+  uint32_t lowWater = ESP.getMinFreeHeap();
+  uint32_t freeAfter = ESP.getFreeHeap();
+  jsonField(r, "heap_peak_bytes", freeBefore > lowWater ? freeBefore - lowWater : 0);
+  jsonField(r, "heap_min_free", lowWater);
+  r += ",\"heap_leak_bytes\":";
+  r += (long)(int32_t)(freeBefore - freeAfter);
+#endif
+  r += "}";
+  if (results.length() > 0) {
+    results += ",";
+  }
+  results += r;
+
+  char line[112];
+  snprintf(line, sizeof(line), "%-22s %3u/%-3u p50 %8lu  p95 %8lu  p99 %8lu us",
+           api, (unsigned)(runs - failures), (unsigned)runs,
+           (unsigned long)percentile(runs, 50), (unsigned long)percentile(runs, 95),
+           (unsigned long)percentile(runs, 99));
+  Serial.print(line);
+  if (bytes > 0) {
+    Serial.print(F("  "));
+    Serial.print(bytesPerSec / 1024.0f, 2);
+    Serial.print(F(" KB/s"));
+  }
+  Serial.println();
+}
+
+static bool countBody(const uint8_t *data, size_t len, void *ctx) {
+  (void)data;
+  *(size_t *)ctx += len;
+  return true;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== QuectelEC200U API benchmark =="));
+  powerOnModem();
+
+  payload.reserve(TCP_CHUNK);
+  for (size_t i = 0; i < TCP_CHUNK; i++) {
+    payload += (char)('a' + i % 26);
+  }
+#if USE_SIMULATOR
+  sim.setHttpBodyPattern(SIM_BODY_BYTES);
+#endif
+
+  bench("begin", 1, [](size_t &) { return modem.begin(); });   // Later calls return at once
+  bench("getSignalStrength", 20, [](size_t &) { return modem.getSignalStrength() >= 0; });
+  bench("getRegistrationStatus", 20, [](size_t &) { return modem.getRegistrationStatus() >= 0; });
+  bench("attachData", 3, [](size_t &) { return modem.attachData(APN); });
+
+  bench("socketOpen", 1, [](size_t &) {
+    socketId = modem.socketOpen(TCP_HOST, TCP_PORT);
+    return socketId >= 0 && modem.socketWaitConnected(socketId);
+  });
+  bench("tcpSend 1KB", 10, [](size_t &bytes) {
+    bytes += TCP_CHUNK;
+    return modem.tcpSend(socketId, payload);
+  });
+  bench("socketClose", 1, [](size_t &) { return modem.socketClose(socketId); });
+
+  bench("httpGet", 5, [](size_t &bytes) {
+    String body;
+    bool ok = modem.httpGet(HTTP_URL, body);
+    bytes += body.length();
+    return ok;
+  });
+  bench("httpsGet", 5, [](size_t &bytes) {
+    String body;
+    bool ok = modem.httpsGet(HTTPS_URL, body);
+    bytes += body.length();
+    return ok;
+  });
+  bench("httpPost 1KB", 5, [](size_t &bytes) {
+    String response;
+    bytes += payload.length();
+    return modem.httpPost(POST_URL, payload, response);
+  });
+#if USE_SIMULATOR
+  sim.setHttpBodyPattern(SIM_STREAM_BYTES);
+#endif
+  bench("httpGetStream 32KB", 3, [](size_t &bytes) {
+    return modem.httpGetStream(STREAM_URL, countBody, &bytes);
+  });
+
+  bench("mqttConnect", 1, [](size_t &) { return modem.mqttConnect(MQTT_BROKER, 1883); });
+  bench("mqttPublish", 10, [](size_t &bytes) {
+    static const char message[] = "{\"t\":21.5,\"h\":40}";
+    bytes += sizeof(message) - 1;
+    return modem.mqttPublish("ec200u/bench", message);
+  });
+
+  Serial.println(F("\nJSON:"));
+  // Written by hand so that it needs no JSON library and reads the same on
+  // a board and on the host
+  Serial.print(F("{\"target\":\""));
+  Serial.print(USE_SIMULATOR ? F("simulator") : F("modem"));
+  Serial.print(F("\",\"baud\":115200,\"results\":["));
+  Serial.print(results);
+  Serial.println(F("]}"));
+}
+
+void loop() {}
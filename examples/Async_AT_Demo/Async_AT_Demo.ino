@@ -0,0 +1,103 @@
+#include <QuectelEC200U.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char NTP_SERVER[] = "pool.ntp.org";
+static const int TIMEZONE_QUARTERS = 22; // +05:30
+
+static int ntpHandle = -1;
+static uint32_t lastSample = 0;
+static uint32_t samples = 0;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static void onSignal(int handle, ATStatus status, const char *response, void *ctx) {
+  (void)handle;
+  (void)ctx;
+  if (status == ATStatus::SUCCESS) {
+    Serial.print(F("[CSQ] "));
+    Serial.println(modem.extractInteger(response, F("+CSQ:")));
+  } else {
+    Serial.println(F("[CSQ] failed"));
+  }
+}
+
+static void onNtp(int handle, ATStatus status, const char *response, void *ctx) {
+  (void)handle;
+  (void)ctx;
+  (void)response;
+  Serial.print(F("[NTP] "));
+  Serial.println(status == ATStatus::SUCCESS ? F("synchronised") : F("failed"));
+  Serial.print(F("[NTP] sensor samples taken meanwhile: "));
+  Serial.println(samples);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U Asynchronous AT Demo =="));
+  if (!modem.begin()) {
+    Serial.println(F("Modem init failed"));
+    while (true) {
+      delay(1000);
+    }
+  }
+
+  // Queue a long-running NTP sync and a quick signal query; neither blocks.
+  ntpHandle = modem.ntpSyncAsync(NTP_SERVER, TIMEZONE_QUARTERS, onNtp);
+  modem.sendATAsync(F("AT+CSQ"), onSignal);
+}
+
+void loop() {
+  // Pump the AT engine; callbacks fire from here.
+  modem.poll();
+
+  // The rest of the firmware keeps running while the modem works.
+  if (millis() - lastSample >= 100) {
+    lastSample = millis();
+    samples++;
+  }
+
+  static uint32_t lastStatus = 0;
+  if (millis() - lastStatus >= 5000) {
+    lastStatus = millis();
+    if (modem.getATStatus(ntpHandle) == ATStatus::RUNNING) {
+      Serial.println(F("NTP still running..."));
+    }
+    if (!modem.isBusy()) {
+      modem.sendATAsync(F("AT+CSQ"), onSignal);
+    }
+  }
+}
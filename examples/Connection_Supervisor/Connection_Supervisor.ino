@@ -0,0 +1,123 @@
+// Keeps a TCP connection and an MQTT session alive across coverage loss.
+// ConnectionSupervisor re-attaches, re-activates the PDP context and reopens
+// the socket with jittered exponential backoff; loop() never blocks on it, so
+// the sketch keeps sampling while the link is down.
+#include <QuectelEC200U.h>
+#include <ConnectionSupervisor.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const int PDP_CONTEXT_ID = 1;
+static const int TCP_SOCKET = 0;
+static const char TCP_HOST[] = "tcpbin.com";
+static const int TCP_PORT = 4242;
+static const char MQTT_BROKER[] = "broker.hivemq.com";
+
+ConnectionSupervisor supervisor(modem, PDP_CONTEXT_ID);
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static const char *linkStateName(LinkState state) {
+  switch (state) {
+    case LINK_WAIT_NETWORK: return "waiting for network";
+    case LINK_ATTACHING:    return "attaching";
+    case LINK_CONFIGURING:  return "configuring PDP";
+    case LINK_ACTIVATING:   return "activating PDP";
+    case LINK_RESTORING:    return "restoring sessions";
+    case LINK_UP:           return "up";
+    case LINK_BACKOFF:      return "backing off";
+    default:                return "stopped";
+  }
+}
+
+static void onLinkState(LinkState state, void *ctx) {
+  (void)ctx;
+  Serial.print(F("Link: "));
+  Serial.print(linkStateName(state));
+  if (state == LINK_BACKOFF) {
+    Serial.print(F(", retry in "));
+    Serial.print(supervisor.retryIn());
+    Serial.print(F(" ms (attempt "));
+    Serial.print(supervisor.attempt());
+    Serial.print(F(")"));
+  }
+  Serial.println();
+}
+
+// Runs once the PDP context and the socket are back
+static bool restoreMqtt(QuectelEC200U &m, void *ctx) {
+  (void)ctx;
+  return m.mqttConnect(MQTT_BROKER, 1883);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U Connection Supervisor =="));
+  if (!modem.begin()) {
+    Serial.print(F("Modem not ready: "));
+    Serial.println(modem.getLastErrorString());
+  }
+
+  supervisor.setAPN(APN);
+  supervisor.setBackoff(2000, 120000);
+  supervisor.watchSocket(TCP_SOCKET, TCP_HOST, TCP_PORT);
+  supervisor.addSession(restoreMqtt);
+  supervisor.onStateChange(onLinkState);
+  supervisor.begin();
+}
+
+void loop() {
+  supervisor.loop();
+
+  static uint32_t lastSend = 0;
+  if (millis() - lastSend >= 10000) {
+    lastSend = millis();
+    if (supervisor.isUp()) {
+      static const uint8_t ping[] = "ping\n";
+      modem.socketWrite(TCP_SOCKET, ping, sizeof(ping) - 1);
+      modem.mqttPublish("ec200u/supervisor", "alive");
+    } else {
+      Serial.println(F("Link down, sample kept for later"));
+    }
+  }
+
+  uint8_t buf[64];
+  int n;
+  while ((n = modem.socketRead(TCP_SOCKET, buf, sizeof(buf))) > 0) {
+    Serial.write(buf, n);
+  }
+}
@@ -0,0 +1,155 @@
+// Sends a batch of small telemetry readings to one endpoint and compares it with
+// the same number of plain httpsPost() calls. The batch configures the endpoint
+// once, skips AT+QHTTPREAD and serializes reading i+1 while request i waits for
+// the server. Aggregate requests/s and per-request latency are printed for both.
+#include <QuectelEC200U.h>
+#include <HttpSession.h>
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static void haltForever(const __FlashStringHelper *reason) {
+  Serial.println(reason);
+  while (true) {
+    delay(1000);
+  }
+}
+
+static void requireStep(bool ok, const __FlashStringHelper *label) {
+  if (ok) {
+    Serial.print(F("[ OK ] "));
+    Serial.println(label);
+  } else {
+    Serial.print(F("[FAIL] "));
+    Serial.println(label);
+    haltForever(F("Stopping demo"));
+  }
+}
+
+static const char ENDPOINT[] = "https://postman-echo.com/post";
+static const size_t BATCH = 10;
+
+String headers[] = {String("Content-Type: application/json")};
+HttpSession session(modem);
+HttpBatchEntry entries[BATCH];
+
+// Reading i as a small JSON object
+static bool makeReading(size_t index, String &body, void *ctx) {
+  (void)ctx;
+  JsonDocument doc;
+  doc["seq"] = index;
+  doc["t"] = 21.0 + (index % 10) * 0.1;
+  doc["ts"] = millis();
+  serializeJson(doc, body);
+  return true;
+}
+
+static void printResult(const __FlashStringHelper *label, const HttpBatchResult &r) {
+  Serial.print(label);
+  Serial.print(r.succeeded);
+  Serial.print('/');
+  Serial.print(r.requested);
+  Serial.print(F(" ok in "));
+  Serial.print(r.elapsedMs);
+  Serial.print(F(" ms, "));
+  Serial.print(r.requestsPerSecond, 2);
+  Serial.print(F(" req/s, latency min/avg/max "));
+  Serial.print(r.minLatencyMs);
+  Serial.print('/');
+  Serial.print(r.avgLatencyMs);
+  Serial.print('/');
+  Serial.print(r.maxLatencyMs);
+  Serial.print(F(" ms, "));
+  Serial.print(r.skipped);
+  Serial.print(F(" skipped, "));
+  Serial.print(r.readsSkipped);
+  Serial.println(F(" reads skipped"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U HTTP Batch Telemetry =="));
+  requireStep(modem.begin(), F("Modem ready"));
+  requireStep(modem.waitForNetwork(), F("Network registered"));
+
+  const char APN[] = "jionet";   // Replace with your APN
+  requireStep(modem.attachData(APN), F("Data attached"));
+  requireStep(modem.activatePDP(1), F("PDP context 1 active"));
+
+  // Baseline: one blocking httpsPost() per reading
+  HttpBatchResult serial = {};
+  serial.requested = BATCH;
+  uint32_t start = millis();
+  uint32_t latencySum = 0;
+  for (size_t i = 0; i < BATCH; i++) {
+    String body;
+    String response;
+    makeReading(i, body, nullptr);
+    uint32_t t0 = millis();
+    if (modem.httpsPost(ENDPOINT, body, response, headers, 1)) {
+      serial.succeeded++;
+    }
+    uint32_t latency = millis() - t0;
+    latencySum += latency;
+    serial.minLatencyMs = (i == 0 || latency < serial.minLatencyMs) ? latency : serial.minLatencyMs;
+    serial.maxLatencyMs = latency > serial.maxLatencyMs ? latency : serial.maxLatencyMs;
+  }
+  serial.elapsedMs = millis() - start;
+  serial.avgLatencyMs = latencySum / BATCH;
+  serial.requestsPerSecond = serial.succeeded * 1000.0f / serial.elapsedMs;
+  printResult(F("httpsPost() loop: "), serial);
+
+  // Batch through a session
+  session.setHeaders(headers, 1);
+  HttpBatchResult batch;
+  session.postBatch(ENDPOINT, BATCH, makeReading, nullptr, batch, entries);
+  printResult(F("postBatch():      "), batch);
+
+  for (size_t i = 0; i < BATCH; i++) {
+    Serial.print(F("  #"));
+    Serial.print(i);
+    Serial.print(F(" HTTP "));
+    Serial.print(entries[i].status);
+    Serial.print(F(", "));
+    Serial.print(entries[i].latencyMs);
+    Serial.println(F(" ms"));
+  }
+  Serial.print(F("AT round-trips saved by the session: "));
+  Serial.println(session.roundTripsSaved());
+}
+
+void loop() {}
@@ -0,0 +1,103 @@
+// Posts a reading every 10 seconds to the same endpoint through an HttpSession.
+// The first request configures the context, SSL context, headers and URL; every
+// later one only sends AT+QHTTPPOST and AT+QHTTPREAD because the modem knows the
+// module still holds the rest. The sketch prints how many round-trips that saved.
+#include <QuectelEC200U.h>
+#include <HttpSession.h>
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static void haltForever(const __FlashStringHelper *reason) {
+  Serial.println(reason);
+  while (true) {
+    delay(1000);
+  }
+}
+
+static void requireStep(bool ok, const __FlashStringHelper *label) {
+  if (ok) {
+    Serial.print(F("[ OK ] "));
+    Serial.println(label);
+  } else {
+    Serial.print(F("[FAIL] "));
+    Serial.println(label);
+    haltForever(F("Stopping demo"));
+  }
+}
+
+static const char ENDPOINT[] = "https://postman-echo.com/post";
+
+String headers[] = {
+  String("Content-Type: application/json"),
+  String("X-Device: ec200u-demo")
+};
+HttpSession session(modem);   // PDP context 1, SSL context 1
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U HTTP Session Demo =="));
+  requireStep(modem.begin(), F("Modem ready"));
+  requireStep(modem.waitForNetwork(), F("Network registered"));
+
+  const char APN[] = "jionet";   // Replace with your APN
+  requireStep(modem.attachData(APN), F("Data attached"));
+  requireStep(modem.activatePDP(1), F("PDP context 1 active"));
+
+  session.setHeaders(headers, sizeof(headers) / sizeof(headers[0]));
+}
+
+void loop() {
+  JsonDocument doc;
+  doc["uptime"] = millis() / 1000;
+  doc["rssi"] = modem.getSignalStrength();
+
+  String response;
+  uint32_t t0 = millis();
+  bool ok = session.post(ENDPOINT, doc, response);
+
+  Serial.print(F("POST #"));
+  Serial.print(session.requests());
+  Serial.print(ok ? F(" -> HTTP ") : F(" failed, HTTP "));
+  Serial.print(session.statusCode());
+  Serial.print(F(" in "));
+  Serial.print(millis() - t0);
+  Serial.print(F(" ms, round-trips saved so far: "));
+  Serial.println(session.roundTripsSaved());
+
+  delay(10000);
+}
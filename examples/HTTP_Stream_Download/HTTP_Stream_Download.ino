@@ -0,0 +1,126 @@
+// Downloads a large HTTPS response without holding it in RAM: the body is
+// passed to a callback in HTTP_STREAM_CHUNK_SIZE pieces as AT+QHTTPREAD runs.
+// The callback here only counts bytes and computes a checksum; replace it with a
+// file write, a parser or an OTA update.
+#include <QuectelEC200U.h>
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static void haltForever(const __FlashStringHelper *reason) {
+  Serial.println(reason);
+  while (true) {
+    delay(1000);
+  }
+}
+
+static void requireStep(bool ok, const __FlashStringHelper *label) {
+  if (ok) {
+    Serial.print(F("[ OK ] "));
+    Serial.println(label);
+  } else {
+    Serial.print(F("[FAIL] "));
+    Serial.println(label);
+    haltForever(F("Stopping demo"));
+  }
+}
+
+struct DownloadStats {
+  size_t bytes;
+  size_t chunks;
+  uint32_t checksum;
+};
+
+static bool onBody(const uint8_t *data, size_t len, void *ctx) {
+  DownloadStats *stats = (DownloadStats *)ctx;
+  for (size_t i = 0; i < len; i++) {
+    stats->checksum = stats->checksum * 31 + data[i];
+  }
+  stats->bytes += len;
+  stats->chunks++;
+  return true;  // false would stop delivery
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U HTTP Streaming Download =="));
+  requireStep(modem.begin(), F("Modem ready"));
+  requireStep(modem.waitForNetwork(), F("Network registered"));
+
+  const char APN[] = "jionet";   // Replace with your APN
+  requireStep(modem.attachData(APN), F("Data attached"));
+  requireStep(modem.activatePDP(1), F("PDP context 1 active"));
+
+  // 1. Body to a callback
+  DownloadStats stats = { 0, 0, 0 };
+#if defined(ARDUINO_ARCH_ESP32)
+  uint32_t heapBefore = ESP.getFreeHeap();
+#endif
+  uint32_t t0 = millis();
+  bool ok = modem.httpsGetStream("https://httpbin.org/bytes/102400", onBody, &stats);
+  uint32_t elapsed = millis() - t0;
+
+  Serial.print(F("\nHTTP status: "));
+  Serial.println(modem.httpStatusCode());
+  Serial.print(F("Content-Length: "));
+  Serial.println(modem.httpContentLength());
+  if (!ok) {
+    Serial.print(F("Download failed: "));
+    Serial.println(modem.getLastErrorString());
+  }
+  Serial.print(F("Received "));
+  Serial.print(stats.bytes);
+  Serial.print(F(" bytes in "));
+  Serial.print(stats.chunks);
+  Serial.print(F(" chunks, "));
+  Serial.print(elapsed);
+  Serial.print(F(" ms, checksum 0x"));
+  Serial.println(stats.checksum, HEX);
+#if defined(ARDUINO_ARCH_ESP32)
+  Serial.print(F("Free heap before/after: "));
+  Serial.print(heapBefore);
+  Serial.print(F(" / "));
+  Serial.println(ESP.getFreeHeap());
+#endif
+
+  // 2. Body straight to any Print (Serial, a File, a WiFiClient, ...)
+  Serial.println(F("\nStreaming a small response to Serial:"));
+  modem.httpGetStream("http://httpbin.org/get", Serial);
+  Serial.println();
+}
+
+void loop() {}
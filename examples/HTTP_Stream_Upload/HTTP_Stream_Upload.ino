@@ -0,0 +1,140 @@
+// Uploads a large request body without building it in RAM. The body is pulled
+// from a callback in HTTP_UPLOAD_CHUNK_SIZE pieces after the modem answers
+// CONNECT; here the callback generates CSV rows of (fake) buffered sensor
+// readings on the fly. A JsonDocument is posted the same way: its length comes
+// from measureJson() and it is serialized straight onto the UART.
+#include <QuectelEC200U.h>
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static void haltForever(const __FlashStringHelper *reason) {
+  Serial.println(reason);
+  while (true) {
+    delay(1000);
+  }
+}
+
+static void requireStep(bool ok, const __FlashStringHelper *label) {
+  if (ok) {
+    Serial.print(F("[ OK ] "));
+    Serial.println(label);
+  } else {
+    Serial.print(F("[FAIL] "));
+    Serial.println(label);
+    haltForever(F("Stopping demo"));
+  }
+}
+
+// Fixed-width rows make the total length known before anything is sent:
+// "SSSSS,TTTT,HHH\n" = 15 bytes per reading.
+static const size_t ROW_LEN = 15;
+static const size_t READINGS = 3400;   // ~50 KB
+
+struct CsvSource {
+  size_t row;
+  size_t offset;     // Position inside the current row
+  char line[ROW_LEN + 1];
+};
+
+static size_t pullCsv(uint8_t *buffer, size_t maxLen, void *ctx) {
+  CsvSource *src = (CsvSource *)ctx;
+  size_t n = 0;
+  while (n < maxLen && src->row < READINGS) {
+    if (src->offset == 0) {
+      int temp = 2000 + (int)(src->row % 500);       // 20.00 .. 24.99 C
+      int humidity = 400 + (int)(src->row % 200);    // 40.0 .. 59.9 %
+      snprintf(src->line, sizeof(src->line), "%05u,%04d,%03d\n", (unsigned)src->row, temp, humidity);
+    }
+    buffer[n++] = (uint8_t)src->line[src->offset++];
+    if (src->offset == ROW_LEN) {
+      src->offset = 0;
+      src->row++;
+    }
+  }
+  return n;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U HTTP Streaming Upload =="));
+  requireStep(modem.begin(), F("Modem ready"));
+  requireStep(modem.waitForNetwork(), F("Network registered"));
+
+  const char APN[] = "jionet";   // Replace with your APN
+  requireStep(modem.attachData(APN), F("Data attached"));
+  requireStep(modem.activatePDP(1), F("PDP context 1 active"));
+
+  String headers[] = {String("Content-Type: text/csv")};
+  String response;
+
+  // 1. 50 KB CSV batch from a pull callback
+  CsvSource src = { 0, 0, "" };
+  uint32_t t0 = millis();
+  bool ok = modem.httpsPostStream("https://httpbin.org/post", ROW_LEN * READINGS, pullCsv, &src, response, headers, 1);
+  Serial.print(F("CSV upload: "));
+  Serial.print(ok ? F("done") : F("failed"));
+  Serial.print(F(", HTTP "));
+  Serial.print(modem.httpStatusCode());
+  Serial.print(F(", "));
+  Serial.print(millis() - t0);
+  Serial.println(F(" ms"));
+  if (!ok) {
+    Serial.println(modem.getLastErrorString());
+  }
+
+  // 2. JsonDocument, serialized directly to the modem
+  JsonDocument doc;
+  doc["device"] = "ec200u-demo";
+  doc["uptime"] = millis();
+  JsonArray readings = doc["readings"].to<JsonArray>();
+  for (int i = 0; i < 20; i++) {
+    JsonObject r = readings.add<JsonObject>();
+    r["t"] = 21.5 + i * 0.1;
+    r["h"] = 48 + i;
+  }
+  String jsonHeaders[] = {String("Content-Type: application/json")};
+  if (modem.httpsPost("https://httpbin.org/post", doc, response, jsonHeaders, 1)) {
+    Serial.print(F("JSON upload: HTTP "));
+    Serial.println(modem.httpStatusCode());
+  } else {
+    Serial.print(F("JSON upload failed: "));
+    Serial.println(modem.getLastErrorString());
+  }
+}
+
+void loop() {}
@@ -0,0 +1,113 @@
+// Two MQTT clients on one modem: a telemetry client publishing with QoS 1 and
+// a retained status, and a command client whose subscriptions each get their
+// own handler. Inbound messages are delivered from poll(); the command client
+// uses buffered receive, so payloads may contain any byte.
+#include <QuectelEC200U.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const char MQTT_BROKER[] = "broker.hivemq.com";
+static const int TELEMETRY = 0;   // MQTT client indexes (0..5)
+static const int COMMANDS = 1;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static void onLedCommand(int client, const char *topic, const uint8_t *payload, size_t length, void *ctx) {
+  (void)client;
+  (void)topic;
+  (void)ctx;
+  bool on = length == 2 && payload[0] == 'o' && payload[1] == 'n';
+  Serial.print(F("LED "));
+  Serial.println(on ? F("on") : F("off"));
+}
+
+// Everything subscribed without a handler of its own
+static void onOtherMessage(int client, const char *topic, const uint8_t *payload, size_t length, void *ctx) {
+  (void)ctx;
+  Serial.print(F("Client "));
+  Serial.print(client);
+  Serial.print(F(" <- "));
+  Serial.print(topic);
+  Serial.print(F(": "));
+  Serial.write(payload, length);
+  Serial.println();
+}
+
+static bool connectClients() {
+  MqttOptions telemetry;
+  telemetry.clientId = "ec200u-telemetry";
+  telemetry.willTopic = "ec200u/status";
+  telemetry.willMessage = "offline";
+  telemetry.willQos = 1;
+  telemetry.willRetain = true;
+  if (!modem.mqttConnect(TELEMETRY, MQTT_BROKER, 1883, telemetry) ||
+      !modem.mqttPublish(TELEMETRY, "ec200u/status", "online", 1, true)) {
+    return false;
+  }
+
+  MqttOptions commands;
+  commands.clientId = "ec200u-commands";
+  commands.bufferedReceive = true;
+  return modem.mqttConnect(COMMANDS, MQTT_BROKER, 1883, commands) &&
+         modem.mqttSubscribe(COMMANDS, "ec200u/cmd/led", 1, onLedCommand) &&
+         modem.mqttSubscribe(COMMANDS, "ec200u/cmd/#", 1);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+#if defined(ARDUINO_ARCH_ESP32)
+  powerOnModem();
+#endif
+
+  modem.onMqttMessage(onOtherMessage);
+  if (!modem.begin() || !modem.attachData(APN) || !connectClients()) {
+    Serial.print(F("MQTT setup failed: "));
+    Serial.println(modem.getLastErrorString());
+  }
+}
+
+void loop() {
+  modem.poll();
+
+  static uint32_t lastPublish = 0;
+  if (millis() - lastPublish >= 10000) {
+    lastPublish = millis();
+    if (!modem.mqttConnected(TELEMETRY) || !modem.mqttConnected(COMMANDS)) {
+      Serial.print(F("Reconnecting (broker error "));
+      Serial.print(modem.mqttError(TELEMETRY));
+      Serial.println(F(")"));
+      connectClients();
+      return;
+    }
+    String uptime = String(millis() / 1000);
+    if (!modem.mqttPublish(TELEMETRY, "ec200u/uptime", uptime, 1)) {
+      Serial.println(F("Publish not acknowledged"));
+    }
+  }
+}
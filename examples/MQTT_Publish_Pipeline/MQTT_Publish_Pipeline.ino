@@ -0,0 +1,141 @@
+// Publishes QoS 1 messages with several of them in flight at once and reports
+// messages/s and the median broker acknowledgement latency, first with the
+// blocking mqttPublish() and then with mqttPublishAsync() at growing windows.
+//
+// The host build (extras/host) compiles it with USE_SIMULATOR=1 against
+// EC200USimulator, whose broker acknowledges 50 ms after the module's OK.
+#include <QuectelEC200U.h>
+
+#ifndef USE_SIMULATOR
+#define USE_SIMULATOR 0
+#endif
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+static const char APN[] = "internet";
+static const char MQTT_BROKER[] = "broker.hivemq.com";
+static const char TOPIC[] = "ec200u/pipeline";
+static const int MESSAGES = 100;
+
+#if USE_SIMULATOR
+#include <EC200USimulator.h>
+EC200USimulator sim(115200, 10);
+QuectelEC200U modem(sim);
+#elif defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && !USE_SIMULATOR
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static uint32_t latencies[MESSAGES];
+static int acked = 0;
+static int failed = 0;
+
+static void onPublished(int client, uint16_t msgId, bool ok, uint32_t latencyMs, void *ctx) {
+  (void)client;
+  (void)msgId;
+  (void)ctx;
+  if (ok && acked < MESSAGES) {
+    latencies[acked++] = latencyMs;
+  } else if (!ok) {
+    failed++;
+  }
+}
+
+static uint32_t medianLatency() {
+  for (int i = 1; i < acked; i++) {
+    uint32_t v = latencies[i];
+    int j = i;
+    while (j > 0 && latencies[j - 1] > v) {
+      latencies[j] = latencies[j - 1];
+      j--;
+    }
+    latencies[j] = v;
+  }
+  return acked > 0 ? latencies[acked / 2] : 0;
+}
+
+static void report(const char *label, uint32_t elapsedMs) {
+  char line[96];
+  snprintf(line, sizeof(line), "%-12s %3d acked %2d failed  %6.1f msg/s  median ack %4lu ms",
+           label, acked, failed, elapsedMs ? MESSAGES * 1000.0f / elapsedMs : 0.0f,
+           (unsigned long)medianLatency());
+  Serial.println(line);
+}
+
+static void runWindow(uint8_t window) {
+  modem.setMqttWindow(window);
+  acked = 0;
+  failed = 0;
+  int sent = 0;
+  uint32_t start = millis();
+  while (acked + failed < MESSAGES && millis() - start < 60000) {
+    if (sent < MESSAGES && modem.mqttCanPublish(0)) {
+      String message = "{\"seq\":" + String(sent) + "}";
+      if (modem.mqttPublishAsync(0, TOPIC, message, 1) > 0) {
+        sent++;
+      }
+    } else {
+      modem.poll();   // Back-pressure: the window is full, collect acks
+    }
+  }
+  char label[16];
+  snprintf(label, sizeof(label), "window %u", window);
+  report(label, millis() - start);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== MQTT QoS 1 publish pipeline =="));
+  powerOnModem();
+
+  MqttOptions options;
+  options.clientId = "ec200u-pipeline";
+  if (!modem.begin() || !modem.attachData(APN) || !modem.mqttConnect(0, MQTT_BROKER, 1883, options)) {
+    Serial.print(F("Setup failed: "));
+    Serial.println(modem.getLastErrorString());
+    return;
+  }
+  modem.onMqttPublished(onPublished);
+
+  // Blocking: one message at a time, each waits for its +QMTPUB
+  acked = 0;
+  failed = 0;
+  uint32_t start = millis();
+  for (int i = 0; i < MESSAGES; i++) {
+    uint32_t t0 = millis();
+    if (modem.mqttPublish(0, TOPIC, "{\"seq\":" + String(i) + "}", 1)) {
+      latencies[acked++] = millis() - t0;
+    } else {
+      failed++;
+    }
+  }
+  report("blocking", millis() - start);
+
+  runWindow(1);
+  runWindow(4);
+  runWindow(8);
+}
+
+void loop() {}
@@ -0,0 +1,84 @@
+// Reports per-command modem health (calls, failures, timeouts, bytes, latency)
+// as JSON once a minute, without any debug output.
+//
+// Metrics must be enabled for the whole build, library included, e.g. in
+// platformio.ini:   build_flags = -DEC200U_ENABLE_METRICS
+// A #define in the sketch is not enough: the library would be compiled without it.
+#include <QuectelEC200U.h>
+
+#ifndef EC200U_ENABLE_METRICS
+#error "Build with -DEC200U_ENABLE_METRICS (see the comment at the top)"
+#endif
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const uint32_t REPORT_INTERVAL_MS = 60000;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static uint32_t lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+#if defined(ARDUINO_ARCH_ESP32)
+  powerOnModem();
+#endif
+
+  if (!modem.begin() || !modem.attachData(APN)) {
+    Serial.print(F("Modem setup failed: "));
+    Serial.println(modem.getLastErrorString());
+  }
+}
+
+void loop() {
+  modem.poll();
+
+  // Some ordinary traffic to measure
+  static uint32_t lastCheck = 0;
+  if (millis() - lastCheck >= 5000) {
+    lastCheck = millis();
+    modem.getSignalStrength();
+    modem.getRegistrationStatus();
+  }
+
+  if (millis() - lastReport >= REPORT_INTERVAL_MS) {
+    lastReport = millis();
+    modem.printMetricsJson(Serial);
+    Serial.println();
+
+    const ATMetrics *csq = modem.findMetrics("AT+CSQ");
+    if (csq && csq->calls > 0) {
+      Serial.print(F("AT+CSQ average latency: "));
+      Serial.print(csq->totalLatencyMs / csq->calls);
+      Serial.print(F(" ms, worst: "));
+      Serial.print(csq->maxLatencyMs);
+      Serial.println(F(" ms"));
+    }
+  }
+}
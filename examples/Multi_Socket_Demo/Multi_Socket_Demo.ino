@@ -0,0 +1,95 @@
+#include <QuectelEC200U.h>
+#include <QuectelClient.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const int PDP_CONTEXT_ID = 1;
+
+// Two upstream connections held open at the same time
+QuectelClient echoClient(modem);
+QuectelClient httpClient(modem);
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static void drain(QuectelClient &client, const __FlashStringHelper *label) {
+  uint8_t buf[64];
+  while (client.available() > 0) {
+    int n = client.read(buf, sizeof(buf));
+    if (n <= 0) {
+      break;
+    }
+    Serial.print(label);
+    Serial.write(buf, n);
+    Serial.println();
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U Multi-Socket Demo =="));
+  if (!modem.begin() || !modem.waitForNetwork() || !modem.attachData(APN) || !modem.activatePDP(PDP_CONTEXT_ID)) {
+    Serial.println(F("Network bring-up failed"));
+    while (true) {
+      delay(1000);
+    }
+  }
+
+  if (echoClient.connect("tcpbin.com", 4242)) {
+    Serial.print(F("Echo socket on connectID "));
+    Serial.println(echoClient.socketId());
+    echoClient.print(F("hello from EC200U\n"));
+  }
+
+  if (httpClient.connect("postman-echo.com", 80)) {
+    Serial.print(F("HTTP socket on connectID "));
+    Serial.println(httpClient.socketId());
+    httpClient.print(F("GET /get HTTP/1.1\r\nHost: postman-echo.com\r\nConnection: close\r\n\r\n"));
+  }
+}
+
+void loop() {
+  // Receives +QIURC: "recv" for every socket and fills their rings.
+  modem.poll();
+
+  drain(echoClient, F("[echo] "));
+  drain(httpClient, F("[http] "));
+
+  if (httpClient && !httpClient.connected()) {
+    Serial.println(F("HTTP socket closed by server"));
+    httpClient.stop();
+  }
+}
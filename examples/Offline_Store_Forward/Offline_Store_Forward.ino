@@ -0,0 +1,129 @@
+// Never loses a reading to a coverage gap: each sample goes out as an MQTT
+// message and an HTTPS POST. Whatever cannot be sent is appended to an
+// OfflineQueue on the module's UFS (not the MCU heap) and sent in order, a
+// batch per loop(), once ConnectionSupervisor reports the link up again.
+#include <QuectelEC200U.h>
+#include <ConnectionSupervisor.h>
+#include <OfflineQueue.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const char MQTT_BROKER[] = "broker.hivemq.com";
+static const char MQTT_TOPIC[] = "ec200u/readings";
+static const char POST_URL[] = "https://postman-echo.com/post";
+static const uint32_t SAMPLE_INTERVAL_MS = 10000;
+
+// Record tags
+static const uint8_t TAG_MQTT = 1;
+static const uint8_t TAG_HTTP = 2;
+
+ConnectionSupervisor supervisor(modem);
+UfsQueueStore store(modem);
+OfflineQueue backlog(store, "readings");
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static bool restoreMqtt(QuectelEC200U &m, void *ctx) {
+  (void)ctx;
+  return m.mqttConnect(MQTT_BROKER, 1883);
+}
+
+static bool sendMqtt(const uint8_t *data, size_t length) {
+  return supervisor.isUp() && modem.mqttPublish(0, MQTT_TOPIC, data, length, 1);
+}
+
+static bool sendHttp(const uint8_t *data, size_t length) {
+  if (!supervisor.isUp()) {
+    return false;
+  }
+  String body;
+  body.concat((const char *)data, length);
+  String response;
+  return modem.httpsPost(POST_URL, body, response);
+}
+
+// Called by flush() for each queued record, oldest first
+static bool sendQueued(uint8_t tag, const uint8_t *data, size_t length, void *ctx) {
+  (void)ctx;
+  return tag == TAG_MQTT ? sendMqtt(data, length) : sendHttp(data, length);
+}
+
+static void sample() {
+  String reading = "{\"uptime\":" + String(millis() / 1000) + "}";
+  const uint8_t *data = (const uint8_t *)reading.c_str();
+
+  // Older readings go first: while a backlog exists, new ones join it
+  bool queued = !backlog.empty();
+  if (queued || !sendMqtt(data, reading.length())) {
+    backlog.push(data, reading.length(), TAG_MQTT);
+  }
+  if (queued || !sendHttp(data, reading.length())) {
+    backlog.push(data, reading.length(), TAG_HTTP);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+#if defined(ARDUINO_ARCH_ESP32)
+  powerOnModem();
+#endif
+
+  if (!modem.begin()) {
+    Serial.print(F("Modem not ready: "));
+    Serial.println(modem.getLastErrorString());
+  }
+  if (!backlog.begin()) {
+    Serial.println(F("Queue storage not available"));
+  }
+
+  supervisor.setAPN(APN);
+  supervisor.addSession(restoreMqtt);
+  supervisor.begin();
+}
+
+void loop() {
+  supervisor.loop();
+
+  static uint32_t lastSample = 0;
+  if (millis() - lastSample >= SAMPLE_INTERVAL_MS) {
+    lastSample = millis();
+    sample();
+  }
+
+  if (supervisor.isUp() && !backlog.empty()) {
+    int sent = backlog.flush(sendQueued);
+    if (sent > 0) {
+      Serial.print(F("Sent "));
+      Serial.print(sent);
+      Serial.print(F(" queued readings, "));
+      Serial.print(backlog.segments());
+      Serial.println(F(" segment(s) left"));
+    }
+  }
+}
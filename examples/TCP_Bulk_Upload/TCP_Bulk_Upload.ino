@@ -0,0 +1,108 @@
+// Uploads a large buffer over a raw TCP socket with tcpWrite(), which splits
+// it into AT+QISEND frames of SOCKET_SEND_MAX (1460) bytes, and prints the
+// effective upstream throughput from sendStats(): first waiting for each
+// SEND OK before requesting the next "> " prompt, then with pipelining.
+//
+// On a board, point UPLOAD_HOST at a TCP sink (e.g. "nc -l 9000 > /dev/null").
+// The host build (extras/host) compiles it with USE_SIMULATOR=1 against
+// EC200USimulator (115200 baud, 20 ms modem latency).
+#include <QuectelEC200U.h>
+
+#ifndef USE_SIMULATOR
+#define USE_SIMULATOR 0
+#endif
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+static const char APN[] = "internet";
+static const char UPLOAD_HOST[] = "example.com";
+static const int UPLOAD_PORT = 9000;
+static const size_t BLOCK_SIZE = 8192;
+static const int BLOCKS = 4;
+
+#if USE_SIMULATOR
+#include <EC200USimulator.h>
+EC200USimulator sim(115200, 20);
+QuectelEC200U modem(sim);
+#elif defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && !USE_SIMULATOR
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+// Stands in for a firmware image or a log file read block by block
+static uint8_t block[BLOCK_SIZE];
+
+static void upload(int socketId, bool pipelined) {
+  modem.setSendPipelining(pipelined);
+  size_t total = 0;
+  uint32_t frames = 0;
+  uint32_t failed = 0;
+  uint32_t start = millis();
+  for (int i = 0; i < BLOCKS; i++) {
+    size_t n = modem.tcpWrite(socketId, block, sizeof(block), 10000);
+    const SocketSendStats &stats = modem.sendStats();
+    total += n;
+    frames += stats.frames;
+    failed += stats.failed;
+    if (n < sizeof(block)) {
+      break;   // Stopped at a SEND FAIL or an error; n bytes went out in order
+    }
+  }
+  uint32_t elapsed = millis() - start;
+
+  char line[96];
+  snprintf(line, sizeof(line), "%-10s %6lu bytes  %3lu frames  %lu failed  %5lu ms  %6.2f KB/s",
+           pipelined ? "pipelined" : "stop-wait", (unsigned long)total, (unsigned long)frames,
+           (unsigned long)failed, (unsigned long)elapsed,
+           elapsed ? (total / 1024.0f) / (elapsed / 1000.0f) : 0.0f);
+  Serial.println(line);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== TCP bulk upload =="));
+  powerOnModem();
+
+  for (size_t i = 0; i < sizeof(block); i++) {
+    block[i] = (uint8_t)(i * 31 + (i >> 8));
+  }
+
+  if (!modem.begin() || !modem.attachData(APN)) {
+    Serial.print(F("Setup failed: "));
+    Serial.println(modem.getLastErrorString());
+    return;
+  }
+  int id = modem.socketOpen(UPLOAD_HOST, UPLOAD_PORT);
+  if (id < 0 || !modem.socketWaitConnected(id)) {
+    Serial.println(F("Socket open failed"));
+    return;
+  }
+
+  upload(id, false);
+  upload(id, true);
+  modem.socketClose(id);
+}
+
+void loop() {}
@@ -0,0 +1,159 @@
+#include <QuectelEC200U.h>
+#include <QuectelClient.h>
+
+// Remote diagnostics console: listens on a TCP port and serves several
+// sessions at once ("telnet <device-ip> 2323"). Each line is a command:
+//   csq      signal quality
+//   imei     module IMEI
+//   uptime   milliseconds since boot
+//   quit     close the session
+// The listener needs a public or VPN-reachable address on the PDP context;
+// most consumer APNs sit behind carrier NAT.
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const int PDP_CONTEXT_ID = 1;
+static const uint16_t LISTEN_PORT = 2323;
+static const int MAX_SESSIONS = 3;
+
+struct Session {
+  QuectelClient client;
+  char line[32];
+  size_t length;
+  Session() : client(modem), length(0) {}
+};
+
+static Session sessions[MAX_SESSIONS];
+static int listener = -1;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static void runCommand(Session &s) {
+  String cmd = String(s.line);
+  cmd.trim();
+  if (cmd == "csq") {
+    s.client.println("csq " + String(modem.getSignalStrength()));
+  } else if (cmd == "imei") {
+    s.client.println("imei " + modem.getIMEI());
+  } else if (cmd == "uptime") {
+    s.client.println("uptime " + String(millis()));
+  } else if (cmd == "quit") {
+    s.client.println(F("bye"));
+    s.client.stop();
+  } else if (cmd.length() > 0) {
+    s.client.println(F("commands: csq imei uptime quit"));
+  }
+}
+
+static void serve(Session &s) {
+  if (!s.client) {
+    return;
+  }
+  uint8_t buf[32];
+  int n;
+  while ((n = s.client.read(buf, sizeof(buf))) > 0) {
+    for (int i = 0; i < n && s.client; i++) {
+      if (buf[i] == '\n') {
+        s.line[s.length] = '\0';
+        runCommand(s);
+        s.length = 0;
+      } else if (s.length < sizeof(s.line) - 1) {
+        s.line[s.length++] = (char)buf[i];
+      }
+    }
+  }
+  if (s.client && !s.client.connected()) {
+    Serial.print(F("Session closed by peer on connectID "));
+    Serial.println(s.client.socketId());
+    s.client.stop();
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U TCP Diagnostics Server =="));
+  if (!modem.begin() || !modem.waitForNetwork() || !modem.attachData(APN) || !modem.activatePDP(PDP_CONTEXT_ID)) {
+    Serial.println(F("Network bring-up failed"));
+    while (true) {
+      delay(1000);
+    }
+  }
+
+  listener = modem.tcpListen(LISTEN_PORT, -1, PDP_CONTEXT_ID);
+  if (listener < 0) {
+    Serial.println(F("Could not open the listener"));
+    while (true) {
+      delay(1000);
+    }
+  }
+  Serial.print(F("Listening on port "));
+  Serial.println(LISTEN_PORT);
+}
+
+void loop() {
+  // Receives +QIURC: "incoming" and "recv" and fills each session's ring
+  modem.poll();
+
+  char ip[16];
+  uint16_t port;
+  int id;
+  while ((id = modem.socketAccept(listener, ip, sizeof(ip), &port)) >= 0) {
+    Session *slot = nullptr;
+    for (int i = 0; i < MAX_SESSIONS && slot == nullptr; i++) {
+      if (!sessions[i].client) {
+        slot = &sessions[i];
+      }
+    }
+    if (slot == nullptr) {
+      modem.socketClose(id);   // Busy
+      continue;
+    }
+    slot->client.attach(id);
+    slot->length = 0;
+    slot->client.println(F("EC200U diagnostics. commands: csq imei uptime quit"));
+    Serial.print(F("Session from "));
+    Serial.print(ip);
+    Serial.print(':');
+    Serial.print(port);
+    Serial.print(F(" on connectID "));
+    Serial.println(id);
+  }
+
+  for (int i = 0; i < MAX_SESSIONS; i++) {
+    serve(sessions[i]);
+  }
+}
@@ -0,0 +1,122 @@
+#include <QuectelEC200U.h>
+#include <QuectelClient.h>
+
+// Raw TLS socket (AT+QSSLOPEN) with TLS session resumption. The sketch
+// connects to the same server a few times. The first handshake is a full
+// one; with the session cache on, the later ones resume the cached session
+// and skip the certificate exchange, which is visible in the handshake time.
+// Each connection sends one request and prints the first response line.
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static const char APN[] = "your.apn.here";
+static const int PDP_CONTEXT_ID = 1;
+static const int SSL_CONTEXT_ID = 1;
+static const char HOST[] = "postman-echo.com";
+static const int PORT = 443;
+static const int CONNECTIONS = 3;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+static void request(int attempt) {
+  QuectelClient client(modem);
+  client.setSSLContext(SSL_CONTEXT_ID);
+  client.setConnectTimeout(30000);
+
+  uint32_t start = millis();
+  if (!client.connect(HOST, PORT)) {
+    Serial.print(F("TLS connect failed: "));
+    Serial.println(modem.getLastErrorString());
+    return;
+  }
+  uint32_t handshake = millis() - start;
+
+  client.print(F("HEAD /get HTTP/1.1\r\nHost: "));
+  client.print(HOST);
+  client.print(F("\r\nConnection: close\r\n\r\n"));
+
+  char line[64];
+  size_t length = 0;
+  start = millis();
+  while (millis() - start < 10000 && length < sizeof(line) - 1) {
+    modem.poll();
+    int c = client.read();
+    if (c < 0) {
+      if (!client.connected()) {
+        break;
+      }
+      continue;
+    }
+    if (c == '\r' || c == '\n') {
+      break;
+    }
+    line[length++] = (char)c;
+  }
+  line[length] = '\0';
+
+  Serial.print(F("Connection "));
+  Serial.print(attempt);
+  Serial.print(F(": handshake "));
+  Serial.print(handshake);
+  Serial.print(F(" ms, "));
+  Serial.println(length > 0 ? line : "no response");
+  client.stop();
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U TLS Socket with Session Resumption =="));
+  if (!modem.begin() || !modem.waitForNetwork() || !modem.attachData(APN) || !modem.activatePDP(PDP_CONTEXT_ID)) {
+    Serial.println(F("Network bring-up failed"));
+    while (true) {
+      delay(1000);
+    }
+  }
+
+  // No certificate check here; see sslConfigure() to verify the server
+  modem.sendAT("AT+QSSLCFG=\"seclevel\"," + String(SSL_CONTEXT_ID) + ",0");
+  modem.sslSetSNI(SSL_CONTEXT_ID, true);
+  modem.sslSetNegotiateTimeout(SSL_CONTEXT_ID, 30);
+  if (!modem.sslSetSessionResumption(SSL_CONTEXT_ID, true)) {
+    Serial.println(F("Session cache not supported by this firmware"));
+  }
+
+  for (int i = 1; i <= CONNECTIONS; i++) {
+    request(i);
+  }
+}
+
+void loop() {}
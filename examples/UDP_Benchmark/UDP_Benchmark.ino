@@ -0,0 +1,126 @@
+// Sends and receives small UDP datagrams on a "UDP SERVICE" socket and
+// reports packets/s for each direction. Every datagram is one AT+QISEND or one
+// AT+QIRD, written from and read into the same static buffer.
+//
+// On a board, point ECHO_IP at a UDP echo server (e.g. "socat
+// UDP-RECVFROM:7000,fork EXEC:cat"). The host build (extras/host) compiles it
+// with USE_SIMULATOR=1 against EC200USimulator (115200 baud, 10 ms modem
+// latency; the simulated module always has another datagram queued).
+#include <QuectelEC200U.h>
+
+#ifndef USE_SIMULATOR
+#define USE_SIMULATOR 0
+#endif
+
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PW_KEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+static const char APN[] = "internet";
+static const char ECHO_IP[] = "203.0.113.10";
+static const uint16_t ECHO_PORT = 7000;
+static const uint16_t LOCAL_PORT = 5000;
+static const size_t PACKET_SIZE = 64;
+static const int PACKETS = 200;
+
+#if USE_SIMULATOR
+#include <EC200USimulator.h>
+EC200USimulator sim(115200, 10);
+QuectelEC200U modem(sim);
+#elif defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && !USE_SIMULATOR
+static void powerOnModem() {
+  pinMode(EC200U_PW_KEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PW_KEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PW_KEY_PIN, HIGH);
+  }
+}
+#else
+static void powerOnModem() {}
+#endif
+
+static uint8_t packet[SOCKET_READ_MAX];
+
+static void report(const char *label, int packets, uint32_t elapsedMs) {
+  char line[80];
+  snprintf(line, sizeof(line), "%-8s %4d packets  %5lu ms  %7.1f packets/s  %6.2f KB/s",
+           label, packets, (unsigned long)elapsedMs,
+           elapsedMs ? packets * 1000.0f / elapsedMs : 0.0f,
+           elapsedMs ? (packets * PACKET_SIZE / 1024.0f) / (elapsedMs / 1000.0f) : 0.0f);
+  Serial.println(line);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== UDP packets/s benchmark =="));
+  powerOnModem();
+
+#if USE_SIMULATOR
+  // One queued datagram of PACKET_SIZE bytes from the echo server per AT+QIRD
+  sim.addRule("AT+QIRD=", "\r\n+QIRD: 64,\"203.0.113.10\",7000\r\n"
+                          "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+                          "\r\n\r\nOK\r\n");
+#endif
+
+  if (!modem.begin() || !modem.attachData(APN)) {
+    Serial.print(F("Setup failed: "));
+    Serial.println(modem.getLastErrorString());
+    return;
+  }
+  int id = modem.udpOpen(LOCAL_PORT);
+  if (id < 0) {
+    Serial.println(F("UDP open failed"));
+    return;
+  }
+
+  for (size_t i = 0; i < PACKET_SIZE; i++) {
+    packet[i] = (uint8_t)i;
+  }
+  int sent = 0;
+  uint32_t start = millis();
+  for (int i = 0; i < PACKETS; i++) {
+    packet[0] = (uint8_t)i;
+    if (modem.udpSendTo(id, ECHO_IP, ECHO_PORT, packet, PACKET_SIZE)) {
+      sent++;
+    }
+  }
+  report("send", sent, millis() - start);
+
+#if USE_SIMULATOR
+  sim.emit("\r\n+QIURC: \"recv\",0\r\n");
+#endif
+  int received = 0;
+  char ip[16];
+  uint16_t port = 0;
+  start = millis();
+  while (received < sent) {
+    int n = modem.udpReceive(id, packet, sizeof(packet), ip, sizeof(ip), &port, 2000);
+    if (n <= 0) {
+      break;   // Echoes lost on the way, or none left
+    }
+    received++;
+  }
+  report("receive", received, millis() - start);
+  if (received > 0) {
+    Serial.print(F("Last datagram from "));
+    Serial.print(ip);
+    Serial.print(':');
+    Serial.println(port);
+  }
+  modem.socketClose(id);
+}
+
+void loop() {}
@@ -0,0 +1,89 @@
+#include <QuectelEC200U.h>
+
+// Adjust these pins for your board
+#define EC200U_RX_PIN 16
+#define EC200U_TX_PIN 17
+#define EC200U_PWRKEY_PIN 10
+#define EC200U_STATUS_PIN 2
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial SerialAT(1);
+QuectelEC200U modem(SerialAT, 115200, EC200U_RX_PIN, EC200U_TX_PIN);
+#else
+#include <SoftwareSerial.h>
+SoftwareSerial SerialAT(EC200U_RX_PIN, EC200U_TX_PIN);
+QuectelEC200U modem(SerialAT);
+#endif
+
+static volatile int pendingSmsIndex = -1;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void powerOnModem() {
+  pinMode(EC200U_PWRKEY_PIN, OUTPUT);
+  pinMode(EC200U_STATUS_PIN, INPUT);
+  if (digitalRead(EC200U_STATUS_PIN) == LOW) {
+    digitalWrite(EC200U_PWRKEY_PIN, LOW);
+    delay(2000);
+    digitalWrite(EC200U_PWRKEY_PIN, HIGH);
+    delay(200);
+  }
+}
+#endif
+
+// Handlers run inside the receive path: keep them short and defer AT work.
+static void onRing(const char *urc, void *ctx) {
+  (void)urc;
+  (void)ctx;
+  Serial.println(F("[URC] Incoming call"));
+}
+
+static void onNewSms(const char *urc, void *ctx) {
+  (void)ctx;
+  // +CMTI: "SM",<index>
+  pendingSmsIndex = modem.extractInteger(urc, F(","));
+  Serial.print(F("[URC] New SMS at index "));
+  Serial.println(pendingSmsIndex);
+}
+
+static void onPdpDeact(const char *urc, void *ctx) {
+  (void)ctx;
+  Serial.print(F("[URC] PDP context lost: "));
+  Serial.println(urc);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+
+#if defined(ARDUINO_ARCH_ESP32)
+  SerialAT.begin(115200, SERIAL_8N1, EC200U_RX_PIN, EC200U_TX_PIN);
+  powerOnModem();
+#else
+  SerialAT.begin(9600);
+#endif
+
+  Serial.println(F("\n== EC200U URC Events Demo =="));
+  modem.onURC("RING", onRing);
+  modem.onURC("+CMTI:", onNewSms);
+  modem.onURC("+QIURC: \"pdpdeact\"", onPdpDeact);
+
+  if (!modem.begin()) {
+    Serial.println(F("Modem init failed"));
+    while (true) {
+      delay(1000);
+    }
+  }
+  modem.setMessageFormat(1);
+  modem.setNewMessageIndication(2, 1, 0, 0, 0);
+}
+
+void loop() {
+  // Dispatches URCs that arrive while no command is running.
+  modem.poll();
+
+  if (pendingSmsIndex >= 0) {
+    int index = pendingSmsIndex;
+    pendingSmsIndex = -1;
+    Serial.println(modem.readSMS(index));
+  }
+}
@@ -548,8 +548,8 @@ void handleStatus() {
   doc["net_type"] = ratLabel.length() ? ratLabel : registration;
   doc["registration"] = registration;
   doc["sim_status"] = modem.getSIMStatus();
-  doc["imei"] = modem.getIMEI();
-  doc["model"] = modem.getModelIdentification();
+  doc["imei"] = modem.getDeviceInfo(DeviceInfoField::IMEI);
+  doc["model"] = modem.getDeviceInfo(DeviceInfoField::MODEL);
   doc["network_info"] = networkInfo;
   doc["rat_detail"] = ratDetail;
 
@@ -577,11 +577,12 @@ void handleStatus() {
 void handleModemInfo() {
   sendCorsHeaders();
   JsonDocument doc;
-  doc["imei"] = modem.getIMEI();
-  doc["manufacturer"] = modem.getManufacturerIdentification();
-  doc["model"] = modem.getModelIdentification();
-  doc["firmware"] = modem.getFirmwareRevision();
-  doc["version"] = modem.getModuleVersion();
+  // Served from the library's device-info cache: no AT traffic after the first page
+  doc["imei"] = modem.getDeviceInfo(DeviceInfoField::IMEI);
+  doc["manufacturer"] = modem.getDeviceInfo(DeviceInfoField::MANUFACTURER);
+  doc["model"] = modem.getDeviceInfo(DeviceInfoField::MODEL);
+  doc["firmware"] = modem.getDeviceInfo(DeviceInfoField::FIRMWARE);
+  doc["version"] = modem.getDeviceInfo(DeviceInfoField::VERSION);
 
   String response;
   serializeJson(doc, response);
@@ -0,0 +1,70 @@
+/*
+  Minimal Arduino core for building QuectelEC200U on a desktop host
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "Arduino.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::chrono::steady_clock::time_point startTime() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return start;
+}
+
+}  // namespace
+
+uint32_t millis() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime()).count();
+}
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime()).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+  size_t n = 0;
+  uint32_t start = millis();
+  while (n < length && millis() - start < _timeout) {
+    int c = read();
+    if (c < 0) {
+      yield();
+      continue;
+    }
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+void HardwareSerial::begin(unsigned long, uint32_t, int8_t, int8_t) {}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t size) {
+  if (_port == 0) {
+    fwrite(buf, 1, size, stdout);
+  }
+  return size;
+}
+
+HardwareSerial Serial(0);
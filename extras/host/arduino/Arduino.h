@@ -0,0 +1,200 @@
+/*
+  Minimal Arduino core for building QuectelEC200U on a desktop host
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Just enough of String, Print, Stream, HardwareSerial and the timing calls
+  for the library, EC200USimulator, the host sketches and the tests to build
+  with a plain C++ compiler. Serial writes to stdout and never receives.
+*/
+
+#ifndef EC200U_HOST_ARDUINO_H
+#define EC200U_HOST_ARDUINO_H
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PROGMEM
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+#define SERIAL_8N1 0x800001c
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+class String {
+  public:
+    String() {}
+    String(const char *s) : _s(s ? s : "") {}
+    String(const __FlashStringHelper *s) : _s(reinterpret_cast<const char *>(s)) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v, unsigned char base = DEC) : String((long)v, base) {}
+    explicit String(unsigned int v, unsigned char base = DEC) : String((unsigned long)v, base) {}
+    explicit String(long v, unsigned char base = DEC) { _format(base == HEX ? "%lx" : "%ld", v); }
+    explicit String(unsigned long v, unsigned char base = DEC) { _format(base == HEX ? "%lx" : "%lu", v); }
+    explicit String(double v, unsigned char digits = 2) { _format("%.*f", (int)digits, v); }
+
+    unsigned int length() const { return _s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char *c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char &operator[](unsigned int i) { return _s[i]; }
+
+    int indexOf(char c, unsigned int from = 0) const { return _pos(_s.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const { return _pos(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return _pos(_s.rfind(c)); }
+    bool startsWith(const String &s) const { return _s.compare(0, s._s.size(), s._s) == 0; }
+    bool endsWith(const String &s) const {
+      return _s.size() >= s._s.size() && _s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0;
+    }
+    bool equals(const String &s) const { return _s == s._s; }
+    bool equalsIgnoreCase(const String &s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+
+    String substring(unsigned int from) const { return substring(from, _s.size()); }
+    String substring(unsigned int from, unsigned int to) const {
+      if (from > to) std::swap(from, to);
+      if (from >= _s.size()) return String();
+      return String(_s.substr(from, to - from).c_str());
+    }
+    long toInt() const { return atol(c_str()); }
+    void trim() {
+      size_t a = _s.find_first_not_of(" \t\r\n");
+      size_t b = _s.find_last_not_of(" \t\r\n");
+      _s = a == std::string::npos ? std::string() : _s.substr(a, b - a + 1);
+    }
+    void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+
+    bool concat(const String &s) { _s += s._s; return true; }
+    bool concat(const char *s) { if (s) _s += s; return s != nullptr; }
+    bool concat(const char *s, unsigned int n) { _s.append(s, n); return true; }
+    bool concat(const __FlashStringHelper *s) { return concat(reinterpret_cast<const char *>(s)); }
+    bool concat(char c) { _s += c; return true; }
+    bool concat(unsigned char v) { return concat(String((unsigned int)v)); }
+    bool concat(int v) { return concat(String(v)); }
+    bool concat(unsigned int v) { return concat(String(v)); }
+    bool concat(long v) { return concat(String(v)); }
+    bool concat(unsigned long v) { return concat(String(v)); }
+    bool concat(double v) { return concat(String(v)); }
+    template <typename T> String &operator+=(const T &v) { concat(v); return *this; }
+
+    bool operator==(const String &s) const { return _s == s._s; }
+    bool operator==(const char *s) const { return _s == (s ? s : ""); }
+    bool operator!=(const String &s) const { return !(*this == s); }
+    bool operator!=(const char *s) const { return !(*this == s); }
+
+  private:
+    std::string _s;
+
+    static int _pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    template <typename T> void _format(const char *fmt, T v) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), fmt, v);
+      _s = buf;
+    }
+    void _format(const char *fmt, int digits, double v) {
+      char buf[64];
+      snprintf(buf, sizeof(buf), fmt, digits, v);
+      _s = buf;
+    }
+};
+
+template <typename T> String operator+(const String &a, const T &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+inline String operator+(const __FlashStringHelper *a, const String &b) { String r(a); r.concat(b); return r; }
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) {
+      size_t n = 0;
+      while (size-- && write(*buf++)) n++;
+      return n;
+    }
+    size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+    size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print(String((unsigned long)v, base)); }
+    size_t print(int v, int base = DEC) { return print(String((long)v, base)); }
+    size_t print(unsigned int v, int base = DEC) { return print(String((unsigned long)v, base)); }
+    size_t print(long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T &v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+
+  protected:
+    unsigned long _timeout = 1000;
+};
+
+// Serial: stdout. Other ports accept and drop writes and never receive.
+class HardwareSerial : public Stream {
+  public:
+    explicit HardwareSerial(int port = 0) : _port(port) {}
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+
+  private:
+    int _port;
+};
+
+extern HardwareSerial Serial;
+
+#endif
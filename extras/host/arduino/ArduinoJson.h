@@ -0,0 +1,28 @@
+/*
+  ArduinoJson stand-in for the host build of QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Declares only what the library's signatures mention. A JsonDocument here
+  is always empty, so the JSON overloads build but carry no data; host code
+  writes JSON by hand.
+*/
+
+#ifndef EC200U_HOST_ARDUINOJSON_H
+#define EC200U_HOST_ARDUINOJSON_H
+
+#include "Arduino.h"
+
+class JsonDocument {};
+
+class DeserializationError {
+  public:
+    explicit operator bool() const { return false; }
+    const char *c_str() const { return "Ok"; }
+};
+
+inline DeserializationError deserializeJson(JsonDocument &, const String &) { return DeserializationError(); }
+inline size_t measureJson(const JsonDocument &) { return 4; }
+inline size_t serializeJson(const JsonDocument &, Print &out) { return out.print("null"); }
+
+#endif
@@ -0,0 +1,38 @@
+/*
+  Arduino Client interface for the host build of QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#ifndef EC200U_HOST_CLIENT_H
+#define EC200U_HOST_CLIENT_H
+
+#include "Arduino.h"
+
+class IPAddress {
+  public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _octets{a, b, c, d} {}
+    uint8_t operator[](int index) const { return _octets[index]; }
+
+  private:
+    uint8_t _octets[4];
+};
+
+class Client : public Stream {
+  public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char *host, uint16_t port) = 0;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t *buf, size_t size) = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() = 0;
+    using Print::write;
+};
+
+#endif
@@ -0,0 +1,24 @@
+/*
+  Entry point for Arduino sketches built on the host
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Runs setup() once, then loop() for the number of milliseconds given as the
+  first argument (default: one pass).
+*/
+
+#include "Arduino.h"
+
+void setup();
+void loop();
+
+int main(int argc, char **argv) {
+  uint32_t runMs = argc > 1 ? strtoul(argv[1], nullptr, 10) : 0;
+  setup();
+  uint32_t start = millis();
+  do {
+    loop();
+  } while (millis() - start < runMs);
+  fflush(stdout);
+  return 0;
+}
@@ -0,0 +1,64 @@
+// Times getDeviceInfo() against EC200USimulator at 115200 baud with 10 ms of
+// modem latency: the first call of each field goes to the module, repeat
+// calls read the cache. The String getter getIMEI() is timed for comparison.
+// Built by the host build (extras/host); no modem needed.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+static const uint32_t REPEATS = 1000000;
+
+static const DeviceInfoField FIELDS[] = {
+  DeviceInfoField::IMEI, DeviceInfoField::IMSI, DeviceInfoField::ICCID,
+  DeviceInfoField::MANUFACTURER, DeviceInfoField::MODEL, DeviceInfoField::FIRMWARE
+};
+static const char *const NAMES[] = { "IMEI", "IMSI", "ICCID", "MANUFACTURER", "MODEL", "FIRMWARE" };
+
+EC200USimulator sim(115200, 10);
+QuectelEC200U modem(sim);
+
+// Keeps the compiler from dropping the repeated calls
+static volatile char sink;
+
+static void printPerCall(const __FlashStringHelper *label, uint32_t us, uint32_t calls) {
+  Serial.print(label);
+  Serial.print((double)us * 1000.0 / calls, 1);
+  Serial.println(F(" ns per call"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== Device-info cache benchmark =="));
+
+  Serial.println(F("First call (AT round trip):"));
+  for (size_t i = 0; i < sizeof(FIELDS) / sizeof(FIELDS[0]); i++) {
+    uint32_t t0 = micros();
+    const char *value = modem.getDeviceInfo(FIELDS[i]);
+    uint32_t us = micros() - t0;
+    Serial.print(F("  "));
+    Serial.print(NAMES[i]);
+    Serial.print(F(": "));
+    Serial.print(us);
+    Serial.print(F(" us, \""));
+    Serial.print(value);
+    Serial.println(F("\""));
+  }
+
+  uint32_t commands = sim.commands();
+  uint32_t t0 = micros();
+  for (uint32_t i = 0; i < REPEATS; i++) {
+    sink = modem.getDeviceInfo(FIELDS[i % 6])[0];
+  }
+  printPerCall(F("Repeat getDeviceInfo(): "), micros() - t0, REPEATS);
+
+  t0 = micros();
+  for (uint32_t i = 0; i < REPEATS / 10; i++) {
+    sink = modem.getIMEI()[0];
+  }
+  printPerCall(F("Repeat getIMEI():       "), micros() - t0, REPEATS / 10);
+
+  Serial.print(F("AT commands during the repeats: "));
+  Serial.println(sim.commands() - commands);
+}
+
+void loop() {}
@@ -0,0 +1,79 @@
+// Runs the library against EC200USimulator instead of a module: begin(), a
+// scripted command with a URC, an HTTP download, a socket URC and a noisy
+// link. Useful for trying changes and timing API calls with no hardware.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+EC200USimulator sim(115200, 10);   // Baud rate, modem processing latency (ms)
+QuectelEC200U modem(sim);
+
+static void onClosed(const char *urc, void *ctx) {
+  (void)ctx;
+  Serial.print(F("[URC] "));
+  Serial.println(urc);
+}
+
+static void timed(const __FlashStringHelper *label, bool ok, uint32_t t0) {
+  Serial.print(label);
+  Serial.print(ok ? F("ok in ") : F("FAILED in "));
+  Serial.print(millis() - t0);
+  Serial.println(F(" ms"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== EC200U simulator demo =="));
+
+  // Replies can be scripted per command prefix; {0}, {1}... echo the arguments
+  sim.addRule("AT+QNTP=", "\r\nOK\r\n", 20, "\r\n+QNTP: 0,\"2025/01/01,12:00:00+00\"\r\n", 300);
+  sim.addRule("AT+CSQ", "\r\n+CSQ: 31,99\r\n\r\nOK\r\n");
+  sim.setHttpBodyPattern(8192);
+
+  // A module that has just started prints RDY and +CPIN: READY; with fast boot
+  // begin() relies on them instead of probing
+  modem.setFastBoot(true);
+  sim.emit("\r\nRDY\r\n\r\n+CPIN: READY\r\n");
+  uint32_t t0 = millis();
+  timed(F("begin():        "), modem.begin(), t0);
+  Serial.print(F("IMEI:           "));
+  Serial.println(modem.getIMEI());
+
+  Serial.print(F("Signal (CSQ):   "));
+  Serial.println(modem.getSignalStrength());
+
+  t0 = millis();
+  timed(F("ntpSync():      "), modem.ntpSync("pool.ntp.org", 0), t0);
+
+  t0 = millis();
+  String body;
+  bool ok = modem.httpGet("http://example.com/file", body);
+  timed(F("httpGet() 8 KB: "), ok && body.length() == 8192, t0);
+
+  modem.onURC("+QIURC: \"closed\"", onClosed);
+  int id = modem.socketOpen("example.com", 80);
+  t0 = millis();
+  timed(F("socketOpen():   "), id >= 0 && modem.socketWaitConnected(id), t0);
+  sim.emit("\r\n+QIURC: \"closed\",0\r\n", 100);   // Peer hangs up 100 ms from now
+  for (uint32_t start = millis(); millis() - start < 300;) {
+    modem.poll();
+  }
+
+  // Stray URCs before 20% of replies, 30% of replies stalled 50 ms mid-way
+  sim.setNoise(20);
+  sim.setStalls(30, 50);
+  int good = 0;
+  for (int i = 0; i < 20; i++) {
+    if (modem.getSignalStrength() == 31) {
+      good++;
+    }
+  }
+  Serial.print(F("Noisy link:     "));
+  Serial.print(good);
+  Serial.println(F("/20 CSQ reads correct"));
+
+  Serial.print(F("Commands seen by the simulator: "));
+  Serial.println(sim.commands());
+}
+
+void loop() {}
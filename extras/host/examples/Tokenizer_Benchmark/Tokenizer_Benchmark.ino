@@ -0,0 +1,102 @@
+// Compares the legacy readResponse() completion check (four strstr() scans over the
+// whole buffer after every batch of bytes) with the streaming ATTokenizer on
+// synthetic 4 KB and 64 KB responses. Built by the host build (extras/host);
+// no modem needed.
+#include <QuectelEC200U.h>
+
+static const size_t SIZES[] = { 4096, 65536 };
+static const size_t UART_BATCH = 64;     // Bytes the legacy loop sees per pass
+static const int ROUNDS = 5;
+
+static const char PATTERN[] = "+QIRD: 0123456789abcdefghijklmnopqrstuvwxyz\r\n";
+static const char TAIL[] = "\r\nOK\r\n";
+
+static char sampleByte(size_t i, size_t total) {
+  size_t tailLen = sizeof(TAIL) - 1;
+  if (i >= total - tailLen) {
+    return TAIL[i - (total - tailLen)];
+  }
+  return PATTERN[i % (sizeof(PATTERN) - 1)];
+}
+
+// Mirrors the pre-tokenizer readResponse() loop without the 255 byte cap.
+static uint32_t runLegacy(size_t total, char *buffer, bool &complete) {
+  uint32_t t0 = micros();
+  size_t n = 0;
+  complete = false;
+  while (n < total && !complete) {
+    size_t batchEnd = min(n + UART_BATCH, total);
+    while (n < batchEnd) {
+      buffer[n] = sampleByte(n, total);
+      n++;
+    }
+    buffer[n] = '\0';
+    complete = strstr(buffer, "\r\nOK\r\n") != NULL ||
+               strstr(buffer, "\r\nERROR\r\n") != NULL ||
+               strstr(buffer, "\r\n> ") != NULL ||
+               strstr(buffer, "+CME ERROR:") != NULL;
+  }
+  return micros() - t0;
+}
+
+static uint32_t runTokenizer(size_t total, bool &complete, size_t &lines) {
+  static char ring[256];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+  uint32_t t0 = micros();
+  complete = false;
+  lines = 0;
+  for (size_t i = 0; i < total && !complete; i++) {
+    ATToken t = tok.feed(sampleByte(i, total));
+    if (t == AT_TOKEN_LINE) {
+      lines++;
+    } else if (t != AT_TOKEN_NONE && (AT_TOKEN_FINAL_MASK & AT_TOKEN_MASK(t))) {
+      complete = true;
+    }
+  }
+  return micros() - t0;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== AT response tokenizer benchmark =="));
+
+  for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+    size_t total = SIZES[s];
+    Serial.print(F("\nResponse size: "));
+    Serial.print(total);
+    Serial.println(F(" bytes"));
+
+    char *buffer = (char *)malloc(total + 1);
+    if (buffer) {
+      uint32_t best = UINT32_MAX;
+      bool ok = false;
+      for (int r = 0; r < ROUNDS; r++) {
+        best = min(best, runLegacy(total, buffer, ok));
+      }
+      free(buffer);
+      Serial.print(F("  legacy strstr rescans: "));
+      Serial.print(best);
+      Serial.print(F(" us"));
+      Serial.println(ok ? F("") : F(" (final code not found)"));
+    } else {
+      Serial.println(F("  legacy strstr rescans: skipped (not enough RAM for a linear buffer)"));
+    }
+
+    uint32_t best = UINT32_MAX;
+    bool ok = false;
+    size_t lines = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+      best = min(best, runTokenizer(total, ok, lines));
+    }
+    Serial.print(F("  streaming tokenizer:   "));
+    Serial.print(best);
+    Serial.print(F(" us, "));
+    Serial.print(lines);
+    Serial.print(F(" lines, 256 byte ring"));
+    Serial.println(ok ? F("") : F(" (final code not found)"));
+  }
+}
+
+void loop() {}
@@ -0,0 +1,83 @@
+// Upload throughput of tcpSend() (AT+QISEND per chunk: command, "> " prompt,
+// payload, SEND OK) against TransparentSocket (AT+QISWTMD=<id>,2, raw bytes) on
+// a simulated 115200 baud link with 20 ms modem latency. Built by the host
+// build (extras/host); no modem needed.
+#include <QuectelEC200U.h>
+#include <TransparentSocket.h>
+#include <EC200USimulator.h>
+
+static const uint32_t LINK_BAUD = 115200;
+static const uint32_t LINK_LATENCY_MS = 20;
+static const size_t TOTAL_BYTES = 32768;
+static const size_t CHUNK = 1024;
+
+EC200USimulator link(LINK_BAUD, LINK_LATENCY_MS);
+QuectelEC200U modem(link);
+
+static void report(const __FlashStringHelper *label, size_t bytes, uint32_t ms) {
+  float kbps = ms ? (bytes / 1024.0f) / (ms / 1000.0f) : 0;
+  float wire = (LINK_BAUD / 10.0f) / 1024.0f;
+  Serial.print(label);
+  Serial.print(bytes);
+  Serial.print(F(" bytes in "));
+  Serial.print(ms);
+  Serial.print(F(" ms = "));
+  Serial.print(kbps, 2);
+  Serial.print(F(" KB/s ("));
+  Serial.print(100.0f * kbps / wire, 1);
+  Serial.println(F("% of wire speed)"));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {}
+  Serial.println(F("\n== Transparent mode throughput benchmark =="));
+
+  int id = modem.socketOpen("example.com", 9000);
+  if (id < 0 || !modem.socketWaitConnected(id)) {
+    Serial.println(F("Socket open failed"));
+    return;
+  }
+
+  String chunk;
+  chunk.reserve(CHUNK);
+  for (size_t i = 0; i < CHUNK; i++) {
+    chunk += (char)('a' + i % 26);
+  }
+
+  // AT+QISEND per chunk
+  size_t sent = 0;
+  uint32_t t0 = millis();
+  while (sent < TOTAL_BYTES && modem.tcpSend(id, chunk)) {
+    sent += CHUNK;
+  }
+  report(F("tcpSend():         "), sent, millis() - t0);
+
+  // Transparent access mode
+  TransparentSocket stream(modem);
+  t0 = millis();
+  if (!stream.begin(id)) {
+    Serial.println(F("Could not enter transparent mode"));
+    return;
+  }
+  uint32_t enterMs = millis() - t0;
+  sent = 0;
+  t0 = millis();
+  while (sent < TOTAL_BYTES) {
+    sent += stream.write((const uint8_t *)chunk.c_str(), CHUNK);
+  }
+  stream.flush();
+  report(F("TransparentSocket: "), sent, millis() - t0);
+
+  t0 = millis();
+  bool exited = stream.end();
+  Serial.print(F("Enter: "));
+  Serial.print(enterMs);
+  Serial.print(F(" ms, exit (+++ with 1 s guard times): "));
+  Serial.print(millis() - t0);
+  Serial.println(exited ? F(" ms") : F(" ms (failed)"));
+  Serial.print(F("Payload bytes seen by the link: "));
+  Serial.println(link.payloadBytes());
+}
+
+void loop() {}
@@ -0,0 +1,656 @@
+/*
+  EC200USimulator - scripted stand-in for an EC200U module behind a Stream
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "EC200USimulator.h"
+
+namespace {
+
+#define SIM_OK "\r\nOK\r\n"
+#define SIM_INFO(line) "\r\n" line "\r\n\r\nOK\r\n"
+
+// Built-in profile: what the library needs for begin(), attachData(), sockets,
+// HTTP(S), MQTT and SMS. User rules are checked first and can override these.
+const SimRule kProfile[] = {
+  { "ATI",             "\r\nQuectel\r\nEC200U\r\nRevision: EC200UCNAAR03A03M08\r\n\r\nOK\r\n",
+                                                                               nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+GMI",          SIM_INFO("Quectel"),                                   nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+GMM",          SIM_INFO("EC200U"),                                    nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+GMR",          SIM_INFO("EC200UCNAAR03A03M08"),                       nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+GSN",          SIM_INFO("864000000000001"),                           nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CGSN",         SIM_INFO("864000000000001"),                           nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CIMI",         SIM_INFO("404450000000001"),                           nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+QCCID",        SIM_INFO("+QCCID: 89910000000000000001"),              nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+IPR?",         SIM_INFO("+IPR: 115200"),                              nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CPIN?",        SIM_INFO("+CPIN: READY"),                              nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CSQ",          SIM_INFO("+CSQ: 24,99"),                               nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CREG?",        SIM_INFO("+CREG: 0,1"),                                nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CGREG?",       SIM_INFO("+CGREG: 0,1"),                               nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CEREG?",       SIM_INFO("+CEREG: 0,1"),                               nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+COPS?",        SIM_INFO("+COPS: 0,0,\"SIMULATED\",7"),                nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+CGATT?",       SIM_INFO("+CGATT: 1"),                                 nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+QIACT?",       SIM_INFO("+QIACT: 1,1,1,\"10.0.0.2\""),                nullptr, nullptr,                                            EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+QIOPEN=",      SIM_OK,                                                nullptr, "\r\n+QIOPEN: {1},0\r\n",                           EC200U_SIM_DEFAULT_LATENCY, 50, 0, false },
+  { "AT+QISEND=",      "> ",                                                  "\r\nSEND OK\r\n", nullptr,                                  EC200U_SIM_DEFAULT_LATENCY, 0, 1, true },
+  { "AT+QHTTPURL=",    "\r\nCONNECT\r\n",                                     SIM_OK, nullptr,                                             EC200U_SIM_DEFAULT_LATENCY, 0, 0, true },
+  { "AT+QHTTPGET",     SIM_OK,                                                nullptr, "\r\n+QHTTPGET: 0,200,{len}\r\n",                   EC200U_SIM_DEFAULT_LATENCY, 100, 0, false },
+  { "AT+QHTTPPOST=",   "\r\nCONNECT\r\n",                                     SIM_OK, "\r\n+QHTTPPOST: 0,200,{len}\r\n",                   EC200U_SIM_DEFAULT_LATENCY, 100, 0, true },
+  { "AT+QHTTPREAD",    "\r\nCONNECT\r\n{body}\r\nOK\r\n\r\n+QHTTPREAD: 0\r\n", nullptr, nullptr,                                           EC200U_SIM_DEFAULT_LATENCY, 0, 0, false },
+  { "AT+QMTOPEN=",     SIM_OK,                                                nullptr, "\r\n+QMTOPEN: {0},0\r\n",                          EC200U_SIM_DEFAULT_LATENCY, 100, 0, false },
+  { "AT+QMTCONN=",     SIM_OK,                                                nullptr, "\r\n+QMTCONN: {0},0,0\r\n",                        EC200U_SIM_DEFAULT_LATENCY, 100, 0, false },
+  { "AT+QMTSUB=",      SIM_OK,                                                nullptr, "\r\n+QMTSUB: {0},{1},0,0\r\n",                     EC200U_SIM_DEFAULT_LATENCY, 50, 0, false },
+  { "AT+QMTPUB=",      "> ",                                                  SIM_OK, "\r\n+QMTPUB: {0},{1},0\r\n",                        EC200U_SIM_DEFAULT_LATENCY, 50, 5, true },
+  { "AT+QMTUNS=",      SIM_OK,                                                nullptr, "\r\n+QMTUNS: {0},{1},0\r\n",                       EC200U_SIM_DEFAULT_LATENCY, 50, 0, false },
+  { "AT+QMTDISC=",     SIM_OK,                                                nullptr, "\r\n+QMTDISC: {0},0\r\n",                          EC200U_SIM_DEFAULT_LATENCY, 50, 0, false },
+  { "AT+QMTCLOSE=",    SIM_OK,                                                nullptr, "\r\n+QMTCLOSE: {0},0\r\n",                         EC200U_SIM_DEFAULT_LATENCY, 50, 0, false },
+  { "AT+CMGS=",        "> ",                                                  "\r\n+CMGS: 1\r\n\r\nOK\r\n", nullptr,                       EC200U_SIM_DEFAULT_LATENCY, 0, -1, true },
+};
+
+const size_t kProfileCount = sizeof(kProfile) / sizeof(kProfile[0]);
+
+// Unsolicited lines a live module sends at arbitrary times
+const char *const kNoise[] = {
+  "\r\n+QIND: \"csq\",24,99\r\n",
+  "\r\n+CEREG: 1\r\n",
+  "\r\n+QIND: PB DONE\r\n",
+  "\r\n",
+};
+
+const size_t kNoiseCount = sizeof(kNoise) / sizeof(kNoise[0]);
+
+}  // namespace
+
+EC200USimulator::EC200USimulator(uint32_t baud, uint32_t latencyMs) {
+  setBaud(baud);
+  _latencyUs = latencyMs * 1000UL;
+  _guardUs = 1000000UL;
+  _ruleCount = 0;
+  _defaults = true;
+  _echo = false;
+  _body = nullptr;
+  _bodyLength = 0;
+  _bodyPattern = false;
+  _noisePct = 0;
+  _stallPct = 0;
+  _stallUs = 0;
+  _seed = 1;
+  _inputTimeoutUs = 0;
+  _inputTimeoutReply = nullptr;
+  _pending = 0;
+  reset();
+}
+
+// ===== Script =====
+bool EC200USimulator::addRule(const char *prefix, const char *reply, uint32_t latencyMs,
+                              const char *urc, uint32_t urcDelayMs) {
+  if (_ruleCount >= EC200U_SIM_MAX_RULES) {
+    return false;
+  }
+  SimRule &r = _rules[_ruleCount++];
+  r.prefix = prefix;
+  r.reply = reply;
+  r.afterData = nullptr;
+  r.urc = urc;
+  r.latencyMs = latencyMs;
+  r.urcDelayMs = urcDelayMs;
+  r.lengthArg = 0;
+  r.data = false;
+  return true;
+}
+
+bool EC200USimulator::addDataRule(const char *prefix, int lengthArg, const char *prompt,
+                                  const char *afterData, const char *urc, uint32_t urcDelayMs) {
+  if (!addRule(prefix, prompt, EC200U_SIM_DEFAULT_LATENCY, urc, urcDelayMs)) {
+    return false;
+  }
+  SimRule &r = _rules[_ruleCount - 1];
+  r.afterData = afterData;
+  r.lengthArg = (int8_t)lengthArg;
+  r.data = true;
+  return true;
+}
+
+void EC200USimulator::clearRules() {
+  _ruleCount = 0;
+}
+
+void EC200USimulator::emit(const char *text, uint32_t delayMs) {
+  Segment *s = _queue(micros() + delayMs * 1000UL);
+  if (s) {
+    s->text = text;
+    s->length = s->text.length();
+  }
+}
+
+void EC200USimulator::emit(const uint8_t *data, size_t length, uint32_t delayMs) {
+  Segment *s = _queue(micros() + delayMs * 1000UL);
+  if (s) {
+    s->data = data;
+    s->length = length;
+  }
+}
+
+void EC200USimulator::dropCarrier(uint32_t delayMs) {
+  _transparent = false;
+  _escapeAt = 0;
+  emit("\r\nNO CARRIER\r\n", delayMs);
+}
+
+// ===== Modem behaviour =====
+void EC200USimulator::setBaud(uint32_t baud) {
+  _byteUs = baud ? (10000000UL + baud / 2) / baud : 0;   // 10 bit times per byte
+}
+
+void EC200USimulator::setHttpBody(const uint8_t *data, size_t length) {
+  _body = data;
+  _bodyLength = length;
+  _bodyPattern = false;
+}
+
+void EC200USimulator::setHttpBody(const char *text) {
+  setHttpBody((const uint8_t *)text, strlen(text));
+}
+
+void EC200USimulator::setHttpBodyPattern(size_t length) {
+  _body = nullptr;
+  _bodyLength = length;
+  _bodyPattern = true;
+}
+
+void EC200USimulator::reset() {
+  _txFreeAt = micros();
+  _rxFreeAt = _txFreeAt;
+  for (uint8_t i = 0; i < _pending; i++) {
+    _segs[_order[i]].text = "";
+  }
+  _pending = 0;
+  _line = "";
+  _cmd = "";
+  _skipLf = false;
+  _dataRule = nullptr;
+  _dataRemaining = 0;
+  _dataCount = 0;
+  _dataStart = 0;
+  _transparent = false;
+  _plusCount = 0;
+  _lastTxByte = 0;
+  _escapeAt = 0;
+  _commands = 0;
+  _payload = 0;
+  _written = 0;
+  _read = 0;
+}
+
+// ===== Stream =====
+int EC200USimulator::available() {
+  _service();
+  while (_pending > 0) {
+    Segment &s = _segs[_order[0]];
+    if (!s.onWire) {
+      return 0;
+    }
+    if (s.pos >= s.length) {
+      _pop();
+      _service();
+      continue;
+    }
+    size_t n = _arrived(s);
+    return n > s.pos ? (int)(n - s.pos) : 0;
+  }
+  return 0;
+}
+
+int EC200USimulator::peek() {
+  if (available() <= 0) {
+    return -1;
+  }
+  const Segment &s = _segs[_order[0]];
+  if (s.pattern) {
+    return 'a' + s.pos % 26;
+  }
+  return s.data ? s.data[s.pos] : (uint8_t)s.text[s.pos];
+}
+
+int EC200USimulator::read() {
+  int c = peek();
+  if (c >= 0) {
+    _segs[_order[0]].pos++;
+    _read++;
+  }
+  return c;
+}
+
+size_t EC200USimulator::write(uint8_t c) {
+  _wire();
+  _written++;
+
+  // Lines end with CR (LF optional); don't count the LF as payload
+  if (_skipLf && c == '\n') {
+    _skipLf = false;
+    return 1;
+  }
+  _skipLf = false;
+
+  if (_transparent) {
+    _onTransparentByte(c);
+  } else if (_dataRule) {
+    if (_dataRemaining < 0) {
+      if (c == 0x1A) {
+        _endData();
+      } else {
+        _dataCount++;
+      }
+    } else {
+      _dataCount++;
+      if (--_dataRemaining == 0) {
+        _endData();
+      }
+    }
+  } else {
+    _onByte(c);
+  }
+  return 1;
+}
+
+size_t EC200USimulator::write(const uint8_t *buf, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    write(buf[i]);
+  }
+  return size;
+}
+
+void EC200USimulator::flush() {
+  while ((int32_t)(micros() - _txFreeAt) < 0) {
+  }
+}
+
+// ===== Command handling =====
+
+// Blocks like a full hardware TX FIFO would
+void EC200USimulator::_wire() {
+  static const uint32_t TX_FIFO = 128;
+  uint32_t now = micros();
+  if ((int32_t)(_txFreeAt - now) < 0) {
+    _txFreeAt = now;
+  }
+  while ((int32_t)(_txFreeAt - micros()) > (int32_t)(TX_FIFO * _byteUs)) {
+  }
+  _txFreeAt += _byteUs;
+}
+
+void EC200USimulator::_onByte(uint8_t c) {
+  if (c == '\r' || c == '\n') {
+    _skipLf = (c == '\r');
+    _cmd = _line;
+    _line = "";
+    _onCommand();
+  } else {
+    _line += (char)c;
+  }
+}
+
+void EC200USimulator::_onCommand() {
+  if (_cmd.length() == 0) {
+    return;
+  }
+  _commands++;
+  uint32_t at = _txFreeAt + _latencyUs;
+  if (_echo) {
+    Segment *s = _queue(_txFreeAt);
+    if (s) {
+      s->text = _cmd + "\r";
+      s->length = s->text.length();
+    }
+  }
+
+  // Commands that change the simulator's own state
+  _basicSettings();
+  if (_onCompound(at)) {
+    return;
+  }
+  String mode;
+  if ((_cmd.startsWith("AT+QISWTMD=") && _arg(1, mode) && mode == "2") || _cmd.equalsIgnoreCase("ATO")) {
+    _transparent = true;
+    _plusCount = 0;
+    _escapeAt = 0;
+    _lastTxByte = micros();
+    _queueTemplate("\r\nCONNECT\r\n", at);
+    return;
+  }
+
+  const SimRule *rule = _findRule();
+  if (!rule) {
+    _queueTemplate(_cmd.startsWith("AT") || _cmd.startsWith("at") ? SIM_OK : "\r\nERROR\r\n", at);
+    return;
+  }
+  if (!rule->data) {
+    _respond(rule, rule->reply, rule->urc);
+    return;
+  }
+
+  String length;
+  _dataRule = rule;
+  _dataRemaining = -1;
+  _dataCount = 0;
+  _dataStart = _txFreeAt;
+  if (rule->lengthArg >= 0 && _arg(rule->lengthArg, length)) {
+    _dataRemaining = length.toInt();
+  }
+  _respond(rule, rule->reply, nullptr);
+  if (_dataRemaining == 0) {
+    _endData();
+  }
+}
+
+// ATE0 / ATE1 anywhere in the basic part of the line ("ATE0V1;+CMEE=2")
+void EC200USimulator::_basicSettings() {
+  if (!_cmd.startsWith("AT") && !_cmd.startsWith("at")) {
+    return;
+  }
+  for (unsigned int i = 2; i + 1 < _cmd.length() && _cmd[i] != '+' && _cmd[i] != ';'; i++) {
+    if ((_cmd[i] == 'E' || _cmd[i] == 'e') && (_cmd[i + 1] == '0' || _cmd[i + 1] == '1')) {
+      _echo = (_cmd[i + 1] == '1');
+    }
+  }
+}
+
+// "AT+A;+B;+C": every part answers in turn and a single final result code
+// closes the line. The first ERROR ends it. Data rules are not supported here.
+bool EC200USimulator::_onCompound(uint32_t at) {
+  String line = _cmd;
+  bool quoted = false;
+  bool compound = false;
+  for (unsigned int i = 0; i < line.length() && !compound; i++) {
+    if (line[i] == '"') {
+      quoted = !quoted;
+    }
+    compound = !quoted && line[i] == ';';
+  }
+  if (!compound) {
+    return false;
+  }
+
+  static const char kOk[] = SIM_OK;
+  const size_t okLen = sizeof(kOk) - 1;
+  unsigned int start = 0;
+  quoted = false;
+  for (unsigned int i = 0; i <= line.length(); i++) {
+    bool end = (i == line.length());
+    if (!end && line[i] == '"') {
+      quoted = !quoted;
+    }
+    if (!end && (quoted || line[i] != ';')) {
+      continue;
+    }
+    String part = line.substring(start, i);
+    start = i + 1;
+    _cmd = (part.startsWith("AT") || part.startsWith("at")) ? part : "AT" + part;
+    if (_cmd.length() == 2 && !end) {
+      continue;                          // Empty part ("AT;+CMEE=2")
+    }
+
+    const SimRule *rule = _findRule();
+    const char *reply = (rule && !rule->data && rule->reply) ? rule->reply : kOk;
+    if (strstr(reply, "ERROR") != nullptr) {
+      _queueTemplate(reply, at);
+      break;
+    }
+    String text = reply;
+    if (!end && text.endsWith(kOk)) {
+      text.remove(text.length() - okLen);
+    }
+    _queueTemplate(text.c_str(), at);
+    if (rule && !rule->data && rule->urc) {
+      _queueTemplate(rule->urc, at + rule->urcDelayMs * 1000UL);
+    }
+  }
+  _cmd = line;
+  return true;
+}
+
+void EC200USimulator::_endData() {
+  const SimRule *rule = _dataRule;
+  _dataRule = nullptr;
+  _payload += _dataCount;
+  if (rule->afterData) {
+    _respond(rule, rule->afterData, rule->urc);
+  }
+}
+
+const SimRule *EC200USimulator::_findRule() const {
+  for (int i = (int)_ruleCount - 1; i >= 0; i--) {
+    if (_cmd.startsWith(_rules[i].prefix)) {
+      return &_rules[i];
+    }
+  }
+  if (_defaults) {
+    for (size_t i = 0; i < kProfileCount; i++) {
+      if (_cmd.startsWith(kProfile[i].prefix)) {
+        return &kProfile[i];
+      }
+    }
+  }
+  return nullptr;
+}
+
+void EC200USimulator::_respond(const SimRule *rule, const char *reply, const char *urc) {
+  uint32_t latency = rule->latencyMs == EC200U_SIM_DEFAULT_LATENCY ? _latencyUs : rule->latencyMs * 1000UL;
+  uint32_t at = _txFreeAt + latency;
+  if (_noisePct && _random(100) < _noisePct) {
+    _queueTemplate(kNoise[_random(kNoiseCount)], at);
+  }
+  if (reply) {
+    _queueTemplate(reply, at);
+  }
+  if (urc) {
+    _queueTemplate(urc, at + rule->urcDelayMs * 1000UL);
+  }
+}
+
+// "+++" only counts with a guard time of silence on both sides
+void EC200USimulator::_onTransparentByte(uint8_t c) {
+  uint32_t now = micros();
+  if (c == '+' && (_plusCount > 0 || now - _lastTxByte >= _guardUs)) {
+    _plusCount++;
+    if (_plusCount == 3) {
+      _escapeAt = now;
+    }
+  } else {
+    _payload += _plusCount + 1;
+    _plusCount = 0;
+    _escapeAt = 0;
+  }
+  _lastTxByte = now;
+}
+
+// Argument 'index' of the current command, surrounding quotes removed
+bool EC200USimulator::_arg(int index, String &out) const {
+  int pos = _cmd.indexOf('=');
+  if (pos < 0) {
+    return false;
+  }
+  pos++;
+  for (int i = 0; i < index; i++) {
+    bool quoted = false;
+    while (pos < (int)_cmd.length() && (quoted || _cmd[pos] != ',')) {
+      if (_cmd[pos] == '"') {
+        quoted = !quoted;
+      }
+      pos++;
+    }
+    if (pos >= (int)_cmd.length()) {
+      return false;
+    }
+    pos++;
+  }
+  int end = pos;
+  bool quoted = false;
+  while (end < (int)_cmd.length() && (quoted || _cmd[end] != ',')) {
+    if (_cmd[end] == '"') {
+      quoted = !quoted;
+    }
+    end++;
+  }
+  out = _cmd.substring(pos, end);
+  if (out.length() >= 2 && out[0] == '"' && out[out.length() - 1] == '"') {
+    out = out.substring(1, out.length() - 1);
+  }
+  return true;
+}
+
+// ===== Output scheduling =====
+void EC200USimulator::_queueTemplate(const char *tmpl, uint32_t at) {
+  Segment *s = _queue(at);
+  if (!s) {
+    return;
+  }
+  for (const char *p = tmpl; *p; p++) {
+    if (*p != '{') {
+      s->text += *p;
+      continue;
+    }
+    const char *close = strchr(p, '}');
+    size_t n = close ? (size_t)(close - p - 1) : 0;
+    String value;
+    if (n == 1 && p[1] >= '0' && p[1] <= '9') {
+      _arg(p[1] - '0', value);
+    } else if (n == 3 && strncmp(p + 1, "len", 3) == 0) {
+      value = String((unsigned long)_bodyLength);
+    } else if (n == 1 && p[1] == 'n') {
+      value = String((unsigned long)_dataCount);
+    } else if (n == 4 && strncmp(p + 1, "body", 4) == 0) {
+      s->length = s->text.length();
+      if (_bodyLength > 0) {
+        Segment *body = _queue(at);
+        if (!body) {
+          return;
+        }
+        body->data = _body;
+        body->pattern = _bodyPattern;
+        body->length = _bodyLength;
+      }
+      s = _queue(at);
+      if (!s) {
+        return;
+      }
+      p = close;
+      continue;
+    } else {
+      s->text += *p;
+      continue;
+    }
+    s->text += value;
+    p = close;
+  }
+  s->length = s->text.length();
+}
+
+// Reserves a segment due at 'at', after everything due at or before it
+EC200USimulator::Segment *EC200USimulator::_queue(uint32_t at) {
+  if (_pending >= EC200U_SIM_MAX_PENDING) {
+    return nullptr;
+  }
+  uint8_t slot = 0;
+  for (; slot < EC200U_SIM_MAX_PENDING; slot++) {
+    bool used = false;
+    for (uint8_t i = 0; i < _pending && !used; i++) {
+      used = (_order[i] == slot);
+    }
+    if (!used) {
+      break;
+    }
+  }
+
+  uint8_t pos = _pending;
+  while (pos > 0) {
+    const Segment &prev = _segs[_order[pos - 1]];
+    if (prev.onWire || (int32_t)(prev.due - at) <= 0) {
+      break;
+    }
+    pos--;
+  }
+  for (uint8_t i = _pending; i > pos; i--) {
+    _order[i] = _order[i - 1];
+  }
+  _order[pos] = slot;
+  _pending++;
+
+  Segment &s = _segs[slot];
+  s.text = "";
+  s.data = nullptr;
+  s.length = 0;
+  s.pos = 0;
+  s.pattern = false;
+  s.onWire = false;
+  s.due = at;
+  s.readyAt = at;
+  s.stallAt = 0;
+  s.stallUs = 0;
+  return &s;
+}
+
+// Puts due segments on the RX line in order and completes a pending escape
+void EC200USimulator::_service() {
+  uint32_t now = micros();
+  if (_escapeAt != 0 && now - _escapeAt >= _guardUs) {
+    uint32_t at = _escapeAt + _guardUs;
+    _escapeAt = 0;
+    _plusCount = 0;
+    _transparent = false;
+    _queueTemplate(SIM_OK, at);
+  }
+  if (_dataRule && _inputTimeoutUs && (int32_t)(now - _dataStart - _inputTimeoutUs) >= 0) {
+    _payload += _dataCount;
+    _dataRule = nullptr;
+    _queueTemplate(_inputTimeoutReply, _dataStart + _inputTimeoutUs);
+  }
+
+  for (uint8_t i = 0; i < _pending; i++) {
+    Segment &s = _segs[_order[i]];
+    if (s.onWire) {
+      continue;
+    }
+    if ((int32_t)(now - s.due) < 0) {
+      break;
+    }
+    s.readyAt = (int32_t)(_rxFreeAt - s.due) > 0 ? _rxFreeAt : s.due;
+    if (_stallPct && s.length > 1 && _random(100) < _stallPct) {
+      s.stallAt = 1 + _random(s.length - 1);
+      s.stallUs = _stallUs;
+    }
+    _rxFreeAt = s.readyAt + s.length * _byteUs + s.stallUs;
+    s.onWire = true;
+  }
+}
+
+// Bytes of 's' that have fully arrived by now
+size_t EC200USimulator::_arrived(const Segment &s) const {
+  int32_t elapsed = (int32_t)(micros() - s.readyAt);
+  if (elapsed < 0) {
+    return 0;
+  }
+  size_t n = _byteUs ? (size_t)elapsed / _byteUs : s.length;
+  if (s.stallUs && n > s.stallAt) {
+    int32_t late = elapsed - (int32_t)s.stallUs;
+    size_t m = late < 0 ? 0 : (_byteUs ? (size_t)late / _byteUs : s.length);
+    n = m > s.stallAt ? m : s.stallAt;
+  }
+  return n < s.length ? n : s.length;
+}
+
+void EC200USimulator::_pop() {
+  _segs[_order[0]].text = "";
+  for (uint8_t i = 1; i < _pending; i++) {
+    _order[i - 1] = _order[i];
+  }
+  _pending--;
+}
+
+uint32_t EC200USimulator::_random(uint32_t range) {
+  _seed ^= _seed << 13;
+  _seed ^= _seed >> 17;
+  _seed ^= _seed << 5;
+  return range ? _seed % range : 0;
+}
@@ -0,0 +1,186 @@
+/*
+  EC200USimulator - scripted stand-in for an EC200U module behind a Stream
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Pass it to QuectelEC200U instead of a UART to run sketches, benchmarks and
+  regression checks without a module. Commands are answered from a rule table
+  (prefix -> reply, latency, optional URC) with a built-in profile covering the
+  commands the library issues; concatenated lines ("ATE0V1;+CMEE=2") are
+  answered part by part with one final result code. The serial line is
+  modelled at the configured baud rate: writes block like a full TX FIFO and
+  reply bytes arrive one bit time after another, so reads come back in
+  realistic partial chunks. Noise (stray URC lines) and mid-reply stalls can
+  be injected at a given rate.
+
+  Only the Arduino core (Stream, String, micros) is used. It lives outside
+  src/ so that it is not compiled into firmware; the host build in extras/host
+  links it into the host sketches, benchmarks and tests.
+*/
+
+#ifndef EC200U_SIMULATOR_H
+#define EC200U_SIMULATOR_H
+
+#include <Arduino.h>
+
+#ifndef EC200U_SIM_MAX_RULES
+#define EC200U_SIM_MAX_RULES 24       // User rules, checked before the built-in profile
+#endif
+#ifndef EC200U_SIM_MAX_PENDING
+#define EC200U_SIM_MAX_PENDING 16     // Replies/URCs scheduled or on the wire
+#endif
+
+#define EC200U_SIM_DEFAULT_LATENCY 0xFFFFFFFFUL
+
+// One scripted command. Templates may use {0}..{9} (command arguments, quotes
+// stripped), {len} (HTTP body length), {n} (bytes of the last data phase) and,
+// in replies only, {body} (the HTTP body itself).
+struct SimRule {
+  const char *prefix;
+  const char *reply;          // Sent 'latencyMs' after the command line
+  const char *afterData;      // Data rules: sent once the payload is in
+  const char *urc;            // Optional, sent 'urcDelayMs' after the final reply
+  uint32_t latencyMs;
+  uint32_t urcDelayMs;
+  int8_t lengthArg;           // Data rules: argument holding the payload length,
+                              // -1 (or argument missing): payload ends with Ctrl-Z
+  bool data;
+};
+
+class EC200USimulator : public Stream {
+  public:
+    EC200USimulator(uint32_t baud = 115200, uint32_t latencyMs = 10);
+
+    // Script
+    bool addRule(const char *prefix, const char *reply,
+                 uint32_t latencyMs = EC200U_SIM_DEFAULT_LATENCY,
+                 const char *urc = nullptr, uint32_t urcDelayMs = 0);
+    bool addDataRule(const char *prefix, int lengthArg, const char *prompt, const char *afterData,
+                     const char *urc = nullptr, uint32_t urcDelayMs = 0);
+    void clearRules();
+    void useDefaults(bool enable) { _defaults = enable; }
+
+    // Unsolicited output, 'delayMs' from now. Raw data is not copied: keep
+    // the buffer alive until it has been read.
+    void emit(const char *text, uint32_t delayMs = 0);
+    void emit(const uint8_t *data, size_t length, uint32_t delayMs = 0);
+    void dropCarrier(uint32_t delayMs = 0);   // Transparent mode: NO CARRIER
+
+    // Modem behaviour
+    void setBaud(uint32_t baud);
+    void setLatency(uint32_t ms) { _latencyUs = ms * 1000UL; }
+    void setGuardTime(uint32_t ms) { _guardUs = ms * 1000UL; }
+    void setEcho(bool enable) { _echo = enable; }
+    void setHttpBody(const uint8_t *data, size_t length);
+    void setHttpBody(const char *text);
+    void setHttpBodyPattern(size_t length);   // 'a'..'z' repeated, nothing stored
+    // A data phase still short of its payload 'ms' after the command ends
+    // with 'reply', back in command mode (0 = wait forever)
+    void setInputTimeout(uint32_t ms, const char *reply = "\r\nERROR\r\n") {
+      _inputTimeoutUs = ms * 1000UL;
+      _inputTimeoutReply = reply;
+    }
+
+    // Fault injection (percent of replies, reproducible via setSeed())
+    void setNoise(uint8_t percent) { _noisePct = percent; }
+    void setStalls(uint8_t percent, uint32_t stallMs) { _stallPct = percent; _stallUs = stallMs * 1000UL; }
+    void setSeed(uint32_t seed) { _seed = seed ? seed : 1; }
+
+    void reset();                             // Drops pending output and state, keeps rules
+
+    // Statistics
+    uint32_t commands() const { return _commands; }
+    size_t payloadBytes() const { return _payload; }
+    size_t bytesWritten() const { return _written; }
+    size_t bytesRead() const { return _read; }
+    bool transparent() const { return _transparent; }
+    const String &lastCommand() const { return _cmd; }
+
+    // Stream
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    void flush() override;                    // Waits until the TX line is idle
+
+    using Print::write;
+
+  private:
+    struct Segment {
+      String text;
+      const uint8_t *data;      // Raw data or HTTP body (text unused)
+      size_t length;
+      size_t pos;
+      bool pattern;
+      bool onWire;
+      uint32_t due;             // micros() it may start on the line
+      uint32_t readyAt;         // Line start time, set once on the wire
+      size_t stallAt;
+      uint32_t stallUs;
+    };
+
+    uint32_t _byteUs;
+    uint32_t _latencyUs;
+    uint32_t _guardUs;
+    uint32_t _txFreeAt;
+    uint32_t _rxFreeAt;
+
+    SimRule _rules[EC200U_SIM_MAX_RULES];
+    uint8_t _ruleCount;
+    bool _defaults;
+
+    Segment _segs[EC200U_SIM_MAX_PENDING];
+    uint8_t _order[EC200U_SIM_MAX_PENDING];   // Indexes into _segs, sorted by 'due'
+    uint8_t _pending;
+
+    String _line;
+    String _cmd;
+    bool _skipLf;
+    bool _echo;
+
+    const SimRule *_dataRule;   // Data phase in progress
+    long _dataRemaining;        // -1: until Ctrl-Z
+    size_t _dataCount;
+    uint32_t _dataStart;
+    uint32_t _inputTimeoutUs;
+    const char *_inputTimeoutReply;
+
+    bool _transparent;
+    uint8_t _plusCount;
+    uint32_t _lastTxByte;
+    uint32_t _escapeAt;
+
+    const uint8_t *_body;
+    size_t _bodyLength;
+    bool _bodyPattern;
+
+    uint8_t _noisePct;
+    uint8_t _stallPct;
+    uint32_t _stallUs;
+    uint32_t _seed;
+
+    uint32_t _commands;
+    size_t _payload;
+    size_t _written;
+    size_t _read;
+
+    void _wire();
+    void _onByte(uint8_t c);
+    void _onCommand();
+    void _basicSettings();
+    bool _onCompound(uint32_t at);
+    void _onTransparentByte(uint8_t c);
+    void _endData();
+    const SimRule *_findRule() const;
+    void _respond(const SimRule *rule, const char *reply, const char *urc);
+    bool _arg(int index, String &out) const;
+    void _queueTemplate(const char *tmpl, uint32_t at);
+    Segment *_queue(uint32_t at);
+    void _service();
+    size_t _arrived(const Segment &s) const;
+    void _pop();
+    uint32_t _random(uint32_t range);
+};
+
+#endif
@@ -0,0 +1,55 @@
+/*
+  Minimal test harness for the host build of QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "HostTest.h"
+
+namespace hosttest {
+
+namespace {
+
+const size_t kMaxTests = 64;
+
+struct Case {
+  const char *name;
+  TestFn fn;
+};
+
+Case cases[kMaxTests];
+size_t caseCount = 0;
+const char *current = "";
+unsigned failures = 0;
+
+}  // namespace
+
+Registrar::Registrar(const char *name, TestFn fn) {
+  if (caseCount < kMaxTests) {
+    cases[caseCount++] = { name, fn };
+  }
+}
+
+void fail(const char *file, int line, const char *expr) {
+  printf("%s:%d: %s: CHECK(%s) failed\n", file, line, current, expr);
+  failures++;
+}
+
+void failEq(const char *file, int line, const char *expr, long long actual, long long expected) {
+  printf("%s:%d: %s: %s is %lld, expected %lld\n", file, line, current, expr, actual, expected);
+  failures++;
+}
+
+}  // namespace hosttest
+
+int main() {
+  using namespace hosttest;
+  for (size_t i = 0; i < caseCount; i++) {
+    unsigned before = failures;
+    current = cases[i].name;
+    cases[i].fn();
+    printf("%s %s\n", failures == before ? "[ OK ]" : "[FAIL]", current);
+  }
+  printf("%u check(s) failed in %u test(s)\n", failures, (unsigned)caseCount);
+  return failures == 0 ? 0 : 1;
+}
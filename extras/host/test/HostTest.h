@@ -0,0 +1,47 @@
+/*
+  Minimal test harness for the host build of QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  TEST(name) { ... } registers a case; CHECK() and CHECK_EQ() record a
+  failure and carry on. Each test file links with HostTest.cpp, which runs
+  every case and returns non-zero if any check failed.
+*/
+
+#ifndef EC200U_HOST_TEST_H
+#define EC200U_HOST_TEST_H
+
+#include <Arduino.h>
+
+namespace hosttest {
+
+typedef void (*TestFn)();
+
+struct Registrar {
+  Registrar(const char *name, TestFn fn);
+};
+
+void fail(const char *file, int line, const char *expr);
+void failEq(const char *file, int line, const char *expr, long long actual, long long expected);
+
+}  // namespace hosttest
+
+#define TEST(name)                                                   \
+  static void name();                                                \
+  static hosttest::Registrar name##_registrar(#name, name);          \
+  static void name()
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) hosttest::fail(__FILE__, __LINE__, #cond);          \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                   \
+  do {                                                               \
+    long long a_ = (long long)(actual), e_ = (long long)(expected);  \
+    if (a_ != e_) {                                                  \
+      hosttest::failEq(__FILE__, __LINE__, #actual, a_, e_);         \
+    }                                                                \
+  } while (0)
+
+#endif
@@ -0,0 +1,205 @@
+// Asynchronous AT engine: queue limits, cancellation, timeouts and the
+// handle -> status table, driven against a scripted EC200USimulator.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+struct Completion {
+  int calls;
+  int handle;
+  ATStatus status;
+  String response;
+};
+
+void record(int handle, ATStatus status, const char *response, void *ctx) {
+  Completion *c = static_cast<Completion *>(ctx);
+  c->calls++;
+  c->handle = handle;
+  c->status = status;
+  c->response = response;
+}
+
+bool pollUntilIdle(QuectelEC200U &modem, uint32_t limitMs = 2000) {
+  uint32_t start = millis();
+  while (modem.isBusy() && millis() - start < limitMs) {
+    modem.poll();
+  }
+  return !modem.isBusy();
+}
+
+}  // namespace
+
+TEST(completesInOrderWithResponse) {
+  EC200USimulator sim(115200, 5);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+FAIL", "\r\n+CME ERROR: 3\r\n");
+  Completion first = {}, second = {};
+
+  int a = modem.sendATAsync("AT+CSQ", record, &first);
+  int b = modem.sendATAsync("AT+FAIL", record, &second);
+  CHECK(a > 0);
+  CHECK(b > a);
+  CHECK(modem.getATStatus(a) == ATStatus::RUNNING);
+  CHECK(modem.getATStatus(b) == ATStatus::QUEUED);
+
+  CHECK(pollUntilIdle(modem));
+  CHECK_EQ(first.calls, 1);
+  CHECK(first.status == ATStatus::SUCCESS);
+  CHECK(first.response.indexOf("+CSQ: 24,99") >= 0);
+  CHECK_EQ(second.calls, 1);
+  CHECK(second.status == ATStatus::FAILED);
+  CHECK(modem.getATStatus(b) == ATStatus::FAILED);
+}
+
+TEST(queueOverflowIsRejected) {
+  EC200USimulator sim(115200, 20);
+  QuectelEC200U modem(sim);
+  Completion done[AT_QUEUE_SIZE] = {};
+
+  for (int i = 0; i < AT_QUEUE_SIZE; i++) {
+    CHECK(modem.sendATAsync("AT", record, &done[i]) > 0);
+  }
+  CHECK_EQ(modem.pendingCommands(), AT_QUEUE_SIZE);
+  CHECK_EQ(modem.sendATAsync("AT"), -1);
+  CHECK_EQ(modem.pendingCommands(), AT_QUEUE_SIZE);
+
+  // A slot frees up once the running command completes
+  uint32_t start = millis();
+  while (modem.pendingCommands() == AT_QUEUE_SIZE && millis() - start < 1000) {
+    modem.poll();
+  }
+  CHECK(modem.sendATAsync("AT") > 0);
+
+  CHECK(pollUntilIdle(modem));
+  for (int i = 0; i < AT_QUEUE_SIZE; i++) {
+    CHECK_EQ(done[i].calls, 1);
+    CHECK(done[i].status == ATStatus::SUCCESS);
+  }
+  CHECK_EQ(sim.commands(), AT_QUEUE_SIZE + 1);
+}
+
+TEST(cancelRemovesQueuedCommandsOnly) {
+  EC200USimulator sim(115200, 20);
+  QuectelEC200U modem(sim);
+  Completion running = {}, cancelled = {}, kept = {};
+
+  int a = modem.sendATAsync("AT+CSQ", record, &running);
+  int b = modem.sendATAsync("AT+CANCELLED", record, &cancelled);
+  int c = modem.sendATAsync("AT+KEPT", record, &kept);
+
+  CHECK(!modem.cancelAT(a));                    // Already on the wire
+  CHECK(modem.cancelAT(b));
+  CHECK(!modem.cancelAT(b));                    // Only once
+  CHECK(!modem.cancelAT(12345));
+  CHECK_EQ(cancelled.calls, 1);
+  CHECK(cancelled.status == ATStatus::CANCELLED);
+  CHECK(modem.getATStatus(b) == ATStatus::CANCELLED);
+  CHECK_EQ(modem.pendingCommands(), 2);
+
+  CHECK(pollUntilIdle(modem));
+  CHECK_EQ(cancelled.calls, 1);
+  CHECK(running.status == ATStatus::SUCCESS);
+  CHECK(kept.status == ATStatus::SUCCESS);
+  CHECK_EQ(sim.commands(), 2);
+  CHECK(sim.lastCommand() == "AT+KEPT");
+  CHECK(modem.getATStatus(c) == ATStatus::SUCCESS);
+}
+
+TEST(timeoutFreesTheQueue) {
+  EC200USimulator sim(115200, 5);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+SILENT", nullptr);
+  Completion silent = {}, next = {};
+
+  uint32_t start = millis();
+  int a = modem.sendATAsync("AT+SILENT", record, &silent, 50);
+  modem.sendATAsync("AT+CSQ", record, &next, 500);
+  uint32_t timedOut = 0;
+  while (modem.isBusy() && millis() - start < 2000) {
+    modem.poll();
+    if (!timedOut && silent.calls) {
+      timedOut = millis() - start;
+    }
+  }
+
+  CHECK_EQ(silent.calls, 1);
+  CHECK(silent.status == ATStatus::TIMEOUT);
+  CHECK(modem.getATStatus(a) == ATStatus::TIMEOUT);
+  CHECK(timedOut >= 50);
+  CHECK(timedOut < 200);
+  CHECK(next.status == ATStatus::SUCCESS);
+}
+
+TEST(expectedTextCompletesEarly) {
+  EC200USimulator sim(115200, 5);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+QNTP=", "\r\nOK\r\n", 5, "\r\n+QNTP: 0,\"2025/01/01,12:00:00+00\"\r\n", 30);
+  Completion ntp = {};
+
+  modem.sendATAsync("AT+QNTP=1,\"pool.ntp.org\"", record, &ntp, 1000, "+QNTP: 0");
+  CHECK(pollUntilIdle(modem));
+  CHECK(ntp.status == ATStatus::SUCCESS);
+  CHECK(ntp.response.indexOf("+QNTP: 0,") >= 0);
+}
+
+TEST(expectOnlyMatchesTheStartOfALine) {
+  EC200USimulator sim(115200, 5);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+INFO", "\r\n+INFO: LOOK OK\r\n\r\nERROR\r\n");
+  Completion info = {};
+
+  modem.sendATAsync("AT+INFO", record, &info);
+  CHECK(pollUntilIdle(modem));
+  CHECK(info.status == ATStatus::FAILED);
+  CHECK(info.response.indexOf("ERROR") >= 0);
+
+  // The ERROR was consumed with its command, not left for the next one
+  CHECK(modem.sendAT("AT"));
+}
+
+TEST(expectedLineStillWaitsForTheFinalCode) {
+  EC200USimulator sim(115200, 5);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+QLIST", "\r\n+QLIST: 1\r\n\r\n+QLIST: 2\r\n\r\nOK\r\n");
+  sim.addRule("AT+QBAD", "\r\n+QLIST: 1\r\n\r\n+CME ERROR: 50\r\n");
+  Completion list = {}, bad = {};
+
+  modem.sendATAsync("AT+QLIST", record, &list, 1000, "+QLIST:");
+  modem.sendATAsync("AT+QBAD", record, &bad, 1000, "+QLIST:");
+  CHECK(pollUntilIdle(modem));
+  CHECK(list.status == ATStatus::SUCCESS);
+  CHECK(list.response.indexOf("+QLIST: 2") >= 0);
+  CHECK(bad.status == ATStatus::FAILED);
+  CHECK(modem.sendAT("AT"));
+}
+
+TEST(statusSlotsAreRecycled) {
+  EC200USimulator sim(115200, 1);
+  QuectelEC200U modem(sim);
+
+  CHECK(modem.getATStatus(0) == ATStatus::NONE);
+  CHECK(modem.getATStatus(-1) == ATStatus::NONE);
+
+  int first = modem.sendATAsync("AT");
+  CHECK(pollUntilIdle(modem));
+  CHECK(modem.getATStatus(first) == ATStatus::SUCCESS);
+
+  // Handles share AT_QUEUE_SIZE status slots: the oldest result is forgotten
+  // once as many newer commands have been issued, never misreported
+  int last = first;
+  for (int i = 0; i < AT_QUEUE_SIZE - 1; i++) {
+    last = modem.sendATAsync("AT");
+    CHECK(pollUntilIdle(modem));
+  }
+  CHECK(modem.getATStatus(first) == ATStatus::SUCCESS);
+  last = modem.sendATAsync("AT");
+  CHECK_EQ(last, first + AT_QUEUE_SIZE);
+  CHECK(modem.getATStatus(first) == ATStatus::NONE);
+  CHECK(modem.getATStatus(last) == ATStatus::RUNNING);
+  CHECK(pollUntilIdle(modem));
+  CHECK(modem.getATStatus(last) == ATStatus::SUCCESS);
+  CHECK(modem.getATStatus(last + 1) == ATStatus::NONE);
+}
@@ -0,0 +1,187 @@
+// HTTP(S) client: streamed uploads, POSTs written in steps, the
+// QHTTPCFG/QHTTPURL cache and HttpSession contexts and batches.
+#include <QuectelEC200U.h>
+#include <HttpSession.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+const char URL[] = "http://example.com/upload";
+
+struct ShortSource {
+  size_t supply;      // Bytes handed out before running dry
+  size_t given;
+};
+
+size_t shortSource(uint8_t *buffer, size_t maxLen, void *ctx) {
+  ShortSource *s = static_cast<ShortSource *>(ctx);
+  size_t n = s->supply - s->given;
+  if (n > maxLen) {
+    n = maxLen;
+  }
+  memset(buffer, 'x', n);
+  s->given += n;
+  return n;
+}
+
+// Every third body is skipped
+bool everyThirdSkipped(size_t index, String &body, void *ctx) {
+  (void)ctx;
+  if (index % 3 == 2) {
+    return false;
+  }
+  body = "{\"seq\":" + String((unsigned long)index) + "}";
+  return true;
+}
+
+}  // namespace
+
+TEST(streamedPostSendsTheWholeBody) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  ShortSource source = { 1000, 0 };
+  String response;
+
+  CHECK(modem.httpPostStream(URL, 1000, shortSource, &source, response));
+  CHECK_EQ(modem.httpStatusCode(), 200);
+  CHECK_EQ(sim.payloadBytes(), strlen(URL) + 1000);
+}
+
+TEST(shortBodyWaitsForTheModuleToDropTheUpload) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.setInputTimeout(150, "\r\n+CME ERROR: 702\r\n");
+  ShortSource source = { 1000, 0 };
+  String response;
+
+  CHECK(modem.httpPostStream(URL, 1000, shortSource, &source, response));   // Primes the cache
+
+  source.given = 0;
+  source.supply = 300;
+  uint32_t start = millis();
+  CHECK(!modem.httpPostStream(URL, 1000, shortSource, &source, response));
+  uint32_t elapsed = millis() - start;
+  CHECK(modem.getLastError() == ErrorCode::HTTP_POST_DATA_WRITE_FAILED);
+  CHECK(elapsed >= 150);                         // Nothing was padded...
+  CHECK(elapsed < 1000);                         // ...and the error ended the wait
+  uint32_t saved = modem.httpRoundTripsSaved();
+
+  // The module is in command mode again: the next command is a command, not
+  // body bytes, and the configuration is sent again
+  uint32_t commands = sim.commands();
+  CHECK(modem.sendAT("AT"));
+  CHECK_EQ(sim.commands(), commands + 1);
+  CHECK(sim.lastCommand() == "AT");
+
+  source.given = 0;
+  source.supply = 1000;
+  CHECK(modem.httpPostStream(URL, 1000, shortSource, &source, response));
+  CHECK_EQ(modem.httpRoundTripsSaved(), saved);
+}
+
+TEST(repeatedRequestsSkipKnownConfiguration) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.setHttpBody("{\"ok\":true}");
+  String response;
+
+  CHECK(modem.httpGet(URL, response));
+  CHECK(response == "{\"ok\":true}");
+  uint32_t commands = sim.commands();
+  CHECK(modem.httpGet(URL, response));
+  CHECK_EQ(sim.commands() - commands, 2);        // AT+QHTTPGET, AT+QHTTPREAD
+  CHECK_EQ(modem.httpRoundTripsSaved(), 3);      // contextid, requestheader, URL
+}
+
+TEST(batchCountsSkippedRequestsApart) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.addDataRule("AT+QHTTPPOST=", 0, "\r\nCONNECT\r\n", "\r\nOK\r\n", "\r\n+QHTTPPOST: 0,200,{len}\r\n", 20);
+  HttpSession session(modem);
+  HttpBatchEntry entries[6];
+  HttpBatchResult result;
+
+  CHECK(session.postBatch(URL, 6, everyThirdSkipped, nullptr, result, entries));
+  CHECK_EQ(result.requested, 6);
+  CHECK_EQ(result.succeeded, 4);
+  CHECK_EQ(result.skipped, 2);
+  CHECK_EQ(result.readsSkipped, 4);
+  CHECK_EQ(entries[2].status, 0);
+  CHECK_EQ(entries[3].status, 200);
+  CHECK(result.minLatencyMs >= 20);               // Skips don't pull the figures down
+  CHECK(result.avgLatencyMs >= 20);
+  CHECK_EQ(session.requests(), 4);
+  CHECK_EQ(session.roundTripsSaved(), 3 * 3);      // Config only, not the reads
+  CHECK_EQ(modem.httpRoundTripsSaved(), 3 * 3);
+}
+
+TEST(sessionContextsStayWithTheSession) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.setHttpBody("{\"ok\":true}");
+  HttpSession session(modem, 2, 3);
+  String response;
+
+  CHECK(session.get(URL, response));
+  CHECK(response == "{\"ok\":true}");
+  CHECK_EQ(modem.httpContextId(), 1);
+  CHECK_EQ(modem.httpSslContextId(), 1);
+
+  // The modem's own request switches the module back to context 1
+  uint32_t commands = sim.commands();
+  CHECK(modem.httpGet(URL, response));
+  CHECK_EQ(sim.commands() - commands, 3);        // contextid, AT+QHTTPGET, AT+QHTTPREAD
+  commands = sim.commands();
+  CHECK(session.get(URL, response));
+  CHECK_EQ(sim.commands() - commands, 3);
+  CHECK_EQ(session.requests(), 2);
+}
+
+TEST(postInStepsTakesExactlyTheAnnouncedBody) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.setInputTimeout(150, "\r\n+CME ERROR: 702\r\n");
+  uint8_t body[25];
+  memset(body, 'b', sizeof(body));
+  String response;
+
+  CHECK(modem.httpPostBegin(URL, 10));
+  CHECK_EQ(modem.httpPostWrite(body, sizeof(body)), 10u);
+  CHECK_EQ(modem.httpPostWrite(body, 1), 0u);
+  CHECK(modem.httpPostEnd(&response));
+  CHECK_EQ(modem.httpStatusCode(), 200);
+  CHECK_EQ(sim.payloadBytes(), strlen(URL) + 10);
+
+  // A short body is not padded; the module drops it
+  CHECK(modem.httpPostBegin(URL, 10));
+  CHECK_EQ(modem.httpPostWrite(body, 4), 4u);
+  CHECK(!modem.httpPostEnd());
+  CHECK(modem.getLastError() == ErrorCode::HTTP_POST_DATA_WRITE_FAILED);
+  CHECK(modem.sendAT("AT"));
+}
+
+TEST(batchReadsResponsesOnTheSessionContext) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.setHttpBody("ack");
+  HttpSession session(modem, 2);
+  const String bodies[] = { "{\"a\":1}", "{\"a\":2}", "{\"a\":3}" };
+  HttpBatchEntry entries[3];
+  HttpBatchResult result;
+  size_t before = sim.payloadBytes();
+
+  CHECK(session.postBatch(URL, bodies, 3, result, entries, true));
+  CHECK_EQ(result.succeeded, 3);
+  CHECK_EQ(result.readsSkipped, 0);
+  CHECK_EQ(entries[2].status, 200);
+  CHECK_EQ(sim.payloadBytes() - before, strlen(URL) + 3 * bodies[0].length());
+  CHECK(sim.lastCommand().startsWith("AT+QHTTPREAD"));
+  CHECK_EQ(modem.httpContextId(), 1);
+
+  // The module still holds context 2, so the session's next batch skips it
+  uint32_t saved = session.roundTripsSaved();
+  CHECK(session.postBatch(URL, bodies, 1, result));
+  CHECK_EQ(session.roundTripsSaved() - saved, 3);  // contextid, requestheader, URL
+}
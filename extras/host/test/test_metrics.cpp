@@ -0,0 +1,64 @@
+// Per-command metrics (built with EC200U_ENABLE_METRICS): one call per
+// AT+QISEND frame, timed from the command to its SEND OK.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+int openSocket(QuectelEC200U &modem, int socketId) {
+  int id = modem.socketOpen("example.com", 80, socketId);
+  CHECK_EQ(id, socketId);
+  CHECK(modem.socketWaitConnected(id, 500));
+  return id;
+}
+
+}  // namespace
+
+TEST(pipelinedFramesAreTimedToTheirSendOk) {
+  EC200USimulator sim(921600, 20);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  static uint8_t data[3 * SOCKET_SEND_MAX];
+  memset(data, 0x5a, sizeof(data));
+  modem.resetMetrics();
+
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  const ATMetrics *row = modem.findMetrics("AT+QISEND");
+  CHECK(row != nullptr);
+  if (row == nullptr) {
+    return;
+  }
+  CHECK_EQ(row->calls, 3u);
+  CHECK_EQ(row->failures, 0u);
+  CHECK_EQ(row->timeouts, 0u);
+  // The first frame waits for its prompt and then its SEND OK, 20 ms each
+  CHECK(row->maxLatencyMs >= 40);
+  CHECK(row->totalLatencyMs <= modem.sendStats().elapsedMs);
+  CHECK(row->bytesSent >= sizeof(data));
+}
+
+TEST(sendFailCountsAsAFailedCall) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  uint8_t data[64];
+  memset(data, 0, sizeof(data));
+  sim.addDataRule("AT+QISEND=", 1, "> ", "\r\nSEND FAIL\r\n");
+  modem.resetMetrics();
+
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), 0u);
+  const ATMetrics *row = modem.findMetrics("AT+QISEND");
+  CHECK(row != nullptr);
+  if (row == nullptr) {
+    return;
+  }
+  CHECK_EQ(row->calls, 1u);
+  CHECK_EQ(row->failures, 1u);
+
+  // The next command gets a row of its own
+  CHECK(modem.sendAT("AT+CSQ"));
+  CHECK_EQ(row->calls, 1u);
+  CHECK(modem.findMetrics("AT+CSQ") != nullptr);
+}
@@ -0,0 +1,140 @@
+// MQTT: message handlers and publish results run from poll(), never from a
+// URC that arrives in the middle of another command's response.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+struct Received {
+  QuectelEC200U *modem;
+  int calls;
+  String topic;
+  String payload;
+  bool commandOk;       // An AT command issued from the handler
+};
+
+void onMessage(int client, const char *topic, const uint8_t *payload, size_t length, void *ctx) {
+  (void)client;
+  Received *r = static_cast<Received *>(ctx);
+  r->calls++;
+  r->topic = topic;
+  r->payload = String();
+  r->payload.concat((const char *)payload, length);
+  r->commandOk = r->modem->sendAT("AT+CSQ");
+}
+
+bool connect(QuectelEC200U &modem) {
+  MqttOptions options;
+  return modem.mqttConnect(0, "broker.example.com", 1883, options);
+}
+
+struct Published {
+  QuectelEC200U *modem;
+  int calls;
+  bool acked;
+  int republished;      // Message id of a publish issued from the callback
+};
+
+void onPublished(int client, uint16_t msgId, bool acked, uint32_t latencyMs, void *ctx) {
+  (void)msgId;
+  (void)latencyMs;
+  Published *p = static_cast<Published *>(ctx);
+  p->calls++;
+  p->acked = acked;
+  if (p->calls == 1) {
+    p->republished = p->modem->mqttPublishAsync(client, "sensors/a", "again", 1);
+  }
+}
+
+}  // namespace
+
+TEST(messageArrivingMidCommandWaitsForPoll) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  CHECK(connect(modem));
+  Received got = { &modem, 0, String(), String(), false };
+  CHECK(modem.mqttSubscribe(0, "sensors/+", 0, onMessage, &got));
+
+  sim.addRule("AT+SLOW", "\r\nOK\r\n", 40);
+  sim.emit("\r\n+QMTRECV: 0,0,\"sensors/a\",5,\"hello\"\r\n", 10);
+  CHECK(modem.sendAT("AT+SLOW"));
+  CHECK_EQ(got.calls, 0);
+
+  modem.poll();
+  CHECK_EQ(got.calls, 1);
+  CHECK(got.topic == "sensors/a");
+  CHECK(got.payload == "hello");
+  CHECK(got.commandOk);
+  CHECK(sim.lastCommand() == "AT+CSQ");
+}
+
+TEST(messagesKeepTheirOrder) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  CHECK(connect(modem));
+  Received got = { &modem, 0, String(), String(), false };
+  CHECK(modem.mqttSubscribe(0, "sensors/#", 0, onMessage, &got));
+
+  sim.addRule("AT+SLOW", "\r\nOK\r\n", 40);
+  sim.emit("\r\n+QMTRECV: 0,0,\"sensors/a\",1,\"1\"\r\n", 5);
+  sim.emit("\r\n+QMTRECV: 0,0,\"sensors/b\",1,\"2\"\r\n", 10);
+  CHECK(modem.sendAT("AT+SLOW"));
+  modem.poll();
+  CHECK_EQ(got.calls, 2);
+  CHECK(got.topic == "sensors/b");
+  CHECK(got.payload == "2");
+}
+
+TEST(publishResultWaitsForPoll) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  CHECK(connect(modem));
+  Published done = { &modem, 0, false, -1 };
+  modem.onMqttPublished(onPublished, &done);
+
+  int msgId = modem.mqttPublishAsync(0, "sensors/a", "first", 1);
+  CHECK(msgId > 0);
+  CHECK_EQ(modem.mqttInFlight(0), 1);
+
+  // The broker's +QMTPUB (50 ms) lands in the middle of this command
+  sim.addRule("AT+SLOW", "\r\nOK\r\n", 100);
+  CHECK(modem.sendAT("AT+SLOW"));
+  CHECK_EQ(done.calls, 0);
+  CHECK_EQ(modem.mqttInFlight(0), 0);
+
+  modem.poll();
+  CHECK_EQ(done.calls, 1);
+  CHECK(done.acked);
+  CHECK(done.republished > msgId);
+  CHECK_EQ(modem.mqttInFlight(0), 1);
+
+  uint32_t start = millis();
+  while (done.calls < 2 && millis() - start < 1000) {
+    modem.poll();
+  }
+  CHECK_EQ(done.calls, 2);
+  CHECK_EQ(modem.mqttInFlight(0), 0);
+}
+
+TEST(longMessageArrivesCutShort) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  CHECK(connect(modem));
+  Received got = { &modem, 0, String(), String(), false };
+  CHECK(modem.mqttSubscribe(0, "sensors/+", 0, onMessage, &got));
+
+  // 200 bytes of payload make the URC line longer than URC_LINE_MAX
+  String payload;
+  for (int i = 0; i < 200; i++) {
+    payload += (char)('a' + i % 26);
+  }
+  sim.emit(("\r\n+QMTRECV: 0,0,\"sensors/a\",200,\"" + payload + "\"\r\n").c_str(), 5);
+  delay(20);
+  modem.poll();
+  CHECK_EQ(got.calls, 1);
+  CHECK(got.topic == "sensors/a");
+  CHECK(got.payload.length() > 100);
+  CHECK(payload.startsWith(got.payload));
+}
@@ -0,0 +1,203 @@
+// OfflineQueue on an in-memory QueueStore: order across segments, records
+// torn by a reset during push() and resets while a drained segment is removed.
+#include <OfflineQueue.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "HostTest.h"
+
+namespace {
+
+class MemoryStore : public QueueStore {
+  public:
+    std::map<std::string, std::string> files;
+    int writesLeft = -1;      // Writes until a simulated reset; later ones are lost
+
+    bool append(const char *name, const uint8_t *data, size_t length) override {
+      if (!_write()) {
+        return false;
+      }
+      files[name].append((const char *)data, length);
+      return true;
+    }
+    int read(const char *name, uint32_t offset, uint8_t *buffer, size_t length) override {
+      auto it = files.find(name);
+      if (it == files.end()) {
+        return -1;
+      }
+      if (offset >= it->second.size()) {
+        return 0;
+      }
+      size_t n = std::min(length, it->second.size() - offset);
+      memcpy(buffer, it->second.data() + offset, n);
+      return (int)n;
+    }
+    bool replace(const char *name, const uint8_t *data, size_t length) override {
+      if (!_write()) {
+        return false;
+      }
+      files[name].assign((const char *)data, length);
+      return true;
+    }
+    bool remove(const char *name) override {
+      return _write() && files.erase(name) > 0;
+    }
+    long size(const char *name) override {
+      auto it = files.find(name);
+      return it == files.end() ? -1 : (long)it->second.size();
+    }
+
+  private:
+    bool _write() {
+      if (writesLeft == 0) {
+        return false;
+      }
+      if (writesLeft > 0) {
+        writesLeft--;
+      }
+      return true;
+    }
+};
+
+bool collect(uint8_t tag, const uint8_t *data, size_t length, void *ctx) {
+  (void)tag;
+  static_cast<std::vector<std::string> *>(ctx)->push_back(std::string((const char *)data, length));
+  return true;
+}
+
+// The stored form of a record holding 'text'
+std::string record(const char *text) {
+  MemoryStore scratch;
+  OfflineQueue queue(scratch, "s");
+  queue.begin();
+  queue.push(text);
+  return scratch.files["s_0.q"];
+}
+
+// What a reset halfway through pushing "torn-record" leaves behind
+std::string tornRecord() {
+  return record("torn-record").substr(0, 9);
+}
+
+}  // namespace
+
+TEST(deliversInOrderAcrossSegments) {
+  MemoryStore store;
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  char record[600];
+  memset(record, 'r', sizeof(record));
+  for (int i = 0; i < 60; i++) {
+    record[0] = (char)('A' + i % 26);
+    CHECK(queue.push((const uint8_t *)record, sizeof(record)));
+  }
+  CHECK(queue.segments() > 1);
+
+  std::vector<std::string> got;
+  while (!queue.empty() && queue.flush(collect, &got) > 0) {
+  }
+  CHECK(queue.empty());
+  CHECK_EQ(got.size(), 60);
+  for (size_t i = 0; i < got.size(); i++) {
+    CHECK_EQ(got[i][0], (char)('A' + i % 26));
+  }
+  CHECK_EQ(store.files.count("q_0.q"), 0);
+}
+
+TEST(tornTailStartsANewSegment) {
+  MemoryStore store;
+  store.files["q_0.q"] = record("one") + record("two") + tornRecord();
+
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  CHECK_EQ(queue.segments(), 2);
+  CHECK(queue.push("three"));
+  CHECK(store.files["q_1.q"] == record("three"));
+
+  std::vector<std::string> got;
+  CHECK_EQ(queue.flush(collect, &got), 3);
+  CHECK(queue.empty());
+  CHECK_EQ(got.size(), 3);
+  CHECK(got[0] == "one");
+  CHECK(got[1] == "two");
+  CHECK(got[2] == "three");
+}
+
+TEST(intactTailIsKept) {
+  MemoryStore store;
+  store.files["q_0.q"] = record("one");
+
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  CHECK_EQ(queue.segments(), 1);
+  CHECK(queue.push("two"));
+  CHECK_EQ(store.files.count("q_1.q"), 0);
+}
+
+TEST(flushResyncsAfterDamagedRecords) {
+  // Records appended behind a torn one, and a damaged payload byte
+  MemoryStore store;
+  std::string damaged = record("after-2");
+  damaged[7] ^= 0x40;
+  store.files["q_0.q"] = record("before") + tornRecord() + record("after-1") + damaged + record("after-3");
+
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  std::vector<std::string> got;
+  CHECK_EQ(queue.flush(collect, &got), 3);
+  CHECK(queue.empty());
+  CHECK_EQ(got.size(), 3);
+  CHECK(got[0] == "before");
+  CHECK(got[1] == "after-1");
+  CHECK(got[2] == "after-3");
+}
+
+TEST(resetWhileRemovingTheDrainedTailLosesNothing) {
+  MemoryStore store;
+  {
+    OfflineQueue queue(store, "q");
+    CHECK(queue.begin());
+    CHECK(queue.push("one"));
+    CHECK(queue.push("two"));
+    std::vector<std::string> got;
+    store.writesLeft = 1;                        // Reset after one more write
+    CHECK_EQ(queue.flush(collect, &got), 2);
+  }
+  store.writesLeft = -1;
+
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  CHECK(queue.push("three"));
+  std::vector<std::string> got;
+  while (!queue.empty() && queue.flush(collect, &got) > 0) {
+  }
+  CHECK(queue.empty());
+  CHECK(!got.empty() && got.back() == "three");  // Earlier ones may come again
+}
+
+TEST(staleHeadOffsetIsClamped) {
+  // The index of a reset between removing the drained segment and saving
+  MemoryStore store;
+  {
+    OfflineQueue queue(store, "q");
+    CHECK(queue.begin());
+    CHECK(queue.push("one"));
+    CHECK(queue.push("two"));
+    std::vector<std::string> got;
+    CHECK_EQ(queue.flush(collect, &got), 2);
+  }
+  std::string index = store.files["q.idx"];
+  index[8] = 16;
+  store.files["q.idx"] = index;
+
+  OfflineQueue queue(store, "q");
+  CHECK(queue.begin());
+  CHECK(queue.empty());
+  CHECK(queue.push("three"));
+  std::vector<std::string> got;
+  CHECK_EQ(queue.flush(collect, &got), 1);
+  CHECK_EQ(got.size(), 1);
+  CHECK(got[0] == "three");
+}
@@ -0,0 +1,406 @@
+// Socket manager: TCP listeners and their accept queue, the URC table, slots
+// already in use, binary reads and writes, large writes split into pipelined
+// AT+QISEND frames, UDP datagrams with per-packet addresses, TLS sockets on
+// AT+QSSLSEND/AT+QSSLRECV, and NO CARRIER in transparent mode.
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+#include <TransparentSocket.h>
+
+#include "HostTest.h"
+
+namespace {
+
+struct Accepted {
+  QuectelEC200U *modem;
+  int calls;
+  int listener;
+  int socketId;
+  String ip;
+  uint16_t port;
+  bool commandOk;       // An AT command issued from the callback
+};
+
+void onAccept(int listenerId, int socketId, const char *remoteIp, uint16_t remotePort, void *ctx) {
+  Accepted *a = static_cast<Accepted *>(ctx);
+  a->calls++;
+  a->listener = listenerId;
+  a->socketId = socketId;
+  a->ip = remoteIp;
+  a->port = remotePort;
+  a->commandOk = a->modem->sendAT("AT+CSQ");
+}
+
+void countLine(const char *urc, void *ctx) {
+  (void)urc;
+  (*static_cast<int *>(ctx))++;
+}
+
+// A connected TCP socket in 'accessMode'
+int openSocket(QuectelEC200U &modem, int socketId, int accessMode = SOCKET_ACCESS_BUFFER) {
+  int id = modem.socketOpen("example.com", 80, socketId, 1, accessMode);
+  CHECK_EQ(id, socketId);
+  CHECK(modem.socketWaitConnected(id, 500));
+  return id;
+}
+
+void fillPattern(uint8_t *data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    data[i] = (uint8_t)(i * 7);
+  }
+}
+
+const char *const APP_PREFIXES[] = { "RING", "+CMTI:", "+QIURC: \"pdpdeact\"", "+A1", "+A2", "+A3", "+A4", "+A5", "+A6" };
+
+}  // namespace
+
+TEST(acceptQueueWithoutCallback) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int listener = modem.tcpListen(8080, 11);
+  CHECK_EQ(listener, 11);
+
+  sim.emit("\r\n+QIURC: \"incoming\",2,11,\"10.0.0.9\",40000\r\n");
+  char ip[16];
+  uint16_t port = 0;
+  uint32_t start = millis();
+  int id = -1;
+  while (id < 0 && millis() - start < 500) {
+    id = modem.socketAccept(listener, ip, sizeof(ip), &port);
+  }
+  CHECK_EQ(id, 2);
+  CHECK(strcmp(ip, "10.0.0.9") == 0);
+  CHECK_EQ(port, 40000);
+  CHECK(modem.socketState(2) == SOCKET_CONNECTED);
+  CHECK_EQ(modem.socketAccept(listener), -1);
+}
+
+TEST(acceptCallbackRunsFromPoll) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  Accepted got = { &modem, 0, -1, -1, String(), 0, false };
+  modem.onSocketAccept(onAccept, &got);
+  int listener = modem.tcpListen(8080, 11);
+  CHECK_EQ(listener, 11);
+
+  // The connection is reported in the middle of this command
+  sim.addRule("AT+SLOW", "\r\nOK\r\n", 40);
+  sim.emit("\r\n+QIURC: \"incoming\",3,11,\"10.0.0.7\",40001\r\n", 10);
+  CHECK(modem.sendAT("AT+SLOW"));
+  CHECK_EQ(got.calls, 0);
+  CHECK(modem.socketState(3) == SOCKET_CONNECTED);
+
+  modem.poll();
+  CHECK_EQ(got.calls, 1);
+  CHECK_EQ(got.listener, 11);
+  CHECK_EQ(got.socketId, 3);
+  CHECK(got.ip == "10.0.0.7");
+  CHECK_EQ(got.port, 40001);
+  CHECK(got.commandOk);
+  CHECK_EQ(modem.socketAccept(listener), -1);     // Handed over, not queued
+}
+
+TEST(applicationHandlersLeaveRoomForTheLibrary) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  CHECK(modem.enableNetworkURCs(true));
+  int hits = 0;
+  for (size_t i = 0; i < MAX_URC_HANDLERS; i++) {
+    CHECK(modem.onURC(APP_PREFIXES[i], countLine, &hits));
+  }
+  CHECK(!modem.onURC(APP_PREFIXES[MAX_URC_HANDLERS], countLine, &hits));
+
+  // The socket and MQTT handlers still get their slots
+  int id = modem.socketOpen("example.com", 80, 0, 1, SOCKET_ACCESS_PUSH);
+  CHECK_EQ(id, 0);
+  CHECK(modem.socketWaitConnected(id, 500));
+  sim.emit("\r\n+QIURC: \"recv\",0,5\r\nhello");
+  uint32_t start = millis();
+  while (modem.socketAvailable(id) < 5 && millis() - start < 500) {
+  }
+  CHECK_EQ(modem.socketAvailable(id), 5);
+  sim.emit("\r\n+QIURC: \"closed\",0\r\n");
+  start = millis();
+  while (modem.socketState(id) == SOCKET_CONNECTED && millis() - start < 500) {
+    modem.poll();
+  }
+  CHECK(modem.socketState(id) == SOCKET_REMOTE_CLOSED);
+
+  MqttOptions options;
+  CHECK(modem.mqttConnect(0, "broker.example.com", 1883, options));
+
+  sim.emit("\r\nRING\r\n");
+  delay(5);
+  modem.poll();
+  CHECK_EQ(hits, 1);
+}
+
+TEST(sslOpenRefusesASocketInUse) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+QSSLOPEN=", "\r\nOK\r\n", EC200U_SIM_DEFAULT_LATENCY, "\r\n+QSSLOPEN: {2},0\r\n", 20);
+  int id = modem.socketOpen("example.com", 80, 2, 1, SOCKET_ACCESS_PUSH);
+  CHECK(modem.socketWaitConnected(id, 500));
+  sim.emit("\r\n+QIURC: \"recv\",2,3\r\nabc");
+  delay(5);
+  modem.poll();
+  uint32_t commands = sim.commands();
+
+  CHECK_EQ(modem.sslOpen("example.com", 443, 1, 2), -1);
+  CHECK_EQ(sim.commands(), commands);
+  CHECK(modem.socketState(2) == SOCKET_CONNECTED);
+  CHECK_EQ(modem.socketRxCount(2), 3);
+
+  // A free slot opens as usual
+  int tls = modem.sslOpen("example.com", 443, 1, 3);
+  CHECK_EQ(tls, 3);
+  CHECK(modem.socketWaitConnected(tls, 500));
+}
+
+TEST(socketOpenRefusesASocketInUse) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = modem.socketOpen("example.com", 80, 1, 1, SOCKET_ACCESS_PUSH);
+  CHECK_EQ(id, 1);
+  CHECK(modem.socketWaitConnected(id, 500));
+  sim.emit("\r\n+QIURC: \"recv\",1,4\r\nlive");
+  delay(5);
+  modem.poll();
+  uint32_t commands = sim.commands();
+
+  CHECK_EQ(modem.socketOpen("example.org", 80, 1), -1);
+  CHECK_EQ(sim.commands(), commands);
+  CHECK(modem.socketState(1) == SOCKET_CONNECTED);
+  CHECK_EQ(modem.socketRxCount(1), 4);
+  CHECK_EQ(modem.socketOpen("example.org", 80), 0);   // First free slot
+}
+
+TEST(largeWriteIsSplitIntoFrames) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  static uint8_t data[2 * SOCKET_SEND_MAX + 80];
+  fillPattern(data, sizeof(data));
+  size_t before = sim.payloadBytes();
+
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  CHECK_EQ(sim.payloadBytes() - before, sizeof(data));
+  const SocketSendStats &stats = modem.sendStats();
+  CHECK_EQ(stats.bytes, (uint32_t)sizeof(data));
+  CHECK_EQ(stats.frames, 3);
+  CHECK_EQ(stats.failed, 0);
+  CHECK(sim.lastCommand().startsWith("AT+QISEND=0,80"));
+}
+
+TEST(pipeliningSavesARoundTripPerFrame) {
+  EC200USimulator sim(921600, 20);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  static uint8_t data[5 * SOCKET_SEND_MAX];
+  fillPattern(data, sizeof(data));
+
+  modem.setSendPipelining(false);
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  uint32_t serial = modem.sendStats().elapsedMs;
+  modem.setSendPipelining(true);
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  uint32_t pipelined = modem.sendStats().elapsedMs;
+  CHECK_EQ(modem.sendStats().frames, 5);
+  // Four of the five prompts no longer cost a 20 ms reply each
+  CHECK(pipelined + 60 < serial);
+}
+
+TEST(sendFailStopsTheWriteInOrder) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  static uint8_t data[2 * SOCKET_SEND_MAX];
+  fillPattern(data, sizeof(data));
+
+  sim.addDataRule("AT+QISEND=", 1, "> ", "\r\nSEND FAIL\r\n");
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), 0u);
+  CHECK_EQ(modem.sendStats().frames, 0);
+  CHECK(modem.sendStats().failed >= 1);
+  CHECK(modem.getLastError() == ErrorCode::TCP_ERROR);
+
+  // No prompt or result is left behind for the next write
+  sim.clearRules();
+  CHECK_EQ(modem.tcpWrite(id, data, 100), 100u);
+  CHECK_EQ(modem.sendStats().frames, 1);
+  CHECK(modem.sendAT("AT"));
+}
+
+TEST(binaryWriteSendsEveryByte) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  // NUL, Ctrl-Z and a result code inside the payload
+  const uint8_t data[] = { 0x00, 0x1a, '\r', '\n', 'O', 'K', '\r', '\n', 0xff, 0x00 };
+  size_t before = sim.payloadBytes();
+
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  CHECK_EQ(sim.payloadBytes() - before, sizeof(data));
+  CHECK(sim.lastCommand().startsWith("AT+QISEND=0,10"));
+  CHECK(modem.sendAT("AT"));
+}
+
+TEST(binaryReadFromAPushSocket) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 4, SOCKET_ACCESS_PUSH);
+  static const uint8_t data[] = { 'O', 'K', '\r', '\n', 0x00, 0xfe, '\r', '\n' };
+  sim.emit("\r\n+QIURC: \"recv\",4,8\r\n");
+  sim.emit(data, sizeof(data));
+
+  uint8_t got[16];
+  CHECK_EQ(modem.tcpRead(id, got, sizeof(got), 500), sizeof(data));
+  CHECK(memcmp(got, data, sizeof(data)) == 0);
+  CHECK_EQ(modem.tcpRead(id, got, sizeof(got), 0), 0u);
+}
+
+TEST(binaryReadStraightFromAQird) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 0);
+  // The reply is split so that the payload can hold NUL bytes
+  static const uint8_t data[] = { 0x00, '\r', '\n', 'E', 'R', 'R', 'O', 'R', '\r', '\n', 0x80, 0x00 };
+  sim.addRule("AT+QIRD=", "\r\n+QIRD: 12\r\n");
+  sim.emit(data, sizeof(data), 20);
+  sim.emit("\r\n\r\nOK\r\n", 25);
+
+  uint8_t got[SOCKET_READ_MAX];
+  CHECK_EQ(modem.tcpRead(id, got, sizeof(got), 500), sizeof(data));
+  CHECK(memcmp(got, data, sizeof(data)) == 0);
+  CHECK(sim.lastCommand().startsWith("AT+QIRD=0,1500"));
+  CHECK_EQ(modem.socketRxCount(id), 0);
+}
+
+TEST(udpSendToAddressesEachDatagram) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int service = modem.udpOpen(5000, 1);
+  CHECK_EQ(service, 1);
+  const uint8_t data[] = { 'p', 'i', 0x00, 'g' };
+
+  CHECK(modem.udpSendTo(service, "10.0.0.5", 7000, data, sizeof(data)));
+  CHECK(sim.lastCommand() == "AT+QISEND=1,4,\"10.0.0.5\",7000");
+  CHECK(modem.udpSendTo(service, "192.168.1.20", 53, data, 2));
+  CHECK(sim.lastCommand() == "AT+QISEND=1,2,\"192.168.1.20\",53");
+
+  // A connected UDP socket sends to its peer without naming it
+  int client = modem.udpConnect("10.0.0.9", 9000, 2);
+  CHECK_EQ(client, 2);
+  CHECK(modem.udpSend(client, data, sizeof(data)));
+  CHECK(sim.lastCommand() == "AT+QISEND=2,4");
+
+  // One datagram per AT+QISEND: nothing is split
+  static uint8_t big[SOCKET_SEND_MAX + 1];
+  uint32_t commands = sim.commands();
+  CHECK(!modem.udpSendTo(service, "10.0.0.5", 7000, big, sizeof(big)));
+  CHECK_EQ(sim.commands(), commands);
+}
+
+TEST(udpReceiveReportsEachSender) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int service = modem.udpOpen(5000, 1);
+  CHECK_EQ(service, 1);
+  sim.addRule("AT+QIRD=", "\r\n+QIRD: 5,\"10.0.0.7\",4001\r\nhello\r\n\r\nOK\r\n");
+  sim.emit("\r\n+QIURC: \"recv\",1\r\n");
+
+  uint8_t buf[64];
+  char ip[16];
+  uint16_t port = 0;
+  CHECK_EQ(modem.udpReceive(service, buf, sizeof(buf), ip, sizeof(ip), &port, 500), 5);
+  CHECK(memcmp(buf, "hello", 5) == 0);
+  CHECK(strcmp(ip, "10.0.0.7") == 0);
+  CHECK_EQ(port, 4001);
+
+  // The next datagram keeps its own boundary and sender
+  sim.addRule("AT+QIRD=", "\r\n+QIRD: 3,\"10.0.0.8\",4002\r\nabc\r\n\r\nOK\r\n");
+  CHECK_EQ(modem.udpReceive(service, buf, sizeof(buf), ip, sizeof(ip), &port, 500), 3);
+  CHECK(memcmp(buf, "abc", 3) == 0);
+  CHECK(strcmp(ip, "10.0.0.8") == 0);
+  CHECK_EQ(port, 4002);
+
+  sim.addRule("AT+QIRD=", "\r\n+QIRD: 0\r\n\r\nOK\r\n");
+  CHECK_EQ(modem.udpReceive(service, buf, sizeof(buf), ip, sizeof(ip), &port, 50), 0);
+}
+
+TEST(tlsSocketUsesTheSslCommands) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  sim.addRule("AT+QSSLOPEN=", "\r\nOK\r\n", EC200U_SIM_DEFAULT_LATENCY, "\r\n+QSSLOPEN: {2},0\r\n", 20);
+  sim.addDataRule("AT+QSSLSEND=", 1, "> ", "\r\nSEND OK\r\n");
+  sim.addRule("AT+QSSLRECV=", "\r\n+QSSLRECV: 4\r\ntls!\r\n\r\nOK\r\n");
+  // Plain socket commands must not reach a TLS connection
+  sim.addRule("AT+QISEND=", "\r\nERROR\r\n");
+  sim.addRule("AT+QIRD=", "\r\nERROR\r\n");
+  int id = modem.sslOpen("example.com", 443, 1, 3);
+  CHECK_EQ(id, 3);
+  CHECK(modem.socketWaitConnected(id, 500));
+
+  static uint8_t data[SOCKET_SEND_MAX + 540];
+  fillPattern(data, sizeof(data));
+  CHECK_EQ(modem.tcpWrite(id, data, sizeof(data)), sizeof(data));
+  CHECK_EQ(modem.sendStats().frames, 2);
+  CHECK(sim.lastCommand().startsWith("AT+QSSLSEND=3,540"));
+
+  sim.emit("\r\n+QSSLURC: \"recv\",3\r\n");
+  uint8_t got[16];
+  CHECK_EQ(modem.tcpRead(id, got, sizeof(got), 500), 4u);
+  CHECK(memcmp(got, "tls!", 4) == 0);
+  CHECK(sim.lastCommand().startsWith("AT+QSSLRECV=3,"));
+
+  sim.emit("\r\n+QSSLURC: \"closed\",3\r\n");
+  uint32_t start = millis();
+  while (modem.socketState(id) == SOCKET_CONNECTED && millis() - start < 500) {
+    modem.poll();
+  }
+  CHECK(modem.socketState(id) == SOCKET_REMOTE_CLOSED);
+  CHECK(modem.socketClose(id));
+  CHECK(sim.lastCommand() == "AT+QSSLCLOSE=3,10");
+
+  // The same connectID reopened as plain TCP is back on AT+QISEND
+  sim.clearRules();
+  CHECK_EQ(openSocket(modem, 3), 3);
+  CHECK_EQ(modem.tcpWrite(3, data, 10), 10u);
+  CHECK(sim.lastCommand().startsWith("AT+QISEND=3,10"));
+}
+
+TEST(noCarrierEndsTransparentMode) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int id = openSocket(modem, 2);
+  TransparentSocket stream(modem);
+  CHECK(stream.begin(id));
+  CHECK(stream.active());
+  CHECK(sim.transparent());
+  CHECK(!modem.sendAT("AT"));   // The UART carries socket data
+
+  size_t before = sim.payloadBytes();
+  const uint8_t data[] = { 'u', 'p', 0x00, '\r', '\n' };
+  CHECK_EQ(stream.write(data, sizeof(data)), sizeof(data));
+  stream.flush();
+  CHECK_EQ(sim.payloadBytes() - before, sizeof(data));
+
+  sim.emit("peer");
+  sim.dropCarrier(10);
+  String got;
+  uint32_t start = millis();
+  while (stream.active() && millis() - start < 500) {
+    int c = stream.read();
+    if (c >= 0) {
+      got += (char)c;
+    }
+  }
+  CHECK(!stream.active());
+  CHECK(got == "peer\r\nNO CARRIER\r\n");
+  CHECK_EQ(modem.transparentSocket(), -1);
+  CHECK(modem.socketState(id) == SOCKET_REMOTE_CLOSED);
+  CHECK(!stream.connected());
+  CHECK_EQ(stream.write(data, sizeof(data)), 0u);
+
+  // Back in command mode without an escape
+  CHECK(stream.end());
+  CHECK(modem.sendAT("AT"));
+}
@@ -0,0 +1,156 @@
+// ConnectionSupervisor: registration loss and recovery, PDP deactivation,
+// backoff growth and its cap, and watched sockets that do not come back.
+#include <ConnectionSupervisor.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+struct Trace {
+  int restores;
+  int backoffs;
+  uint32_t retry[8];
+  ConnectionSupervisor *sup;
+};
+
+void onState(LinkState state, void *ctx) {
+  Trace *t = static_cast<Trace *>(ctx);
+  if (state == LINK_BACKOFF && t->backoffs < 8) {
+    t->retry[t->backoffs++] = t->sup->retryIn();
+  }
+}
+
+bool restore(QuectelEC200U &modem, void *ctx) {
+  (void)modem;
+  static_cast<Trace *>(ctx)->restores++;
+  return true;
+}
+
+void countLine(const char *urc, void *ctx) {
+  (void)urc;
+  (*static_cast<int *>(ctx))++;
+}
+
+bool runUntil(ConnectionSupervisor &sup, LinkState state, uint32_t limitMs) {
+  uint32_t start = millis();
+  while (millis() - start < limitMs) {
+    sup.loop();
+    if (sup.state() == state) {
+      return true;
+    }
+    delay(1);
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(registrationLostAndRecovered) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  ConnectionSupervisor sup(modem);
+  Trace t = { 0, 0, {}, &sup };
+  sup.addSession(restore, &t);
+  CHECK(sup.begin());
+  CHECK(runUntil(sup, LINK_UP, 1000));
+  CHECK_EQ(t.restores, 1);
+  CHECK_EQ(sup.recoveries(), 0u);
+
+  // Every domain has to drop before the module counts as unregistered
+  sim.emit("\r\n+CREG: 2\r\n\r\n+CGREG: 2\r\n\r\n+CEREG: 2\r\n");
+  CHECK(runUntil(sup, LINK_WAIT_NETWORK, 500));
+  CHECK(!modem.isNetworkReady());
+  // Nothing happens until the module registers again
+  CHECK(!runUntil(sup, LINK_ATTACHING, 100));
+
+  sim.emit("\r\n+CEREG: 5\r\n");
+  CHECK(runUntil(sup, LINK_UP, 1000));
+  CHECK_EQ(sup.recoveries(), 1u);
+  CHECK_EQ(sup.attempt(), 0);
+  CHECK_EQ(t.restores, 2);
+}
+
+TEST(pdpDeactivationReactivatesTheContext) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  ConnectionSupervisor sup(modem);
+  sup.setBackoff(20, 80);
+  int activations = 0;
+  CHECK(modem.onURC("+MARK", countLine, &activations));
+  CHECK(sup.begin());
+  CHECK(runUntil(sup, LINK_UP, 1000));
+
+  // From now on the context reads as inactive, and AT+QIACT= leaves a mark
+  sim.addRule("AT+QIACT?", "\r\nOK\r\n");
+  sim.addRule("AT+QIACT=", "\r\nOK\r\n", EC200U_SIM_DEFAULT_LATENCY, "\r\n+MARK\r\n", 5);
+  sim.emit("\r\n+QIURC: \"pdpdeact\",1\r\n");
+  CHECK(runUntil(sup, LINK_BACKOFF, 500));
+  CHECK(modem.networkState().pdpLost & 1);
+  CHECK(runUntil(sup, LINK_ACTIVATING, 500));
+  CHECK(runUntil(sup, LINK_UP, 1000));
+  sup.loop();
+  CHECK_EQ(modem.networkState().pdpLost, 0);
+  CHECK(sim.lastCommand().startsWith("AT+QIACT=1"));
+  uint32_t start = millis();
+  while (activations == 0 && millis() - start < 200) {
+    sup.loop();
+  }
+  CHECK_EQ(activations, 1);
+  CHECK_EQ(sup.recoveries(), 1u);
+}
+
+TEST(backoffGrowsAndIsCapped) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  ConnectionSupervisor sup(modem);
+  Trace t = { 0, 0, {}, &sup };
+  sup.setBackoff(20, 80);
+  sup.onStateChange(onState, &t);
+  sim.addRule("AT+CGATT=1", "\r\nERROR\r\n");
+  CHECK(sup.begin());
+
+  uint32_t start = millis();
+  while (t.backoffs < 5 && millis() - start < 2000) {
+    sup.loop();
+    delay(1);
+  }
+  CHECK_EQ(t.backoffs, 5);
+  // Each wait is drawn from the upper half of min << attempt, up to the cap
+  const uint32_t ceiling[] = { 20, 40, 80, 80, 80 };
+  for (int i = 0; i < 5; i++) {
+    CHECK(t.retry[i] >= ceiling[i] / 2 - 1);
+    CHECK(t.retry[i] <= ceiling[i]);
+  }
+  CHECK(sup.attempt() >= 5);
+  CHECK(sup.failures() >= 5u);
+  CHECK(sup.state() != LINK_UP);
+
+  // The first success resets the schedule
+  sim.clearRules();
+  CHECK(runUntil(sup, LINK_UP, 1000));
+  CHECK_EQ(sup.attempt(), 0);
+}
+
+TEST(socketThatNeverOpensFailsTheRestore) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  ConnectionSupervisor sup(modem);
+  sup.setBackoff(20, 80);
+  sup.setSocketTimeout(60);
+  CHECK(sup.watchSocket(0, "example.com", 80));
+  // Accepted, but +QIOPEN never follows
+  sim.addRule("AT+QIOPEN=", "\r\nOK\r\n");
+  CHECK(sup.begin());
+
+  CHECK(runUntil(sup, LINK_RESTORING, 500));
+  uint32_t start = millis();
+  CHECK(runUntil(sup, LINK_BACKOFF, 500));
+  CHECK(millis() - start >= 50);
+  CHECK(modem.socketState(0) == SOCKET_CLOSED);
+  CHECK_EQ(sup.failures(), 1u);
+
+  sim.clearRules();
+  CHECK(runUntil(sup, LINK_UP, 1000));
+  CHECK(modem.socketState(0) == SOCKET_CONNECTED);
+}
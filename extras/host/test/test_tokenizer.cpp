@@ -0,0 +1,201 @@
+// ATTokenizer: final result codes, the data prompt and slices that cross
+// the end of the ring; and the modem's response reader built on it.
+#include <ATTokenizer.h>
+#include <QuectelEC200U.h>
+#include <EC200USimulator.h>
+
+#include "HostTest.h"
+
+namespace {
+
+// Feeds 'text' and returns the last token other than AT_TOKEN_NONE
+ATToken feedAll(ATTokenizer &tok, const char *text) {
+  ATToken last = AT_TOKEN_NONE;
+  for (const char *p = text; *p; p++) {
+    ATToken t = tok.feed(*p);
+    if (t != AT_TOKEN_NONE) {
+      last = t;
+    }
+  }
+  return last;
+}
+
+String lineText(const ATTokenizer &tok) {
+  char buf[64];
+  tok.line().copyTo(buf, sizeof(buf));
+  return String(buf);
+}
+
+void countLine(const char *urc, void *ctx) {
+  (void)urc;
+  (*static_cast<int *>(ctx))++;
+}
+
+}  // namespace
+
+TEST(promptCompletesWithoutLineEnd) {
+  char ring[64];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "\r\n"), AT_TOKEN_NONE);
+  CHECK_EQ(tok.feed('>'), AT_TOKEN_NONE);
+  CHECK_EQ(tok.feed(' '), AT_TOKEN_PROMPT);
+  CHECK(tok.line().equals("> "));
+
+  // Payload echo after the prompt starts a fresh line
+  CHECK_EQ(feedAll(tok, "abc\r\n"), AT_TOKEN_LINE);
+  CHECK(lineText(tok) == "abc");
+
+  // '>' not followed by a space is ordinary text
+  CHECK_EQ(feedAll(tok, ">x\r\n"), AT_TOKEN_LINE);
+}
+
+TEST(errorCodesCarryTheirText) {
+  char ring[64];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "\r\n+CME ERROR: 10\r\n"), AT_TOKEN_CME_ERROR);
+  CHECK(lineText(tok) == "+CME ERROR: 10");
+  CHECK_EQ(feedAll(tok, "\r\n+CMS ERROR: 500\r\n"), AT_TOKEN_CMS_ERROR);
+  CHECK_EQ(feedAll(tok, "\r\nERROR\r\n"), AT_TOKEN_ERROR);
+
+  // Near misses stay information lines
+  CHECK_EQ(feedAll(tok, "+CME ERR\r\n"), AT_TOKEN_LINE);
+  CHECK_EQ(feedAll(tok, "ERRORS\r\n"), AT_TOKEN_LINE);
+  CHECK_EQ(feedAll(tok, "OKAY\r\n"), AT_TOKEN_LINE);
+  CHECK_EQ(feedAll(tok, "OK\r\n"), AT_TOKEN_OK);
+}
+
+TEST(connectWithLength) {
+  char ring[64];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "\r\nCONNECT 1024\r\n"), AT_TOKEN_CONNECT);
+  CHECK(lineText(tok) == "CONNECT 1024");
+  CHECK_EQ(feedAll(tok, "\r\nCONNECT\r\n"), AT_TOKEN_CONNECT);
+  CHECK_EQ(feedAll(tok, "\r\nCONNEC\r\n"), AT_TOKEN_LINE);
+  CHECK_EQ(AT_TOKEN_FINAL_MASK & AT_TOKEN_MASK(AT_TOKEN_CONNECT), 0);
+}
+
+TEST(sendResults) {
+  char ring[64];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "\r\nSEND OK\r\n"), AT_TOKEN_SEND_OK);
+  CHECK_EQ(feedAll(tok, "\r\nSEND FAIL\r\n"), AT_TOKEN_SEND_FAIL);
+  CHECK(lineText(tok) == "SEND FAIL");
+  CHECK(AT_TOKEN_FINAL_MASK & AT_TOKEN_MASK(AT_TOKEN_SEND_FAIL));
+  CHECK_EQ(feedAll(tok, "\r\nSEND FAILURE\r\n"), AT_TOKEN_LINE);
+  CHECK_EQ(feedAll(tok, "\r\nNO CARRIER\r\n"), AT_TOKEN_NO_CARRIER);
+}
+
+TEST(blankLinesAreSkipped) {
+  char ring[32];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "\r\n\r\n\n\r\n"), AT_TOKEN_NONE);
+  CHECK_EQ(tok.line().length(), 0);
+  CHECK_EQ(tok.position(), 7);
+}
+
+TEST(sliceWrapsAroundTheRing) {
+  char ring[16];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "0123456789\r\n"), AT_TOKEN_LINE);   // 12 bytes
+  CHECK_EQ(feedAll(tok, "+QIRD: 8\r\n"), AT_TOKEN_LINE);     // Bytes 12..21
+
+  ATSlice s = tok.line();
+  CHECK_EQ(s.len, 4);
+  CHECK_EQ(s.wrapLen, 4);
+  CHECK_EQ(s.length(), 8);
+  CHECK(s.equals("+QIRD: 8"));
+  CHECK(s.startsWith("+QIRD"));
+  CHECK_EQ(s.indexOf("D: 8"), 4);                         // Match across the wrap
+  CHECK_EQ(s.indexOf("9"), -1);
+  CHECK_EQ(s.at(3), 'R');
+  CHECK_EQ(s.at(4), 'D');
+
+  char out[8];
+  CHECK_EQ(s.copyTo(out, sizeof(out)), 7);                // Truncated, terminated
+  CHECK(strcmp(out, "+QIRD: ") == 0);
+  CHECK_EQ(tok.stored(), 16);
+}
+
+TEST(overlongLineKeepsItsTail) {
+  char ring[8];
+  ATTokenizer tok;
+  tok.begin(ring, sizeof(ring));
+
+  CHECK_EQ(feedAll(tok, "abcdefghijkl\r\n"), AT_TOKEN_LINE);
+  // 14 bytes fed; of the 12-byte line only what is still in the ring remains
+  ATSlice s = tok.line();
+  CHECK_EQ(s.length(), 6);
+  CHECK(s.equals("ghijkl"));
+
+  // A final code is still recognised even though its start was overwritten
+  CHECK_EQ(feedAll(tok, "+CME ERROR: 100\r\n"), AT_TOKEN_CME_ERROR);
+}
+
+TEST(linearBufferCountsDroppedBytes) {
+  char buf[8];
+  ATTokenizer tok;
+  tok.begin(buf, sizeof(buf), false);
+
+  CHECK_EQ(feedAll(tok, "+CSQ: 24,99\r\n\r\nOK\r\n"), AT_TOKEN_OK);
+  CHECK_EQ(tok.stored(), 8);
+  CHECK_EQ(tok.dropped(), 19 - 8);
+  CHECK(tok.contents().equals("+CSQ: 24"));
+
+  tok.reset();
+  CHECK_EQ(tok.dropped(), 0);
+  CHECK_EQ(feedAll(tok, "OK\r\n"), AT_TOKEN_OK);
+  CHECK(tok.line().equals("OK"));
+}
+
+TEST(lineBufferKeepsTheHead) {
+  char line[8];
+  ATTokenizer tok;
+  tok.begin(nullptr, 0);
+  tok.setLineBuffer(line, sizeof(line));
+
+  CHECK_EQ(feedAll(tok, "+QMTRECV: 0,0\r\n"), AT_TOKEN_LINE);
+  CHECK(tok.line().equals("+QMTRECV"));
+  CHECK_EQ(tok.stored(), 0);
+
+  // Short lines come out whole, and final codes are still recognised past the
+  // buffer's end
+  CHECK_EQ(feedAll(tok, "OK\r\n"), AT_TOKEN_OK);
+  CHECK(tok.line().equals("OK"));
+  CHECK_EQ(feedAll(tok, "+CME ERROR: 100\r\n"), AT_TOKEN_CME_ERROR);
+  CHECK(tok.line().startsWith("+CME"));
+}
+
+TEST(longResponseKeepsUrcsAndItsResult) {
+  EC200USimulator sim(921600, 2);
+  QuectelEC200U modem(sim);
+  int hits = 0;
+  CHECK(modem.onURC("+XURC:", countLine, &hits));
+
+  // A 300-byte information line fills the 255-byte response buffer
+  static String reply;
+  reply = "\r\n+LONG: ";
+  for (int i = 0; i < 300; i++) {
+    reply += (char)('a' + i % 26);
+  }
+  reply += "\r\n\r\n+XURC: 1\r\n\r\nOK\r\n";
+  sim.addRule("AT+LONG", reply.c_str());
+
+  CHECK(modem.sendAT("AT+LONG"));
+  CHECK_EQ(hits, 1);
+
+  // An information line containing "OK" does not hide a final ERROR
+  sim.addRule("AT+LOOK", "\r\n+LOOK: OK\r\n\r\nERROR\r\n");
+  CHECK(!modem.sendAT("AT+LOOK"));
+}
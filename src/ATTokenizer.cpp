@@ -0,0 +1,256 @@
+/*
+  ATTokenizer - streaming AT response tokenizer for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "ATTokenizer.h"
+
+namespace {
+
+struct FinalCode {
+  const char *text;
+  uint8_t length;
+  uint8_t token;
+  bool prefix;      // Matches any line starting with 'text'
+};
+
+const FinalCode kFinalCodes[] = {
+  { "OK",          2,  AT_TOKEN_OK,         false },
+  { "ERROR",       5,  AT_TOKEN_ERROR,      false },
+  { "+CME ERROR:", 11, AT_TOKEN_CME_ERROR,  true  },
+  { "+CMS ERROR:", 11, AT_TOKEN_CMS_ERROR,  true  },
+  { "CONNECT",     7,  AT_TOKEN_CONNECT,    true  },
+  { "SEND OK",     7,  AT_TOKEN_SEND_OK,    false },
+  { "SEND FAIL",   9,  AT_TOKEN_SEND_FAIL,  false },
+  { "NO CARRIER",  10, AT_TOKEN_NO_CARRIER, false },
+};
+
+const size_t kFinalCount = sizeof(kFinalCodes) / sizeof(kFinalCodes[0]);
+const uint16_t kAllCandidates = (1U << kFinalCount) - 1;
+
+}  // namespace
+
+// ===== ATSlice =====
+bool ATSlice::startsWith(const char *prefix) const {
+  size_t n = strlen(prefix);
+  if (n > length()) {
+    return false;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (at(i) != prefix[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ATSlice::equals(const char *text) const {
+  return strlen(text) == length() && startsWith(text);
+}
+
+int ATSlice::indexOf(const char *needle) const {
+  size_t n = strlen(needle);
+  size_t total = length();
+  if (n == 0) {
+    return 0;
+  }
+  for (size_t i = 0; i + n <= total; i++) {
+    size_t k = 0;
+    while (k < n && at(i + k) == needle[k]) {
+      k++;
+    }
+    if (k == n) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+size_t ATSlice::copyTo(char *dst, size_t size) const {
+  if (size == 0) {
+    return 0;
+  }
+  size_t n = length();
+  if (n > size - 1) {
+    n = size - 1;
+  }
+  size_t first = n < len ? n : len;
+  memcpy(dst, data, first);
+  if (n > first) {
+    memcpy(dst + first, wrapData, n - first);
+  }
+  dst[n] = '\0';
+  return n;
+}
+
+// ===== ATTokenizer =====
+ATTokenizer::ATTokenizer() {
+  _buf = nullptr;
+  _cap = 0;
+  _wrap = true;
+  _lineBuf = nullptr;
+  _lineCap = 0;
+  reset();
+}
+
+void ATTokenizer::begin(char *buffer, size_t capacity, bool wrap) {
+  _buf = buffer;
+  _cap = capacity;
+  _wrap = wrap;
+  reset();
+}
+
+void ATTokenizer::setLineBuffer(char *buffer, size_t capacity) {
+  _lineBuf = buffer;
+  _lineCap = buffer ? capacity : 0;
+}
+
+void ATTokenizer::reset() {
+  _head = 0;
+  _dropped = 0;
+  _lineStart = 0;
+  _lineLen = 0;
+  _lineFirst = '\0';
+  _lastStart = 0;
+  _lastLen = 0;
+  _candidates = kAllCandidates;
+}
+
+ATToken ATTokenizer::feed(char c) {
+  if (_cap > 0) {
+    if (_wrap) {
+      _buf[_head % _cap] = c;
+    } else if (_head < _cap) {
+      _buf[_head] = c;
+    } else {
+      _dropped++;
+    }
+  }
+  size_t pos = _head++;
+  if (pos - _lineStart < _lineCap) {
+    _lineBuf[pos - _lineStart] = c;
+  }
+
+  if (c == '\n') {
+    return _completeLine();
+  }
+  if (c == '\r') {
+    return AT_TOKEN_NONE;
+  }
+
+  size_t idx = pos - _lineStart;
+  _lineLen = idx + 1;
+  if (idx == 0) {
+    _lineFirst = c;
+  }
+
+  // Narrow down the final result codes this line can still turn into
+  if (_candidates) {
+    for (size_t i = 0; i < kFinalCount; i++) {
+      uint16_t bit = 1U << i;
+      if (!(_candidates & bit)) {
+        continue;
+      }
+      const FinalCode &fc = kFinalCodes[i];
+      if (idx < fc.length) {
+        if (fc.text[idx] != c) {
+          _candidates &= ~bit;
+        }
+      } else if (!fc.prefix) {
+        _candidates &= ~bit;
+      }
+    }
+  }
+
+  // The data prompt is not followed by CR/LF
+  if (idx == 1 && c == ' ' && _lineFirst == '>') {
+    _lastStart = _lineStart;
+    _lastLen = 2;
+    _lineStart = _head;
+    _lineLen = 0;
+    _candidates = kAllCandidates;
+    return AT_TOKEN_PROMPT;
+  }
+  return AT_TOKEN_NONE;
+}
+
+ATToken ATTokenizer::_completeLine() {
+  size_t len = _lineLen;
+  uint16_t candidates = _candidates;
+  size_t start = _lineStart;
+
+  _lineStart = _head;
+  _lineLen = 0;
+  _candidates = kAllCandidates;
+
+  if (len == 0) {
+    return AT_TOKEN_NONE;    // Blank separator line
+  }
+
+  _lastStart = start;
+  _lastLen = len;
+
+  for (size_t i = 0; i < kFinalCount; i++) {
+    if ((candidates & (1U << i)) && len >= kFinalCodes[i].length) {
+      return (ATToken)kFinalCodes[i].token;
+    }
+  }
+  return AT_TOKEN_LINE;
+}
+
+ATSlice ATTokenizer::_slice(size_t start, size_t len) const {
+  ATSlice s = { "", 0, "", 0 };
+  if (_cap == 0) {
+    return s;
+  }
+
+  if (!_wrap) {
+    if (start >= _cap) {
+      return s;
+    }
+    if (start + len > _cap) {
+      len = _cap - start;
+    }
+    s.data = _buf + start;
+    s.len = len;
+    return s;
+  }
+
+  // Only the last '_cap' bytes survive in a ring
+  if (_head - start > _cap) {
+    size_t lost = _head - start - _cap;
+    if (lost >= len) {
+      return s;
+    }
+    start += lost;
+    len -= lost;
+  }
+  size_t offset = start % _cap;
+  s.data = _buf + offset;
+  if (offset + len <= _cap) {
+    s.len = len;
+  } else {
+    s.len = _cap - offset;
+    s.wrapData = _buf;
+    s.wrapLen = len - s.len;
+  }
+  return s;
+}
+
+ATSlice ATTokenizer::line() const {
+  if (_lineBuf) {
+    ATSlice s = { _lineBuf, _lastLen < _lineCap ? _lastLen : _lineCap, "", 0 };
+    return s;
+  }
+  return _slice(_lastStart, _lastLen);
+}
+
+ATSlice ATTokenizer::contents() const {
+  size_t n = stored();
+  return _slice(_head - (_wrap ? n : _head), n);
+}
+
+size_t ATTokenizer::stored() const {
+  return _head < _cap ? _head : _cap;
+}
@@ -0,0 +1,97 @@
+/*
+  ATTokenizer - streaming AT response tokenizer for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Consumes modem output one byte at a time, splits it into lines and recognises
+  final result codes as each line completes, so every byte is inspected once.
+  Bytes are stored in a caller-provided buffer used either as a ring (the last
+  'capacity' bytes are kept) or linearly (bytes past 'capacity' are counted as
+  dropped but still tokenized). Completed lines are handed out as ATSlice views
+  into that buffer; nothing is copied. An optional line buffer also keeps the
+  head of each line on its own, so a line's start survives however full the
+  main buffer is.
+*/
+
+#ifndef AT_TOKENIZER_H
+#define AT_TOKENIZER_H
+
+#include <Arduino.h>
+
+// Events reported by ATTokenizer::feed()
+enum ATToken {
+  AT_TOKEN_NONE,        // Byte consumed, nothing completed
+  AT_TOKEN_LINE,        // Information line or URC completed
+  AT_TOKEN_OK,
+  AT_TOKEN_ERROR,
+  AT_TOKEN_CME_ERROR,
+  AT_TOKEN_CMS_ERROR,
+  AT_TOKEN_CONNECT,
+  AT_TOKEN_PROMPT,      // "> " data prompt (reported without a line terminator)
+  AT_TOKEN_SEND_OK,
+  AT_TOKEN_SEND_FAIL,
+  AT_TOKEN_NO_CARRIER
+};
+
+#define AT_TOKEN_MASK(t) (1UL << (t))
+
+// Tokens that end an ordinary command response (CONNECT is opt-in because
+// several commands stream data after it)
+#define AT_TOKEN_FINAL_MASK (AT_TOKEN_MASK(AT_TOKEN_OK) | AT_TOKEN_MASK(AT_TOKEN_ERROR) | \
+                             AT_TOKEN_MASK(AT_TOKEN_CME_ERROR) | AT_TOKEN_MASK(AT_TOKEN_CMS_ERROR) | \
+                             AT_TOKEN_MASK(AT_TOKEN_PROMPT) | AT_TOKEN_MASK(AT_TOKEN_SEND_OK) | \
+                             AT_TOKEN_MASK(AT_TOKEN_SEND_FAIL))
+
+// View into the tokenizer buffer. A slice that crosses the end of a ring is
+// split into two segments.
+struct ATSlice {
+  const char *data;
+  size_t len;
+  const char *wrapData;
+  size_t wrapLen;
+
+  size_t length() const { return len + wrapLen; }
+  char at(size_t i) const { return i < len ? data[i] : wrapData[i - len]; }
+  bool startsWith(const char *prefix) const;
+  bool equals(const char *text) const;
+  int indexOf(const char *needle) const;
+  size_t copyTo(char *dst, size_t size) const;
+};
+
+class ATTokenizer {
+  public:
+    ATTokenizer();
+
+    void begin(char *buffer, size_t capacity, bool wrap = true);
+    // Copies the first 'capacity' bytes of every line to 'buffer' as well;
+    // line() then reads from there and stays valid until the next feed()
+    void setLineBuffer(char *buffer, size_t capacity);
+    void reset();
+    ATToken feed(char c);
+
+    ATSlice line() const;          // Last completed line (or prompt), without CR/LF
+    ATSlice contents() const;      // Every byte still held in the buffer
+    size_t position() const { return _head; }
+    size_t stored() const;
+    size_t dropped() const { return _dropped; }
+
+  private:
+    char *_buf;
+    size_t _cap;
+    bool _wrap;
+    char *_lineBuf;
+    size_t _lineCap;
+    size_t _head;                  // Total bytes fed since reset()
+    size_t _dropped;
+    size_t _lineStart;             // Absolute offset of the line being built
+    size_t _lineLen;               // Length up to the last non-CR byte
+    char _lineFirst;
+    size_t _lastStart;
+    size_t _lastLen;
+    uint16_t _candidates;          // Final result codes the current line still matches
+
+    ATSlice _slice(size_t start, size_t len) const;
+    ATToken _completeLine();
+};
+
+#endif
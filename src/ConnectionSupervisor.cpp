@@ -0,0 +1,357 @@
+/*
+  ConnectionSupervisor - keeps the data link of a QuectelEC200U up
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "ConnectionSupervisor.h"
+
+ConnectionSupervisor::ConnectionSupervisor(QuectelEC200U &modem, int contextId) {
+  _modem = &modem;
+  _contextId = contextId;
+  _auth = 0;
+  _minBackoff = SUPERVISOR_BACKOFF_MIN_MS;
+  _maxBackoff = SUPERVISOR_BACKOFF_MAX_MS;
+  _socketTimeout = SUPERVISOR_SOCKET_TIMEOUT_MS;
+  _socketCount = 0;
+  _sessionCount = 0;
+  _callback = nullptr;
+  _callbackCtx = nullptr;
+  _state = LINK_STOPPED;
+  _retryState = LINK_WAIT_NETWORK;
+  _retryAt = 0;
+  _stepStart = 0;
+  _lastCheck = 0;
+  _attempt = 0;
+  _wasUp = false;
+  _handle = -1;
+  _result = ATStatus::NONE;
+  _querying = false;
+  _contextActive = false;
+  _seed = 1;
+  _recoveries = 0;
+  _failures = 0;
+}
+
+void ConnectionSupervisor::setAPN(const char *apn, const char *user, const char *pass, int auth) {
+  _apn = apn;
+  _user = user;
+  _pass = pass;
+  _auth = auth;
+}
+
+void ConnectionSupervisor::setBackoff(uint32_t minMs, uint32_t maxMs) {
+  _minBackoff = minMs > 0 ? minMs : 1;
+  _maxBackoff = maxMs > _minBackoff ? maxMs : _minBackoff;
+}
+
+void ConnectionSupervisor::setSocketTimeout(uint32_t ms) {
+  _socketTimeout = ms;
+}
+
+bool ConnectionSupervisor::watchSocket(int socketId, const char *host, int port, int accessMode) {
+  if (_socketCount >= SUPERVISOR_MAX_SOCKETS || socketId < 0 || socketId >= EC200U_MAX_SOCKETS) {
+    return false;
+  }
+  WatchedSocket &w = _sockets[_socketCount++];
+  w.id = socketId;
+  w.host = host;
+  w.port = port;
+  w.accessMode = accessMode;
+  w.handle = -1;
+  return true;
+}
+
+bool ConnectionSupervisor::addSession(SessionRestoreFn restore, void *ctx) {
+  if (_sessionCount >= SUPERVISOR_MAX_SESSIONS || restore == nullptr) {
+    return false;
+  }
+  Session &s = _sessions[_sessionCount++];
+  s.restore = restore;
+  s.ctx = ctx;
+  s.done = false;
+  return true;
+}
+
+void ConnectionSupervisor::onStateChange(LinkStateCallback callback, void *ctx) {
+  _callback = callback;
+  _callbackCtx = ctx;
+}
+
+bool ConnectionSupervisor::begin() {
+  bool ok = _modem->enableNetworkURCs();
+  // Devices that boot together must not share a retry schedule
+  const char *imei = _modem->getDeviceInfo(DeviceInfoField::IMEI);
+  _seed = micros();
+  while (*imei) {
+    _seed = _seed * 31 + *imei++;
+  }
+  if (_seed == 0) {
+    _seed = 1;
+  }
+  _attempt = 0;
+  _wasUp = false;
+  _lastCheck = millis();
+  _enter(LINK_WAIT_NETWORK);
+  return ok;
+}
+
+void ConnectionSupervisor::end() {
+  _handle = -1;
+  _enter(LINK_STOPPED);
+}
+
+uint32_t ConnectionSupervisor::retryIn() const {
+  if (_state != LINK_BACKOFF) {
+    return 0;
+  }
+  int32_t left = (int32_t)(_retryAt - millis());
+  return left > 0 ? (uint32_t)left : 0;
+}
+
+void ConnectionSupervisor::loop() {
+  if (_state == LINK_STOPPED) {
+    return;
+  }
+  _modem->poll();
+
+  // Losing registration restarts from the top, whatever step was running
+  if (_state != LINK_WAIT_NETWORK && !_modem->isNetworkReady()) {
+    _down(LINK_WAIT_NETWORK);
+    return;
+  }
+
+  switch (_state) {
+    case LINK_WAIT_NETWORK:
+      if (_modem->isNetworkReady()) {
+        _start(LINK_ATTACHING);
+      } else if (millis() - _lastCheck >= NETWORK_RECHECK_MS) {
+        // In case a registration URC was lost
+        _lastCheck = millis();
+        _modem->sendATAsync(F("AT+CREG?;+CGREG?;+CEREG?"));
+      }
+      break;
+
+    case LINK_ATTACHING:
+    case LINK_CONFIGURING:
+    case LINK_ACTIVATING:
+      if (_result == ATStatus::QUEUED) {
+        break;   // In flight
+      }
+      if (_result != ATStatus::SUCCESS) {
+        _fail();
+      } else if (_state == LINK_ATTACHING) {
+        _start(_apn.length() > 0 ? LINK_CONFIGURING : LINK_ACTIVATING);
+      } else if (_state == LINK_CONFIGURING) {
+        _start(LINK_ACTIVATING);
+      } else if (_querying && !_contextActive) {
+        _querying = false;
+        _send("AT+QIACT=" + String(_contextId), 15000);
+      } else {
+        _contextRecovered();
+        _start(LINK_RESTORING);
+      }
+      break;
+
+    case LINK_RESTORING:
+      if (_restoring()) {
+        break;
+      }
+      _attempt = 0;
+      if (_wasUp) {
+        _recoveries++;
+      }
+      _wasUp = true;
+      _enter(LINK_UP);
+      break;
+
+    case LINK_UP: {
+      const NetworkState &net = _modem->networkState();
+      if (_contextId >= 1 && _contextId <= 8 && (net.pdpLost & (1 << (_contextId - 1)))) {
+        _down(LINK_ACTIVATING);
+      } else if (_socketDropped()) {
+        _backoff(LINK_RESTORING);
+      }
+      break;
+    }
+
+    case LINK_BACKOFF:
+      if ((int32_t)(millis() - _retryAt) >= 0) {
+        _start(_retryState);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+void ConnectionSupervisor::_enter(LinkState state) {
+  if (_state == state) {
+    return;
+  }
+  _state = state;
+  if (_callback) {
+    _callback(state, _callbackCtx);
+  }
+}
+
+// Issues the first command of a step (or the restore work) and enters it
+void ConnectionSupervisor::_start(LinkState state) {
+  _stepStart = millis();
+  _enter(state);
+  switch (state) {
+    case LINK_ATTACHING:
+      _send(F("AT+CGATT=1"), 10000);
+      break;
+    case LINK_CONFIGURING:
+      _send("AT+QICSGP=" + String(_contextId) + ",1,\"" + _apn + "\",\"" + _user + "\",\"" + _pass + "\"," + String(_auth), 2000);
+      break;
+    case LINK_ACTIVATING:
+      // AT+QIACT fails on a context that is already active: look first
+      _querying = true;
+      _contextActive = false;
+      _send(F("AT+QIACT?"), 2000);
+      break;
+    case LINK_RESTORING:
+      _restore();
+      break;
+    default:
+      break;
+  }
+}
+
+void ConnectionSupervisor::_send(const String &cmd, uint32_t timeout) {
+  _result = ATStatus::QUEUED;
+  _handle = _modem->sendATAsync(cmd, _onReply, this, timeout);
+  if (_handle < 0) {
+    _result = ATStatus::FAILED;
+  }
+}
+
+void ConnectionSupervisor::_fail() {
+  _failures++;
+  _backoff(_state);
+}
+
+// Retries 'step' after base * 2^attempt ms, drawn from the upper half of that
+// interval ("equal jitter")
+void ConnectionSupervisor::_backoff(LinkState step) {
+  uint32_t delayMs = _maxBackoff;
+  if (_attempt < 20 && (_minBackoff << _attempt) < _maxBackoff) {
+    delayMs = _minBackoff << _attempt;
+  }
+  if (_attempt < 255) {
+    _attempt++;
+  }
+  _retryState = step;
+  _retryAt = millis() + delayMs / 2 + _random() % (delayMs / 2 + 1);
+  _handle = -1;
+  _enter(LINK_BACKOFF);
+}
+
+// The link went down while up or on the way up: start again from 'step'
+void ConnectionSupervisor::_down(LinkState step) {
+  _handle = -1;
+  for (uint8_t i = 0; i < _sessionCount; i++) {
+    _sessions[i].done = false;
+  }
+  if (step == LINK_WAIT_NETWORK) {
+    _lastCheck = millis();
+    _enter(LINK_WAIT_NETWORK);
+  } else {
+    _backoff(step);
+  }
+}
+
+// Closes what is left of each watched socket that is not connected and queues
+// a fresh AT+QIOPEN; the socket manager sees the +QIOPEN URC as usual.
+void ConnectionSupervisor::_restore() {
+  for (uint8_t i = 0; i < _socketCount; i++) {
+    WatchedSocket &w = _sockets[i];
+    w.handle = -1;
+    SocketState st = _modem->socketState(w.id);
+    if (st == SOCKET_CONNECTED || st == SOCKET_OPENING) {
+      continue;
+    }
+    if (st != SOCKET_CLOSED) {
+      _modem->socketDiscard(w.id, true);
+    }
+    w.handle = _modem->socketOpenAsync(w.host, w.port, w.id, _contextId, w.accessMode, _onReply, this);
+  }
+}
+
+// True while restore work is pending; fails the step when something did not
+// come back.
+bool ConnectionSupervisor::_restoring() {
+  bool failed = false;
+  for (uint8_t i = 0; i < _socketCount; i++) {
+    SocketState st = _modem->socketState(_sockets[i].id);
+    if (st == SOCKET_OPENING) {
+      if (millis() - _stepStart < _socketTimeout) {
+        return true;
+      }
+      _modem->socketDiscard(_sockets[i].id);
+      failed = true;
+    } else if (st != SOCKET_CONNECTED) {
+      failed = true;
+    }
+  }
+  if (!failed) {
+    for (uint8_t i = 0; i < _sessionCount; i++) {
+      Session &s = _sessions[i];
+      if (!s.done) {
+        s.done = s.restore(*_modem, s.ctx);
+        failed = failed || !s.done;
+      }
+    }
+  }
+  if (failed) {
+    _fail();
+    return true;
+  }
+  return false;
+}
+
+bool ConnectionSupervisor::_socketDropped() const {
+  for (uint8_t i = 0; i < _socketCount; i++) {
+    int id = _sockets[i].id;
+    SocketState st = _modem->socketState(id);
+    // A peer close with unread data is left for the application to drain
+    if (st == SOCKET_CLOSED || (st == SOCKET_REMOTE_CLOSED && _modem->socketRxCount(id) == 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConnectionSupervisor::_contextRecovered() {
+  _modem->clearPdpLost(_contextId);
+}
+
+uint32_t ConnectionSupervisor::_random() {
+  _seed ^= _seed << 13;
+  _seed ^= _seed >> 17;
+  _seed ^= _seed << 5;
+  return _seed;
+}
+
+void ConnectionSupervisor::_onReply(int handle, ATStatus status, const char *response, void *ctx) {
+  ConnectionSupervisor *self = (ConnectionSupervisor *)ctx;
+  if (handle == self->_handle) {
+    if (status == ATStatus::SUCCESS && self->_querying) {
+      char tag[16];
+      snprintf(tag, sizeof(tag), "+QIACT: %d,1", self->_contextId);
+      self->_contextActive = strstr(response, tag) != nullptr;
+    }
+    self->_result = status;
+    return;
+  }
+  for (uint8_t i = 0; i < self->_socketCount; i++) {
+    WatchedSocket &w = self->_sockets[i];
+    if (handle == w.handle && status != ATStatus::SUCCESS) {
+      // Rejected at once; +QIOPEN will not follow
+      self->_modem->socketDiscard(w.id);
+    }
+  }
+}
@@ -0,0 +1,143 @@
+/*
+  ConnectionSupervisor - keeps the data link of a QuectelEC200U up
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Watches registration and +QIURC: "pdpdeact" through the modem's network
+  state tracker and brings the link back on its own: GPRS attach, PDP context
+  configuration and activation, then the watched sockets and the registered
+  session restorers (e.g. an MQTT reconnect). Every step is a queued AT
+  command (sendATAsync()), so loop() never waits for the module. A failed
+  step is retried after an exponential backoff with jitter, which keeps
+  devices that lost coverage together from retrying in lockstep on a
+  congested cell.
+*/
+
+#ifndef CONNECTION_SUPERVISOR_H
+#define CONNECTION_SUPERVISOR_H
+
+#include <Arduino.h>
+#include "QuectelEC200U.h"
+
+#ifndef SUPERVISOR_MAX_SOCKETS
+#define SUPERVISOR_MAX_SOCKETS 4
+#endif
+#ifndef SUPERVISOR_MAX_SESSIONS
+#define SUPERVISOR_MAX_SESSIONS 4
+#endif
+#ifndef SUPERVISOR_BACKOFF_MIN_MS
+#define SUPERVISOR_BACKOFF_MIN_MS 1000
+#endif
+#ifndef SUPERVISOR_BACKOFF_MAX_MS
+#define SUPERVISOR_BACKOFF_MAX_MS 300000
+#endif
+#ifndef SUPERVISOR_SOCKET_TIMEOUT_MS
+#define SUPERVISOR_SOCKET_TIMEOUT_MS 30000
+#endif
+
+enum LinkState {
+  LINK_STOPPED,
+  LINK_WAIT_NETWORK,    // Not registered; the module is searching
+  LINK_ATTACHING,       // AT+CGATT=1
+  LINK_CONFIGURING,     // AT+QICSGP
+  LINK_ACTIVATING,      // AT+QIACT? / AT+QIACT
+  LINK_RESTORING,       // Watched sockets and session restorers
+  LINK_UP,
+  LINK_BACKOFF          // Waiting to retry the step that failed
+};
+
+// Re-creates a session once the link is back. Runs from loop(); return false
+// to have it retried after the next backoff.
+typedef bool (*SessionRestoreFn)(QuectelEC200U &modem, void *ctx);
+
+// Called from loop() on every LinkState change
+typedef void (*LinkStateCallback)(LinkState state, void *ctx);
+
+class ConnectionSupervisor {
+  public:
+    ConnectionSupervisor(QuectelEC200U &modem, int contextId = 1);
+
+    void setAPN(const char *apn, const char *user = "", const char *pass = "", int auth = 0);
+    void setBackoff(uint32_t minMs, uint32_t maxMs);
+    // How long a watched socket may stay in SOCKET_OPENING during a restore
+    void setSocketTimeout(uint32_t ms);
+    bool watchSocket(int socketId, const char *host, int port, int accessMode = SOCKET_ACCESS_BUFFER);
+    bool addSession(SessionRestoreFn restore, void *ctx = nullptr);
+    void onStateChange(LinkStateCallback callback, void *ctx = nullptr);
+
+    // Turns on the network URCs (one blocking exchange) and starts supervising
+    bool begin();
+    void end();
+
+    // Non-blocking; polls the modem as well. Call it from loop().
+    void loop();
+
+    LinkState state() const { return _state; }
+    bool isUp() const { return _state == LINK_UP; }
+    uint8_t attempt() const { return _attempt; }
+    uint32_t retryIn() const;
+    uint32_t recoveries() const { return _recoveries; }
+    uint32_t failures() const { return _failures; }
+
+  private:
+    struct WatchedSocket {
+      int id;
+      String host;
+      int port;
+      int accessMode;
+      int handle;
+    };
+    struct Session {
+      SessionRestoreFn restore;
+      void *ctx;
+      bool done;
+    };
+
+    QuectelEC200U *_modem;
+    int _contextId;
+    String _apn;
+    String _user;
+    String _pass;
+    int _auth;
+    uint32_t _minBackoff;
+    uint32_t _maxBackoff;
+    uint32_t _socketTimeout;
+
+    WatchedSocket _sockets[SUPERVISOR_MAX_SOCKETS];
+    uint8_t _socketCount;
+    Session _sessions[SUPERVISOR_MAX_SESSIONS];
+    uint8_t _sessionCount;
+
+    LinkStateCallback _callback;
+    void *_callbackCtx;
+
+    LinkState _state;
+    LinkState _retryState;
+    uint32_t _retryAt;
+    uint32_t _stepStart;
+    uint32_t _lastCheck;
+    uint8_t _attempt;
+    bool _wasUp;
+    int _handle;
+    ATStatus _result;
+    bool _querying;
+    bool _contextActive;
+    uint32_t _seed;
+    uint32_t _recoveries;
+    uint32_t _failures;
+
+    void _enter(LinkState state);
+    void _start(LinkState state);
+    void _send(const String &cmd, uint32_t timeout);
+    void _fail();
+    void _backoff(LinkState step);
+    void _down(LinkState step);
+    void _restore();
+    bool _restoring();
+    bool _socketDropped() const;
+    void _contextRecovered();
+    uint32_t _random();
+    static void _onReply(int handle, ATStatus status, const char *response, void *ctx);
+};
+
+#endif
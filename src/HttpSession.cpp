@@ -0,0 +1,188 @@
+/*
+  HttpSession - HTTP(S) requests with cached modem configuration for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "HttpSession.h"
+
+HttpSession::HttpSession(QuectelEC200U &modem, int contextId, int sslContextId) {
+  _modem = &modem;
+  _contextId = contextId;
+  _sslContextId = sslContextId;
+  _headers = nullptr;
+  _headerCount = 0;
+  _requests = 0;
+  _saved = 0;
+  _outerContextId = 1;
+  _outerSslContextId = 1;
+}
+
+void HttpSession::setHeaders(String headers[], size_t count) {
+  _headers = headers;
+  _headerCount = headers ? count : 0;
+}
+
+bool HttpSession::get(const String &url, String &response) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsGet(url, response, _headers, _headerCount)
+                           : _modem->httpGet(url, response, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::get(const String &url, HttpBodyCallback onBody, void *ctx) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsGetStream(url, onBody, ctx, _headers, _headerCount)
+                           : _modem->httpGetStream(url, onBody, ctx, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::get(const String &url, Print &sink) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsGetStream(url, sink, _headers, _headerCount)
+                           : _modem->httpGetStream(url, sink, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::post(const String &url, const String &data, String &response) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsPost(url, data, response, _headers, _headerCount)
+                           : _modem->httpPost(url, data, response, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::post(const String &url, const JsonDocument &json, String &response) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsPost(url, json, response, _headers, _headerCount)
+                           : _modem->httpPost(url, json, response, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::post(const String &url, size_t length, HttpBodySource source, void *ctx, String &response) {
+  uint32_t before = _enter();
+  bool ok = _isSecure(url) ? _modem->httpsPostStream(url, length, source, ctx, response, _headers, _headerCount)
+                           : _modem->httpPostStream(url, length, source, ctx, response, _headers, _headerCount);
+  return _track(before, ok);
+}
+
+bool HttpSession::postBatch(const String &url, const String bodies[], size_t count, HttpBatchResult &result, HttpBatchEntry entries[], bool readResponses) {
+  return postBatch(url, count, _arrayBody, (void *)bodies, result, entries, readResponses);
+}
+
+// The module runs one HTTP request at a time, so the requests themselves stay
+// sequential; what is removed is everything around them. Configuration and URL
+// are cached after the first request, the response read is optional, and body
+// i+1 is built while request i waits for the server.
+bool HttpSession::postBatch(const String &url, size_t count, HttpBatchBodyCallback nextBody, void *ctx, HttpBatchResult &result, HttpBatchEntry entries[], bool readResponses) {
+  result.requested = count;
+  result.succeeded = 0;
+  result.elapsedMs = 0;
+  result.minLatencyMs = 0;
+  result.avgLatencyMs = 0;
+  result.maxLatencyMs = 0;
+  result.requestsPerSecond = 0;
+  result.skipped = 0;
+  result.readsSkipped = 0;
+  if (count == 0 || nextBody == nullptr) {
+    return count == 0;
+  }
+
+  uint32_t savedBefore = _enter();
+  uint32_t latencySum = 0;
+  size_t attempted = 0;
+  String body;
+  String next;
+  bool haveBody = nextBody(0, body, ctx);
+  uint32_t start = millis();
+
+  for (size_t i = 0; i < count; i++) {
+    if (!haveBody) {
+      result.skipped++;
+      if (entries != nullptr) {
+        entries[i].status = 0;
+        entries[i].latencyMs = 0;
+      }
+      next = "";
+      haveBody = i + 1 < count && nextBody(i + 1, next, ctx);
+      body = next;
+      continue;
+    }
+
+    uint32_t t0 = millis();
+    bool ok = _modem->httpPostBegin(url, body.length(), _headers, _headerCount);
+    if (ok) {
+      _modem->httpPostWrite((const uint8_t *)body.c_str(), body.length());
+    }
+
+    next = "";
+    bool haveNext = i + 1 < count && nextBody(i + 1, next, ctx);
+
+    if (ok) {
+      String response;
+      ok = _modem->httpPostEnd(readResponses ? &response : nullptr);
+      if (ok && !readResponses) {
+        result.readsSkipped++;
+      }
+    }
+    uint32_t latency = millis() - t0;
+
+    if (entries != nullptr) {
+      entries[i].status = ok ? _modem->httpStatusCode() : -1;
+      entries[i].latencyMs = latency;
+    }
+    if (ok) {
+      result.succeeded++;
+    }
+    latencySum += latency;
+    if (attempted == 0 || latency < result.minLatencyMs) {
+      result.minLatencyMs = latency;
+    }
+    if (latency > result.maxLatencyMs) {
+      result.maxLatencyMs = latency;
+    }
+    attempted++;
+
+    body = next;
+    haveBody = haveNext;
+  }
+
+  result.elapsedMs = millis() - start;
+  if (attempted > 0) {
+    result.avgLatencyMs = latencySum / attempted;
+  }
+  if (result.elapsedMs > 0) {
+    result.requestsPerSecond = result.succeeded * 1000.0f / result.elapsedMs;
+  }
+  _leave();
+  _requests += attempted;
+  _saved += _modem->httpRoundTripsSaved() - savedBefore;
+  return result.succeeded + result.skipped == count;
+}
+
+bool HttpSession::_arrayBody(size_t index, String &body, void *ctx) {
+  body = ((const String *)ctx)[index];
+  return true;
+}
+
+bool HttpSession::_isSecure(const String &url) {
+  return url.startsWith("https://") || url.startsWith("HTTPS://");
+}
+
+// Points the modem's requests at this session's contexts until _leave()
+uint32_t HttpSession::_enter() {
+  _outerContextId = _modem->httpContextId();
+  _outerSslContextId = _modem->httpSslContextId();
+  _modem->setHttpContext(_contextId, _sslContextId);
+  return _modem->httpRoundTripsSaved();
+}
+
+void HttpSession::_leave() {
+  _modem->setHttpContext(_outerContextId, _outerSslContextId);
+}
+
+bool HttpSession::_track(uint32_t savedBefore, bool ok) {
+  _leave();
+  _requests++;
+  _saved += _modem->httpRoundTripsSaved() - savedBefore;
+  return ok;
+}
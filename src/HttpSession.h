@@ -0,0 +1,84 @@
+/*
+  HttpSession - HTTP(S) requests with cached modem configuration for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Holds the PDP/SSL context and custom headers for a series of requests. The
+  modem remembers which AT+QHTTPCFG settings and URL the module already has, so
+  a repeated request to the same endpoint costs only the GET/POST and the read.
+  HTTPS is selected by the "https://" scheme of each URL.
+
+  postBatch() sends N bodies to one endpoint back to back: the URL and headers
+  are configured once, AT+QHTTPREAD is skipped unless asked for, and the next
+  body is produced while the module is still waiting for the server's answer
+  to the current one.
+*/
+
+#ifndef HTTP_SESSION_H
+#define HTTP_SESSION_H
+
+#include <Arduino.h>
+#include "QuectelEC200U.h"
+
+// Supplies body 'index' of a batch. Called while the previous request is in
+// flight, so it must not issue AT commands. Return false to skip the request.
+typedef bool (*HttpBatchBodyCallback)(size_t index, String &body, void *ctx);
+
+struct HttpBatchEntry {
+  int status;              // HTTP status, 0 if skipped, -1 if the request failed
+  uint32_t latencyMs;      // AT+QHTTPPOST issued -> +QHTTPPOST (and read) done
+};
+
+struct HttpBatchResult {
+  size_t requested;
+  size_t succeeded;
+  uint32_t elapsedMs;
+  uint32_t minLatencyMs;
+  uint32_t avgLatencyMs;
+  uint32_t maxLatencyMs;
+  float requestsPerSecond;
+  size_t skipped;          // nextBody() returned false; not in the latency figures
+  uint32_t readsSkipped;   // AT+QHTTPREAD round-trips left out (readResponses false)
+};
+
+class HttpSession {
+  public:
+    HttpSession(QuectelEC200U &modem, int contextId = 1, int sslContextId = 1);
+
+    // 'headers' is referenced, not copied: keep the array alive while in use
+    void setHeaders(String headers[], size_t count);
+
+    bool get(const String &url, String &response);
+    bool get(const String &url, HttpBodyCallback onBody, void *ctx = nullptr);
+    bool get(const String &url, Print &sink);
+    bool post(const String &url, const String &data, String &response);
+    bool post(const String &url, const JsonDocument &json, String &response);
+    bool post(const String &url, size_t length, HttpBodySource source, void *ctx, String &response);
+
+    // Batch POST to one endpoint; 'entries' (optional) receives per-request results
+    bool postBatch(const String &url, const String bodies[], size_t count, HttpBatchResult &result, HttpBatchEntry entries[] = nullptr, bool readResponses = false);
+    bool postBatch(const String &url, size_t count, HttpBatchBodyCallback nextBody, void *ctx, HttpBatchResult &result, HttpBatchEntry entries[] = nullptr, bool readResponses = false);
+
+    int statusCode() const { return _modem->httpStatusCode(); }
+    uint32_t requests() const { return _requests; }
+    uint32_t roundTripsSaved() const { return _saved; }   // AT round-trips skipped by this session
+
+  private:
+    QuectelEC200U *_modem;
+    int _contextId;
+    int _sslContextId;
+    String *_headers;
+    size_t _headerCount;
+    uint32_t _requests;
+    uint32_t _saved;
+    int _outerContextId;       // The modem's own contexts, put back after each request
+    int _outerSslContextId;
+
+    static bool _isSecure(const String &url);
+    static bool _arrayBody(size_t index, String &body, void *ctx);
+    uint32_t _enter();
+    void _leave();
+    bool _track(uint32_t savedBefore, bool ok);
+};
+
+#endif
@@ -0,0 +1,348 @@
+/*
+  OfflineQueue - persistent store-and-forward FIFO for a QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "OfflineQueue.h"
+
+// Record: 0xA5, tag, length (little endian, 2 bytes), payload checksum, payload
+#define OFFLINE_RECORD_MAGIC 0xA5
+#define OFFLINE_RECORD_HEADER 5
+
+// Index: "SFQ1", head segment, tail segment, head offset (little endian)
+#define OFFLINE_INDEX_SIZE 12
+
+// ===== UFS store =====
+
+UfsQueueStore::UfsQueueStore(QuectelEC200U &modem, const char *prefix) {
+  _modem = &modem;
+  _prefix = prefix;
+}
+
+String UfsQueueStore::_path(const char *name) const {
+  return String(_prefix) + name;
+}
+
+bool UfsQueueStore::append(const char *name, const uint8_t *data, size_t length) {
+  int handle = _modem->fsOpen(_path(name), 0);
+  if (handle < 0) {
+    return false;
+  }
+  bool ok = _modem->fsSeek(handle, 0, 2) && _modem->fsWrite(handle, data, length) == (int)length;
+  _modem->fsClose(handle);
+  return ok;
+}
+
+int UfsQueueStore::read(const char *name, uint32_t offset, uint8_t *buffer, size_t length) {
+  int handle = _modem->fsOpen(_path(name), 2);
+  if (handle < 0) {
+    return -1;
+  }
+  int n = -1;
+  if (_modem->fsSeek(handle, (long)offset, 0)) {
+    n = _modem->fsRead(handle, buffer, length);
+  }
+  _modem->fsClose(handle);
+  return n;
+}
+
+bool UfsQueueStore::replace(const char *name, const uint8_t *data, size_t length) {
+  int handle = _modem->fsOpen(_path(name), 1);
+  if (handle < 0) {
+    return false;
+  }
+  bool ok = _modem->fsWrite(handle, data, length) == (int)length;
+  _modem->fsClose(handle);
+  return ok;
+}
+
+bool UfsQueueStore::remove(const char *name) {
+  return _modem->fsDelete(_path(name));
+}
+
+long UfsQueueStore::size(const char *name) {
+  return _modem->fsSize(_path(name));
+}
+
+// ===== Queue =====
+
+OfflineQueue::OfflineQueue(QueueStore &store, const char *name) {
+  _store = &store;
+  strncpy(_name, name, sizeof(_name) - 1);
+  _name[sizeof(_name) - 1] = '\0';
+  _headSeg = 0;
+  _tailSeg = 0;
+  _headOffset = 0;
+  _headSize = 0;
+  _tailSize = 0;
+  _pushed = 0;
+  _delivered = 0;
+}
+
+void OfflineQueue::_segmentName(uint16_t segment, char *out, size_t size) const {
+  snprintf(out, size, "%s_%u.q", _name, (unsigned)segment);
+}
+
+uint32_t OfflineQueue::_segmentSize(uint16_t segment) {
+  char file[24];
+  _segmentName(segment, file, sizeof(file));
+  long size = _store->size(file);
+  return size > 0 ? (uint32_t)size : 0;
+}
+
+bool OfflineQueue::begin() {
+  char file[24];
+  snprintf(file, sizeof(file), "%s.idx", _name);
+  uint8_t *idx = _record;
+  _headSeg = 0;
+  _tailSeg = 0;
+  _headOffset = 0;
+  if (_store->read(file, 0, idx, OFFLINE_INDEX_SIZE) == OFFLINE_INDEX_SIZE && memcmp(idx, "SFQ1", 4) == 0) {
+    _headSeg = idx[4] | (idx[5] << 8);
+    _tailSeg = idx[6] | (idx[7] << 8);
+    _headOffset = (uint32_t)idx[8] | ((uint32_t)idx[9] << 8) | ((uint32_t)idx[10] << 16) | ((uint32_t)idx[11] << 24);
+  } else if (!_saveIndex()) {
+    return false;
+  }
+  _tailSize = _segmentSize(_tailSeg);
+  _headSize = _headSeg == _tailSeg ? _tailSize : _segmentSize(_headSeg);
+
+  // An offset past the end of its segment (a file removed or replaced behind
+  // the index) would skip records pushed from now on
+  if (_headOffset > _headSize) {
+    _headOffset = _headSize;
+    if (!_saveIndex()) {
+      return false;
+    }
+  }
+
+  // A reset during append() can leave part of a record at the end of the last
+  // segment. Appending after it would misalign every later record, so new
+  // records go to a fresh segment; flush() stops at the torn bytes.
+  uint32_t from = _headSeg == _tailSeg ? _headOffset : 0;
+  if (_tailSize > from && _validEnd(_tailSeg, from, _tailSize) != _tailSize &&
+      segments() < OFFLINE_QUEUE_MAX_SEGMENTS) {
+    _tailSeg++;
+    if (!_saveIndex()) {
+      _tailSeg--;
+      return false;
+    }
+    _tailSize = 0;
+  }
+  return true;
+}
+
+// End of the run of intact records starting at 'offset', read a block at a time
+uint32_t OfflineQueue::_validEnd(uint16_t segment, uint32_t offset, uint32_t size) {
+  char file[24];
+  _segmentName(segment, file, sizeof(file));
+  while (offset < size) {
+    size_t want = size - offset;
+    if (want > sizeof(_record)) {
+      want = sizeof(_record);
+    }
+    int n = _store->read(file, offset, _record, want);
+    size_t pos = 0;
+    while (n > 0 && (size_t)n - pos >= OFFLINE_RECORD_HEADER) {
+      size_t length = _recordLength(_record + pos, (size_t)n - pos);
+      if (length == 0) {
+        break;
+      }
+      pos += length;
+    }
+    if (pos == 0) {
+      break;
+    }
+    offset += pos;
+  }
+  return offset;
+}
+
+// Size of the intact record at 'rec', 0 if it is damaged or not all in 'available'
+size_t OfflineQueue::_recordLength(const uint8_t *rec, size_t available) {
+  if (available < OFFLINE_RECORD_HEADER || rec[0] != OFFLINE_RECORD_MAGIC) {
+    return 0;
+  }
+  size_t length = rec[2] | (rec[3] << 8);
+  if (length > OFFLINE_QUEUE_RECORD_MAX || available < OFFLINE_RECORD_HEADER + length ||
+      _checksum(rec + OFFLINE_RECORD_HEADER, length) != rec[4]) {
+    return 0;
+  }
+  return OFFLINE_RECORD_HEADER + length;
+}
+
+uint8_t OfflineQueue::_checksum(const uint8_t *data, size_t length) {
+  uint8_t sum = 0;
+  while (length--) {
+    sum = (uint8_t)((sum << 1 | sum >> 7) + *data++);
+  }
+  return sum;
+}
+
+bool OfflineQueue::_saveIndex() {
+  uint8_t idx[OFFLINE_INDEX_SIZE] = {'S', 'F', 'Q', '1',
+                                     (uint8_t)_headSeg, (uint8_t)(_headSeg >> 8),
+                                     (uint8_t)_tailSeg, (uint8_t)(_tailSeg >> 8),
+                                     (uint8_t)_headOffset, (uint8_t)(_headOffset >> 8),
+                                     (uint8_t)(_headOffset >> 16), (uint8_t)(_headOffset >> 24)};
+  char file[24];
+  snprintf(file, sizeof(file), "%s.idx", _name);
+  return _store->replace(file, idx, sizeof(idx));
+}
+
+bool OfflineQueue::push(const String &data, uint8_t tag) {
+  return push((const uint8_t *)data.c_str(), data.length(), tag);
+}
+
+bool OfflineQueue::push(const uint8_t *data, size_t length, uint8_t tag) {
+  if (length > OFFLINE_QUEUE_RECORD_MAX) {
+    return false;
+  }
+  size_t recordLength = OFFLINE_RECORD_HEADER + length;
+
+  // Start a new segment when this record would overflow the last one. The
+  // index is saved first, so a reset never leaves records behind the tail.
+  if (_tailSize > 0 && _tailSize + recordLength > OFFLINE_QUEUE_SEGMENT_SIZE) {
+    if (segments() >= OFFLINE_QUEUE_MAX_SEGMENTS) {
+      return false;   // Full
+    }
+    _tailSeg++;
+    if (!_saveIndex()) {
+      _tailSeg--;
+      return false;
+    }
+    _tailSize = 0;
+  }
+
+  _record[0] = OFFLINE_RECORD_MAGIC;
+  _record[1] = tag;
+  _record[2] = (uint8_t)length;
+  _record[3] = (uint8_t)(length >> 8);
+  _record[4] = _checksum(data, length);
+  memcpy(_record + OFFLINE_RECORD_HEADER, data, length);
+  char file[24];
+  _segmentName(_tailSeg, file, sizeof(file));
+  if (!_store->append(file, _record, recordLength)) {
+    return false;
+  }
+  _tailSize += recordLength;
+  if (_headSeg == _tailSeg) {
+    _headSize = _tailSize;
+  }
+  _pushed++;
+  return true;
+}
+
+// Reads a block at the head and delivers every complete record in it, so a
+// batch of small records costs one store read. The index is saved once.
+int OfflineQueue::flush(OfflineSendFn send, void *ctx, size_t maxRecords) {
+  size_t sent = 0;
+  bool moved = false;
+  bool failed = false;
+  bool stopped = false;
+  char file[24];
+
+  while (sent < maxRecords && !stopped) {
+    if (_headOffset >= _headSize) {
+      if (_headSeg == _tailSeg) {
+        break;   // Empty
+      }
+      _segmentName(_headSeg, file, sizeof(file));
+      _store->remove(file);
+      _headSeg++;
+      _headOffset = 0;
+      _headSize = _headSeg == _tailSeg ? _tailSize : _segmentSize(_headSeg);
+      moved = true;
+      continue;
+    }
+
+    size_t want = _headSize - _headOffset;
+    if (want > sizeof(_record)) {
+      want = sizeof(_record);
+    }
+    _segmentName(_headSeg, file, sizeof(file));
+    int n = _store->read(file, _headOffset, _record, want);
+    if (n < 0) {
+      failed = true;
+      break;
+    }
+
+    bool more = _headOffset + (uint32_t)n < _headSize;
+    size_t pos = 0;
+    while (sent < maxRecords) {
+      if ((size_t)n - pos < OFFLINE_RECORD_HEADER) {
+        break;
+      }
+      const uint8_t *rec = _record + pos;
+      size_t length = rec[2] | (rec[3] << 8);
+      if (more && rec[0] == OFFLINE_RECORD_MAGIC && length <= OFFLINE_QUEUE_RECORD_MAX &&
+          (size_t)n - pos < OFFLINE_RECORD_HEADER + length) {
+        break;   // Continues in the next block
+      }
+      if (_recordLength(rec, (size_t)n - pos) == 0) {
+        // Torn or damaged record: resynchronise on the next magic byte; the
+        // record found there is checked like any other
+        pos++;
+        while (pos < (size_t)n && _record[pos] != OFFLINE_RECORD_MAGIC) {
+          pos++;
+        }
+        continue;
+      }
+      if (!send(rec[1], rec + OFFLINE_RECORD_HEADER, length, ctx)) {
+        stopped = true;
+        break;
+      }
+      pos += OFFLINE_RECORD_HEADER + length;
+      sent++;
+      _delivered++;
+    }
+    if (pos == 0 && !stopped && sent < maxRecords) {
+      // A read holds the largest record, so nothing usable in it means the
+      // segment ends in a fragment
+      pos = _headSize - _headOffset;
+    }
+    if (pos > 0) {
+      _headOffset += pos;
+      moved = true;
+    }
+  }
+
+  // Drained: start the last segment over instead of letting it grow. The
+  // index goes back to offset 0 before the file is removed; a reset in
+  // between only sends the drained records again, whereas a stale offset
+  // would skip records pushed to the new file.
+  if (_headSeg == _tailSeg && _headOffset >= _tailSize && _tailSize > 0) {
+    uint32_t drained = _headOffset;
+    _headOffset = 0;
+    _segmentName(_tailSeg, file, sizeof(file));
+    if (_saveIndex() && _store->remove(file)) {
+      _headSize = 0;
+      _tailSize = 0;
+      moved = false;
+    } else {
+      _headOffset = drained;
+      moved = true;
+    }
+  }
+  if (moved && !_saveIndex()) {
+    failed = true;
+  }
+  return failed && sent == 0 ? -1 : (int)sent;
+}
+
+bool OfflineQueue::clear() {
+  char file[24];
+  for (uint16_t seg = _headSeg;; seg++) {
+    _segmentName(seg, file, sizeof(file));
+    _store->remove(file);
+    if (seg == _tailSeg) {
+      break;
+    }
+  }
+  _headSeg = _tailSeg = 0;
+  _headOffset = 0;
+  _headSize = 0;
+  _tailSize = 0;
+  return _saveIndex();
+}
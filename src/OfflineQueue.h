@@ -0,0 +1,117 @@
+/*
+  OfflineQueue - persistent store-and-forward FIFO for a QuectelEC200U
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Keeps payloads that could not be sent (an HTTP POST body, an MQTT message)
+  in storage instead of the MCU heap, and hands them back in order once the
+  link is up again. Records are appended to numbered segment files of up to
+  OFFLINE_QUEUE_SEGMENT_SIZE bytes; a small index file holds the read
+  position and is only rewritten when a segment is added or after a flushed
+  batch. A segment is deleted as soon as it has been delivered completely.
+
+  Storage is a QueueStore: UfsQueueStore keeps the files on the modem's UFS,
+  or derive from QueueStore to use a host file system (LittleFS, SD card, ...).
+  RAM use is fixed: one record buffer of OFFLINE_QUEUE_RECORD_MAX bytes.
+
+  Delivery is at-least-once: after a reset, records of a batch that was sent
+  but whose index update did not complete are sent again. A record torn by
+  a reset during push() is skipped; the records behind it are kept.
+*/
+
+#ifndef OFFLINE_QUEUE_H
+#define OFFLINE_QUEUE_H
+
+#include <Arduino.h>
+#include "QuectelEC200U.h"
+
+#ifndef OFFLINE_QUEUE_SEGMENT_SIZE
+#define OFFLINE_QUEUE_SEGMENT_SIZE 16384
+#endif
+#ifndef OFFLINE_QUEUE_MAX_SEGMENTS
+#define OFFLINE_QUEUE_MAX_SEGMENTS 16
+#endif
+#ifndef OFFLINE_QUEUE_RECORD_MAX
+#define OFFLINE_QUEUE_RECORD_MAX 1024    // Largest payload push() accepts
+#endif
+#ifndef OFFLINE_QUEUE_BATCH
+#define OFFLINE_QUEUE_BATCH 16           // Default records per flush()
+#endif
+
+// Named files holding bytes. Names are short ASCII (e.g. "sfq_12.q").
+class QueueStore {
+  public:
+    virtual ~QueueStore() {}
+    virtual bool append(const char *name, const uint8_t *data, size_t length) = 0;
+    // Bytes read at 'offset' (fewer at the end of the file), -1 on error
+    virtual int read(const char *name, uint32_t offset, uint8_t *buffer, size_t length) = 0;
+    virtual bool replace(const char *name, const uint8_t *data, size_t length) = 0;
+    virtual bool remove(const char *name) = 0;
+    virtual long size(const char *name) = 0;   // -1 when missing
+};
+
+// Files on the module's UFS (AT+QFOPEN and friends)
+class UfsQueueStore : public QueueStore {
+  public:
+    explicit UfsQueueStore(QuectelEC200U &modem, const char *prefix = "UFS:");
+
+    bool append(const char *name, const uint8_t *data, size_t length) override;
+    int read(const char *name, uint32_t offset, uint8_t *buffer, size_t length) override;
+    bool replace(const char *name, const uint8_t *data, size_t length) override;
+    bool remove(const char *name) override;
+    long size(const char *name) override;
+
+  private:
+    QuectelEC200U *_modem;
+    const char *_prefix;
+
+    String _path(const char *name) const;
+};
+
+// Delivers one record. Return false to stop the flush; the record stays queued.
+// Must not push() to the queue being flushed.
+typedef bool (*OfflineSendFn)(uint8_t tag, const uint8_t *data, size_t length, void *ctx);
+
+class OfflineQueue {
+  public:
+    OfflineQueue(QueueStore &store, const char *name = "sfq");
+
+    // Loads the index and checks the last segment; a record torn by a reset
+    // during push() makes later pushes start a new segment
+    bool begin();
+
+    // 'tag' is stored with the record, e.g. to tell HTTP bodies from MQTT messages
+    bool push(const uint8_t *data, size_t length, uint8_t tag = 0);
+    bool push(const String &data, uint8_t tag = 0);
+
+    // Sends up to 'maxRecords' records in order; returns the number delivered,
+    // or -1 when the store failed before any was
+    int flush(OfflineSendFn send, void *ctx = nullptr, size_t maxRecords = OFFLINE_QUEUE_BATCH);
+
+    bool clear();
+    bool empty() const { return _headSeg == _tailSeg && _headOffset >= _tailSize; }
+    uint16_t segments() const { return (uint16_t)(_tailSeg - _headSeg) + 1; }
+    uint32_t pushed() const { return _pushed; }
+    uint32_t delivered() const { return _delivered; }
+
+  private:
+    QueueStore *_store;
+    char _name[12];
+    uint16_t _headSeg;
+    uint16_t _tailSeg;
+    uint32_t _headOffset;
+    uint32_t _headSize;
+    uint32_t _tailSize;
+    uint32_t _pushed;
+    uint32_t _delivered;
+    uint8_t _record[5 + OFFLINE_QUEUE_RECORD_MAX];   // Header + payload
+
+    void _segmentName(uint16_t segment, char *out, size_t size) const;
+    uint32_t _segmentSize(uint16_t segment);
+    uint32_t _validEnd(uint16_t segment, uint32_t offset, uint32_t size);
+    static size_t _recordLength(const uint8_t *rec, size_t available);
+    bool _saveIndex();
+    static uint8_t _checksum(const uint8_t *data, size_t length);
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*
+  QuectelClient - Arduino Client over an EC200U socket for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "QuectelClient.h"
+
+QuectelClient::QuectelClient(QuectelEC200U &modem, int socketId, int ctxId) {
+  _modem = &modem;
+  _socketId = -1;
+  _requestedId = socketId;
+  _ctxId = ctxId;
+  _accessMode = SOCKET_ACCESS_BUFFER;
+  _sslCtxId = -1;
+  _connectTimeout = 15000;
+}
+
+int QuectelClient::connect(IPAddress ip, uint16_t port) {
+  char host[16];
+  snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  return connect(host, port);
+}
+
+int QuectelClient::connect(const char *host, uint16_t port) {
+  if (_socketId >= 0) {
+    stop();
+  }
+  int id = _sslCtxId >= 0 ? _modem->sslOpen(host, port, _sslCtxId, _requestedId, _ctxId, _accessMode)
+                          : _modem->socketOpen(host, port, _requestedId, _ctxId, _accessMode);
+  if (id < 0) {
+    return 0;
+  }
+  _socketId = id;
+  if (!_modem->socketWaitConnected(id, _connectTimeout)) {
+    _modem->socketClose(id);
+    _socketId = -1;
+    return 0;
+  }
+  return 1;
+}
+
+bool QuectelClient::attach(int socketId) {
+  if (_socketId >= 0) {
+    stop();
+  }
+  if (_modem->socketState(socketId) != SOCKET_CONNECTED) {
+    return false;
+  }
+  _socketId = socketId;
+  return true;
+}
+
+size_t QuectelClient::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t QuectelClient::write(const uint8_t *buf, size_t size) {
+  if (_socketId < 0) {
+    return 0;
+  }
+  return _modem->socketWrite(_socketId, buf, size);
+}
+
+int QuectelClient::available() {
+  if (_socketId < 0) {
+    return 0;
+  }
+  return (int)_modem->socketAvailable(_socketId);
+}
+
+int QuectelClient::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+int QuectelClient::read(uint8_t *buf, size_t size) {
+  if (_socketId < 0) {
+    return -1;
+  }
+  return _modem->socketRead(_socketId, buf, size);
+}
+
+int QuectelClient::peek() {
+  if (_socketId < 0) {
+    return -1;
+  }
+  return _modem->socketPeek(_socketId);
+}
+
+void QuectelClient::flush() {
+  // Writes complete on SEND OK; nothing is buffered on this side.
+}
+
+void QuectelClient::stop() {
+  if (_socketId < 0) {
+    return;
+  }
+  _modem->socketClose(_socketId);
+  _socketId = -1;
+}
+
+uint8_t QuectelClient::connected() {
+  if (_socketId < 0) {
+    return 0;
+  }
+  SocketState state = _modem->socketState(_socketId);
+  if (state == SOCKET_CONNECTED) {
+    return 1;
+  }
+  // Arduino semantics: still "connected" while unread data remains
+  return (state == SOCKET_REMOTE_CLOSED && _modem->socketAvailable(_socketId) > 0) ? 1 : 0;
+}
+
+QuectelClient::operator bool() {
+  return _socketId >= 0 && _modem->socketState(_socketId) != SOCKET_CLOSED;
+}
@@ -0,0 +1,56 @@
+/*
+  QuectelClient - Arduino Client over an EC200U socket for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Each instance wraps one connectID managed by QuectelEC200U's socket manager, so
+  several clients can stay connected at once and plug into libraries that take a
+  Client& (HTTP clients, MQTT clients, ...).
+*/
+
+#ifndef QUECTEL_CLIENT_H
+#define QUECTEL_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "QuectelEC200U.h"
+
+class QuectelClient : public Client {
+  public:
+    // socketId = -1 picks a free connectID on connect()
+    QuectelClient(QuectelEC200U &modem, int socketId = -1, int ctxId = 1);
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    // Takes over a connected connectID, e.g. one from socketAccept()
+    bool attach(int socketId);
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+    void setConnectTimeout(uint32_t timeoutMs) { _connectTimeout = timeoutMs; }
+    void setAccessMode(int accessMode) { _accessMode = accessMode; }
+    // connect() opens a TLS socket (sslOpen()) with this SSL context; -1 = plain TCP
+    void setSSLContext(int sslCtxId) { _sslCtxId = sslCtxId; }
+    int socketId() const { return _socketId; }
+
+    using Print::write;
+
+  private:
+    QuectelEC200U *_modem;
+    int _socketId;
+    int _requestedId;
+    int _ctxId;
+    int _accessMode;
+    int _sslCtxId;
+    uint32_t _connectTimeout;
+};
+
+#endif
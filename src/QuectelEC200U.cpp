@@ -12,6 +12,10 @@
 #include "QuectelEC200U.h"
 #include <ArduinoJson.h>
 
+// Bits of _bootURCs
+#define BOOT_URC_RDY 0x01
+#define BOOT_URC_SIM_READY 0x02
+
 QuectelEC200U::QuectelEC200U(HardwareSerial &serial, uint32_t baud, int8_t rxPin, int8_t txPin) {
   _serial = &serial;
   _hwSerial = &serial;
@@ -26,6 +30,25 @@ QuectelEC200U::QuectelEC200U(HardwareSerial &serial, uint32_t baud, int8_t rxPin
   _networkRegistered = false;
   _historyCount = 0;
   _historyIndex = 0;
+  _httpStatus = -1;
+  _httpContentLength = -1;
+  _httpSavedRoundTrips = 0;
+  _httpContextId = 1;
+  _httpSslContextId = 1;
+  _httpBodyLeft = 0;
+  _httpConnectMs = 0;
+  _fastBoot = false;
+  _bootURCs = 0;
+  memset(&_info, 0, sizeof(_info));
+  _initNetworkState();
+  _netURCs = false;
+  _netCallback = nullptr;
+  _netCallbackCtx = nullptr;
+  _httpInvalidateConfig();
+  _initAsync();
+  _initSockets();
+  _initMqtt(true);
+  _initMetrics();
 }
 
 QuectelEC200U::QuectelEC200U(Stream &stream) {
@@ -42,6 +65,25 @@ QuectelEC200U::QuectelEC200U(Stream &stream) {
   _networkRegistered = false;
   _historyCount = 0;
   _historyIndex = 0;
+  _httpStatus = -1;
+  _httpContentLength = -1;
+  _httpSavedRoundTrips = 0;
+  _httpContextId = 1;
+  _httpSslContextId = 1;
+  _httpBodyLeft = 0;
+  _httpConnectMs = 0;
+  _fastBoot = false;
+  _bootURCs = 0;
+  memset(&_info, 0, sizeof(_info));
+  _initNetworkState();
+  _netURCs = false;
+  _netCallback = nullptr;
+  _netCallbackCtx = nullptr;
+  _httpInvalidateConfig();
+  _initAsync();
+  _initSockets();
+  _initMqtt(true);
+  _initMetrics();
 }
 
 // ... (rest of the file) ...
@@ -97,10 +139,18 @@ bool QuectelEC200U::begin(bool forceReinit) {
   }
 #endif
 
-  delay(1000);
+  if (!_fastBoot) {
+    delay(1000);
+  }
+  if (!_addURC("RDY", _onBootURC, this, true) || !_addURC("+CPIN:", _onBootURC, this, true) ||
+      !_registerNetworkURCs()) {
+    _state = MODEM_ERROR;
+    return false;
+  }
   flushInput();
+  _httpInvalidateConfig();
 
-  if (!initializeModem()) {
+  if (!(_fastBoot ? _fastInitialize() : initializeModem())) {
     _state = MODEM_ERROR;
     logError(F("Modem initialization failed"));
     return false;
@@ -132,8 +182,8 @@ bool QuectelEC200U::initializeModem() {
     return false;
   }
 
-  // 2. ATI - Module Info
-  sendAT(F("ATI"));
+  // 2. ATI - Module Info (kept for getModuleVersion())
+  getDeviceInfo(DeviceInfoField::VERSION);
 
   // 3. ATV1 - Verbose response format
   sendAT(F("ATV1"), F("OK"));
@@ -152,17 +202,17 @@ bool QuectelEC200U::initializeModem() {
   // 6. AT+IPR? - Baudrate
   sendAT(F("AT+IPR?"));
 
-  // 7. AT+GSN - IMEI
-  sendAT(F("AT+GSN"));
+  // 7. AT+GSN - IMEI (kept for getIMEI())
+  getIMEI();
 
   // 8. AT+CPIN? - SIM Status
   sendAT(F("AT+CPIN?"));
 
-  // 9. AT+CIMI - IMSI
-  sendAT(F("AT+CIMI"));
+  // 9. AT+CIMI - IMSI (kept for getIMSI())
+  getIMSI();
 
-  // 10. AT+QCCID - ICCID
-  sendAT(F("AT+QCCID"));
+  // 10. AT+QCCID - ICCID (kept for getICCID())
+  getICCID();
 
   // 11. AT+CSQ - Signal Quality
   sendAT(F("AT+CSQ"));
@@ -206,6 +256,145 @@ bool QuectelEC200U::initializeModem() {
   return true;
 }
 
+// Fast boot: no settle delay and no informational queries. The first line the
+// module accepts also configures it, the SIM counts as ready once +CPIN: READY
+// has been seen, and the identity comes from one concatenated query.
+bool QuectelEC200U::_fastInitialize() {
+  uint32_t start = millis();
+  bool synced = false;
+  while (!synced && millis() - start < FAST_BOOT_TIMEOUT) {
+    synced = sendAT(F("ATE0V1;+CMEE=2"), F("OK"), 300);
+    if (!synced && _lastFinal != AT_TOKEN_NONE) {
+      // Answered, but rejected the concatenated line
+      sendAT(F("ATE0"));
+      synced = sendAT(F("AT+CMEE=2"));
+    }
+  }
+  if (!synced) {
+    logError(F("SYNC fail"));
+    _lastError = ErrorCode::MODEM_NOT_RESPONDING;
+    return false;
+  }
+  _echoDisabled = true;
+
+  if (!(_bootURCs & BOOT_URC_SIM_READY) && !isSimReady() &&
+      !expectURC(F("+CPIN: READY"), FAST_BOOT_SIM_TIMEOUT)) {
+    logError(F("SIM card not ready"));
+    _lastError = ErrorCode::SIM_NOT_READY;
+    return false;
+  }
+  _simChecked = true;
+
+  if (_info.imei[0] == '\0' || _info.imsi[0] == '\0' || _info.iccid[0] == '\0') {
+    _readIdentity();
+  }
+  updateNetworkStatus();
+  return true;
+}
+
+// IMEI, IMSI and ICCID in one round trip. Fields that fail stay empty and are
+// read again on first use.
+void QuectelEC200U::_readIdentity() {
+  char buf[128];
+  sendATRaw(F("AT+GSN;+CIMI;+QCCID"));
+  readResponse(buf, sizeof(buf), 1000);
+  _copyDigits(buf, 0, _info.imei, sizeof(_info.imei));
+  _copyDigits(buf, 1, _info.imsi, sizeof(_info.imsi));
+  _copyAfter(buf, "+QCCID: ", _info.iccid, sizeof(_info.iccid));
+}
+
+// Copies the nth line of 'resp' that consists of digits only
+bool QuectelEC200U::_copyDigits(const char *resp, uint8_t nth, char *dst, size_t size) {
+  const char *p = resp;
+  while (*p) {
+    while (*p == '\r' || *p == '\n') {
+      p++;
+    }
+    size_t len = 0;
+    while (isDigit(p[len])) {
+      len++;
+    }
+    bool digitsOnly = len > 0 && (p[len] == '\r' || p[len] == '\n' || p[len] == '\0');
+    if (digitsOnly && nth-- == 0) {
+      if (len >= size) {
+        return false;
+      }
+      memcpy(dst, p, len);
+      dst[len] = '\0';
+      return true;
+    }
+    while (*p && *p != '\r' && *p != '\n') {
+      p++;
+    }
+  }
+  return false;
+}
+
+// Copies the rest of the line following 'tag'
+bool QuectelEC200U::_copyAfter(const char *resp, const char *tag, char *dst, size_t size) {
+  const char *p = strstr(resp, tag);
+  if (p == nullptr) {
+    return false;
+  }
+  p += strlen(tag);
+  size_t len = 0;
+  while (p[len] && p[len] != '\r' && p[len] != '\n') {
+    len++;
+  }
+  if (len == 0 || len >= size) {
+    return false;
+  }
+  memcpy(dst, p, len);
+  dst[len] = '\0';
+  return true;
+}
+
+// Copies up to 'maxLines' information lines of 'resp' joined with '\n', skipping
+// the command echo and the final result code
+bool QuectelEC200U::_copyLines(const char *resp, uint8_t maxLines, char *dst, size_t size) {
+  size_t out = 0;
+  const char *p = resp;
+  while (*p && maxLines > 0) {
+    while (*p == '\r' || *p == '\n') {
+      p++;
+    }
+    size_t len = 0;
+    while (p[len] && p[len] != '\r' && p[len] != '\n') {
+      len++;
+    }
+    bool skip = len == 0 || strncmp(p, "AT", 2) == 0 ||
+                (len == 2 && strncmp(p, "OK", 2) == 0) || strncmp(p, "ERROR", 5) == 0 ||
+                strncmp(p, "+CME ERROR", 10) == 0;
+    if (!skip) {
+      size_t need = len + (out > 0 ? 1 : 0);
+      if (out + need >= size) {
+        break;
+      }
+      if (out > 0) {
+        dst[out++] = '\n';
+      }
+      memcpy(dst + out, p, len);
+      out += len;
+      maxLines--;
+    }
+    p += len;
+  }
+  dst[out] = '\0';
+  return out > 0;
+}
+
+// RDY and +CPIN: READY are printed by the module as it starts
+void QuectelEC200U::_onBootURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  if (strncmp(urc, "RDY", 3) == 0) {
+    self->_bootURCs |= BOOT_URC_RDY;
+  } else if (strcmp(urc, "+CPIN: READY") == 0) {
+    self->_bootURCs |= BOOT_URC_SIM_READY;
+  } else {
+    self->_bootURCs &= ~BOOT_URC_SIM_READY;
+  }
+}
+
 void QuectelEC200U::updateNetworkStatus() {
   int status = getRegistrationStatus();
   _networkRegistered = (status == 1 || status == 5);
@@ -220,6 +409,12 @@ void QuectelEC200U::sendATRaw(const String &cmd) {
     _debugSerial->print(F("CMD (Raw): "));
     _debugSerial->println(cmd);
   }
+  if (_transparentId >= 0) {
+    logError(F("AT command ignored in transparent mode"));
+    return;
+  }
+  _awaitAsyncIdle();
+  _metricBegin(cmd.c_str());
   _serial->println(cmd);
 }
 
@@ -230,17 +425,36 @@ bool QuectelEC200U::sendAT(const String &cmd, const String &expect, uint32_t tim
     _debugSerial->println(cmd);
   }
 
+  // Anything written now would be sent to the remote peer as data
+  if (_transparentId >= 0) {
+    logError(F("AT command ignored in transparent mode"));
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+
+  _awaitAsyncIdle();
+  _metricBegin(cmd.c_str());
   _serial->println(cmd);
 
+  // Data-mode commands answer with CONNECT and keep streaming afterwards, so it
+  // only ends the response when the caller is waiting for it.
+  uint32_t finalMask = AT_TOKEN_FINAL_MASK;
+  if (expect == "CONNECT") {
+    finalMask |= AT_TOKEN_MASK(AT_TOKEN_CONNECT);
+  }
+
   char buffer[256];
-  readResponse(buffer, sizeof(buffer), timeout);
+  _readResponse(buffer, sizeof(buffer), timeout, finalMask);
 
   if (_debugSerial) {
     _debugSerial->print(F("RESP: "));
     _debugSerial->println(buffer);
   }
 
-  if (strstr(buffer, expect.c_str()) != NULL) {
+  // The buffer may have filled before the final code; the tokenizer saw it
+  bool found = (expect == "OK") ? _lastFinal == AT_TOKEN_OK : strstr(buffer, expect.c_str()) != NULL;
+  _metricEnd(found, _lastFinal == AT_TOKEN_NONE);
+  if (found) {
     _lastError = ErrorCode::NONE;
     return true;
   }
@@ -268,6 +482,24 @@ bool QuectelEC200U::sendAT(const String &cmd) {
   return sendAT(cmd, F("OK"), 1000);
 }
 
+// Writes a command line built in a char buffer (no String on the data path).
+// The caller reads the response.
+bool QuectelEC200U::_writeCommand(const char *cmd) {
+  if (_debugSerial) {
+    _debugSerial->print(F("CMD: "));
+    _debugSerial->println(cmd);
+  }
+  if (_transparentId >= 0) {
+    logError(F("AT command ignored in transparent mode"));
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  _awaitAsyncIdle();
+  _metricBegin(cmd);
+  _serial->println(cmd);
+  return true;
+}
+
 
 
 [[deprecated("Use readResponse(char*, size_t, uint32_t) instead")]] String QuectelEC200U::readResponse(uint32_t timeout) {
@@ -277,246 +509,833 @@ bool QuectelEC200U::sendAT(const String &cmd) {
 }
 
 int QuectelEC200U::readResponse(char* buffer, size_t length, uint32_t timeout) {
-  size_t bytesRead = 0;
+  int n = _readResponse(buffer, length, timeout, AT_TOKEN_FINAL_MASK);
+  _metricEnd(_lastFinal != AT_TOKEN_ERROR && _lastFinal != AT_TOKEN_CME_ERROR &&
+             _lastFinal != AT_TOKEN_CMS_ERROR, _lastFinal == AT_TOKEN_NONE);
+  if (_debugSerial) {
+    _debugSerial->print(F("RESP: "));
+    _debugSerial->println(buffer);
+  }
+  return n;
+}
+
+// Every byte goes through the tokenizer exactly once; the response ends on the
+// first completed final result code in 'finalMask'. Once the buffer is full the
+// remaining bytes of the response are still consumed (and dropped) so they do not
+// leak into the next command. URCs are matched on a separate copy of each line's
+// start, so they are still dispatched after the buffer has filled up.
+int QuectelEC200U::_readResponse(char* buffer, size_t length, uint32_t timeout, uint32_t finalMask) {
+  if (length == 0) {
+    return 0;
+  }
+
+  char head[URC_LINE_MAX];
+  ATTokenizer tok;
+  tok.begin(buffer, length - 1, false);
+  tok.setLineBuffer(head, sizeof(head));
   uint32_t start = millis();
+  bool done = false;
+  _rxBusy = true;
+  _lastFinal = AT_TOKEN_NONE;
 
-  while (millis() - start < timeout && bytesRead < length - 1) {
-    while (_serial->available() && bytesRead < length - 1) {
+  while (!done && millis() - start < timeout) {
+    while (_serial->available()) {
       char c = (char)_serial->read();
-      buffer[bytesRead++] = c;
-      if (_debugSerial) {
-        _debugSerial->print(c);
+      if (_captureRaw(c)) {
+        continue;
+      }
+      ATToken t = tok.feed(c);
+      if (t == AT_TOKEN_LINE) {
+        _dispatchURC(tok.line());
+      } else if (t != AT_TOKEN_NONE && (finalMask & AT_TOKEN_MASK(t))) {
+        _lastFinal = t;
+        done = true;
+        break;
       }
-    }
-    buffer[bytesRead] = '\0';
-
-    // Exit early if we have a complete response
-    if (strstr(buffer, "\r\nOK\r\n") != NULL ||
-        strstr(buffer, "\r\nERROR\r\n") != NULL ||
-        strstr(buffer, "\r\n> ") != NULL ||
-        strstr(buffer, "+CME ERROR:") != NULL) {
-      break;
     }
 
-    // Small delay to allow buffer to fill
-    if (!_serial->available()) {
-      delay(10);
+    if (!done && !_serial->available()) {
+      delay(1);
     }
   }
 
+  _rxBusy = false;
+  size_t bytesRead = tok.stored();
+  buffer[bytesRead] = '\0';
+  if (tok.dropped() > 0) {
+    logDebug(String(F("Response truncated, dropped bytes: ")) + String((unsigned long)tok.dropped()));
+  }
   return bytesRead;
 }
 
-bool QuectelEC200U::waitForResponse(const String &expect, uint32_t timeout) {
-  String resp = readResponse(timeout);
-  return resp.indexOf(expect) != -1;
+// ===== Asynchronous AT engine =====
+// Commands are queued in a fixed ring and issued one at a time from poll(), so the
+// caller never blocks while the modem works. The blocking API shares the same UART
+// and therefore waits for the in-flight command (but not the rest of the queue).
+void QuectelEC200U::_initAsync() {
+  _asyncHead = 0;
+  _asyncCount = 0;
+  _asyncRunning = false;
+  _asyncMatched = false;
+  _asyncFinal = false;
+  _inPoll = false;
+  _asyncStart = 0;
+  _asyncBuf[0] = '\0';
+  _asyncTok.begin(_asyncBuf, sizeof(_asyncBuf) - 1, false);
+  _asyncTok.setLineBuffer(_asyncLine, sizeof(_asyncLine));
+  _nextHandle = 1;
+  _rxBusy = false;
+  _urcCount = 0;
+  _urcLibrary = 0;
+  // Only the start of a line is kept, so an overlong URC still matches its
+  // handler's prefix
+  _urcTok.begin(nullptr, 0);
+  _urcTok.setLineBuffer(_urcBuf, sizeof(_urcBuf));
+  for (size_t i = 0; i < AT_QUEUE_SIZE; i++) {
+    _statusHandle[i] = 0;
+    _statusValue[i] = ATStatus::NONE;
+  }
 }
 
-void QuectelEC200U::flushInput() {
-  while (_serial->available()) (void)_serial->read();
-}
+int QuectelEC200U::sendATAsync(const String &cmd, ATCallback callback, void *ctx, uint32_t timeout, const String &expect) {
+  if (_asyncCount >= AT_QUEUE_SIZE) {
+    logError(F("AT queue full"));
+    return -1;
+  }
+
+  int handle = _nextHandle++;
+  if (_nextHandle <= 0) {
+    _nextHandle = 1;
+  }
 
-bool QuectelEC200U::expectURC(const String &tag, uint32_t timeout) {
-  String r = readResponse(timeout);
-  return r.indexOf(tag) != -1;
+  PendingCommand &pc = _asyncQueue[(_asyncHead + _asyncCount) % AT_QUEUE_SIZE];
+  pc.cmd = cmd;
+  pc.expect = expect;
+  pc.timeout = timeout;
+  pc.callback = callback;
+  pc.ctx = ctx;
+  pc.handle = handle;
+  _asyncCount++;
+  _setATStatus(handle, ATStatus::QUEUED);
+
+  if (!_asyncRunning && !_inPoll && !_rxBusy && _transparentId < 0) {
+    _startAsync();
+  }
+  return handle;
 }
 
-// Command history implementation
-void QuectelEC200U::addToHistory(const String &cmd) {
-  if (cmd.length() == 0) return;
-  
-  // Avoid duplicates
-  if (_historyCount > 0 && _cmdHistory[_historyCount - 1] == cmd) {
+void QuectelEC200U::poll() {
+  // The UART belongs to TransparentSocket until transparentExit(); queued
+  // commands wait.
+  if (_inPoll || _transparentId >= 0) {
     return;
   }
-  
-  // Shift history if full
-  if (_historyCount >= MAX_HISTORY) {
-    for (int i = 0; i < MAX_HISTORY - 1; i++) {
-      _cmdHistory[i] = _cmdHistory[i + 1];
-    }
-    _historyCount = MAX_HISTORY - 1;
+  _inPoll = true;
+  _pumpAsync();
+  if (!_asyncRunning) {
+    _drainURCs();
+    _serviceSockets();
+    _serviceMqtt();
   }
-  
-  _cmdHistory[_historyCount++] = cmd;
-  _historyIndex = _historyCount;
-}
+  _inPoll = false;
 
-String QuectelEC200U::getFromHistory(int index) {
-  if (index >= 0 && index < _historyCount) {
-    return _cmdHistory[index];
+  if (!_asyncRunning && _asyncCount > 0) {
+    _startAsync();
   }
-  return "";
 }
 
-String QuectelEC200U::getPreviousCommand() {
-  if (_historyCount == 0) return "";
-  
-  if (_historyIndex > 0) {
-    _historyIndex--;
+ATStatus QuectelEC200U::getATStatus(int handle) const {
+  if (handle <= 0) {
+    return ATStatus::NONE;
   }
-  
-  return _cmdHistory[_historyIndex];
+  size_t slot = handle % AT_QUEUE_SIZE;
+  return _statusHandle[slot] == handle ? _statusValue[slot] : ATStatus::NONE;
 }
 
-String QuectelEC200U::getNextCommand() {
-  if (_historyCount == 0) return "";
-  
-  if (_historyIndex < _historyCount - 1) {
-    _historyIndex++;
-    return _cmdHistory[_historyIndex];
+bool QuectelEC200U::cancelAT(int handle) {
+  // The in-flight command cannot be recalled from the modem; only queued ones can.
+  size_t first = _asyncRunning ? 1 : 0;
+  for (size_t i = first; i < _asyncCount; i++) {
+    size_t idx = (_asyncHead + i) % AT_QUEUE_SIZE;
+    if (_asyncQueue[idx].handle != handle) {
+      continue;
+    }
+    PendingCommand cancelled = _asyncQueue[idx];
+    for (size_t j = i; j + 1 < _asyncCount; j++) {
+      _asyncQueue[(_asyncHead + j) % AT_QUEUE_SIZE] = _asyncQueue[(_asyncHead + j + 1) % AT_QUEUE_SIZE];
+    }
+    _asyncCount--;
+    _setATStatus(handle, ATStatus::CANCELLED);
+    if (cancelled.callback) {
+      cancelled.callback(handle, ATStatus::CANCELLED, "", cancelled.ctx);
+    }
+    return true;
   }
-  
-  _historyIndex = _historyCount;
-  return "";
-}
-
-void QuectelEC200U::clearHistory() {
-  _historyCount = 0;
-  _historyIndex = 0;
+  return false;
 }
 
-// Utility functions
-String QuectelEC200U::extractQuotedString(const char* response, const String &tag) {
-  const char* tag_c = tag.c_str();
-  const char* tagIdx = strstr(response, tag_c);
-  if (tagIdx == NULL) return "";
-
-  const char* start = strchr(tagIdx, '"');
-  if (start == NULL) return "";
-
-  const char* end = strchr(start + 1, '"');
-  if (end == NULL) return "";
-
-  int length = end - (start + 1);
-  char buffer[length + 1];
-  strncpy(buffer, start + 1, length);
-  buffer[length] = '\0';
-
-  return String(buffer);
+void QuectelEC200U::_setATStatus(int handle, ATStatus status) {
+  size_t slot = handle % AT_QUEUE_SIZE;
+  _statusHandle[slot] = handle;
+  _statusValue[slot] = status;
 }
 
-int QuectelEC200U::extractInteger(const char* response, const String &tag) {
-  const char* tag_c = tag.c_str();
-  const char* tagIdx = strstr(response, tag_c);
-  if (tagIdx == NULL) return -1;
-
-  const char* start = tagIdx + strlen(tag_c);
-  while (*start != '\0' && !isDigit(*start) && *start != '-') {
-    start++;
+void QuectelEC200U::_startAsync() {
+  PendingCommand &pc = _asyncQueue[_asyncHead];
+  if (_debugSerial) {
+    _debugSerial->print(F("CMD (Async): "));
+    _debugSerial->println(pc.cmd);
+  }
+  _asyncTok.reset();
+  _asyncBuf[0] = '\0';
+  _asyncRunning = true;
+  _asyncMatched = false;
+  _asyncFinal = false;
+  _asyncStart = millis();
+  _setATStatus(pc.handle, ATStatus::RUNNING);
+  _metricBegin(pc.cmd.c_str());
+  _serial->println(pc.cmd);
+}
+
+void QuectelEC200U::_pumpAsync() {
+  if (!_asyncRunning) {
+    return;
   }
 
-  if (*start == '\0') return -1;
+  PendingCommand &pc = _asyncQueue[_asyncHead];
+  const char *expect = pc.expect.c_str();
+  while (_serial->available()) {
+    char c = (char)_serial->read();
+    if (_captureRaw(c)) {
+      continue;
+    }
+    ATToken t = _asyncTok.feed(c);
+    if (t == AT_TOKEN_NONE) {
+      continue;
+    }
+    bool match = _asyncTok.line().startsWith(expect);
+    if (t == AT_TOKEN_LINE) {
+      // An expected information line or URC (e.g. "+QNTP: 0") completes the
+      // command together with its final result code, whichever comes last
+      if (!match) {
+        _dispatchURC(_asyncTok.line());
+        continue;
+      }
+      _asyncMatched = true;
+      if (_asyncFinal) {
+        _finishAsync(ATStatus::SUCCESS);
+        return;
+      }
+      continue;
+    }
+    if (match) {
+      _finishAsync(ATStatus::SUCCESS);
+      return;
+    }
+    if (t == AT_TOKEN_ERROR || t == AT_TOKEN_CME_ERROR || t == AT_TOKEN_CMS_ERROR ||
+        t == AT_TOKEN_SEND_FAIL || t == AT_TOKEN_NO_CARRIER) {
+      _finishAsync(ATStatus::FAILED);
+      return;
+    }
+    _asyncFinal = true;
+    if (_asyncMatched) {
+      _finishAsync(ATStatus::SUCCESS);
+      return;
+    }
+  }
 
-  return atoi(start);
+  if (millis() - _asyncStart >= pc.timeout) {
+    _finishAsync(ATStatus::TIMEOUT);
+  }
 }
 
-String QuectelEC200U::_extractFirstLine(const String &resp) const {
-  if (resp.length() == 0) {
-    return String();
-  }
+void QuectelEC200U::_finishAsync(ATStatus status) {
+  _asyncBuf[_asyncTok.stored()] = '\0';
+  PendingCommand done = _asyncQueue[_asyncHead];
+  _asyncQueue[_asyncHead].cmd = String();
+  _asyncHead = (_asyncHead + 1) % AT_QUEUE_SIZE;
+  _asyncCount--;
+  _asyncRunning = false;
 
-  int start = 0;
-  while (start < resp.length() && (resp[start] == '\r' || resp[start] == '\n')) {
-    start++;
-  }
+  _lastError = (status == ATStatus::SUCCESS) ? ErrorCode::NONE : ErrorCode::UNKNOWN;
+  _setATStatus(done.handle, status);
+  _metricEnd(status == ATStatus::SUCCESS, status == ATStatus::TIMEOUT);
 
-  if (start >= resp.length()) {
-    return String();
+  if (_debugSerial) {
+    _debugSerial->print(F("RESP (Async): "));
+    _debugSerial->println(_asyncBuf);
   }
 
-  int end = resp.indexOf('\r', start);
-  int lf = resp.indexOf('\n', start);
-  if (end == -1 || (lf != -1 && lf < end)) {
-    end = lf;
+  if (done.callback) {
+    bool wasInPoll = _inPoll;
+    _inPoll = true;
+    done.callback(done.handle, status, _asyncBuf, done.ctx);
+    _inPoll = wasInPoll;
   }
-  if (end == -1) {
-    end = resp.length();
+}
+
+// Lets a blocking call take over the UART: finishes the in-flight asynchronous
+// command without starting the next queued one.
+void QuectelEC200U::_awaitAsyncIdle() {
+  while (_asyncRunning) {
+    _pumpAsync();
+    if (_asyncRunning) {
+      delay(1);
+    }
   }
+}
 
-  String line = resp.substring(start, end);
-  line.trim();
-  return line;
+bool QuectelEC200U::waitForResponse(const String &expect, uint32_t timeout) {
+  String resp = readResponse(timeout);
+  return resp.indexOf(expect) != -1;
 }
 
-String QuectelEC200U::_collectResponse(uint32_t timeout) {
-  String resp;
+// Discards stale command output, but complete URC lines are still dispatched.
+void QuectelEC200U::flushInput() {
+  _awaitAsyncIdle();
+  _drainURCs();
+}
+
+// Waits for a line starting with 'tag'. A line that matches 'tag' up to its last
+// ',' or ' ' but differs afterwards (e.g. "+QIOPEN: 0,566" while waiting for
+// "+QIOPEN: 0,0") is a definite failure and ends the wait early, as do
+// ERROR / +CME ERROR / +CMS ERROR. The matching line is copied to 'line' if given.
+bool QuectelEC200U::expectURC(const String &tag, uint32_t timeout, char *line, size_t lineSize) {
+  const char *tagStr = tag.c_str();
+  size_t failLen = 0;
+  for (size_t i = 0; tagStr[i] != '\0'; i++) {
+    if (tagStr[i] == ',' || tagStr[i] == ' ') {
+      failLen = i + 1;
+    }
+  }
+
+  char head[URC_LINE_MAX];
+  ATTokenizer tok;
+  tok.begin(nullptr, 0);
+  tok.setLineBuffer(head, sizeof(head));
   uint32_t start = millis();
-  while (millis() - start < timeout) {
+  _rxBusy = true;
+  bool result = false;
+  bool done = false;
+
+  while (!done && millis() - start < timeout) {
     while (_serial->available()) {
       char c = (char)_serial->read();
-      resp += c;
-      if (_debugSerial) {
-        _debugSerial->print(c);
+      if (_captureRaw(c)) {
+        continue;
+      }
+      ATToken t = tok.feed(c);
+      if (t == AT_TOKEN_NONE) {
+        continue;
+      }
+      ATSlice received = tok.line();
+      if (received.startsWith(tagStr)) {
+        if (line != nullptr) {
+          received.copyTo(line, lineSize);
+        }
+        result = true;
+        done = true;
+        break;
+      }
+      if (t == AT_TOKEN_ERROR || t == AT_TOKEN_CME_ERROR || t == AT_TOKEN_CMS_ERROR) {
+        done = true;
+        break;
+      }
+      if (failLen > 0 && received.length() >= failLen) {
+        bool samePrefix = true;
+        for (size_t i = 0; i < failLen && samePrefix; i++) {
+          samePrefix = received.at(i) == tagStr[i];
+        }
+        if (samePrefix) {
+          done = true;
+          break;
+        }
+      }
+      if (t == AT_TOKEN_LINE) {
+        _dispatchURC(received);
       }
     }
 
-    if (resp.indexOf(F("\r\nOK\r\n")) != -1 || resp.indexOf(F("\r\nERROR\r\n")) != -1) {
-      break;
+    if (!done && !_serial->available()) {
+      delay(1);
     }
+  }
 
-    delay(5);
+  _rxBusy = false;
+  _metricEnd(result, !done);
+  if (_debugSerial && done) {
+    ATSlice last = tok.line();
+    _debugSerial->print(F("URC: "));
+    for (size_t i = 0; i < last.length(); i++) {
+      _debugSerial->write(last.at(i));
+    }
+    _debugSerial->println();
   }
-  return resp;
+  return result;
 }
 
-bool QuectelEC200U::_extractHttpPayload(const String &raw, String &payload) {
-  if (raw.length() == 0) {
-    payload = "";
-    return false;
-  }
+// ===== URC dispatcher =====
+// Handlers live in a small fixed table and are matched by prefix against every
+// line that reaches the receive path: blocking reads, the async engine and idle
+// poll() calls. Dispatched lines are not removed from command responses.
+bool QuectelEC200U::onURC(const char *prefix, URCHandler handler, void *ctx) {
+  return _addURC(prefix, handler, ctx, false);
+}
 
-  if (raw.indexOf(F("ERROR")) != -1) {
-    payload = raw;
+// The library's handlers count against URC_LIBRARY_HANDLERS, so onURC() calls
+// can never crowd them out
+bool QuectelEC200U::_addURC(const char *prefix, URCHandler handler, void *ctx, bool library) {
+  if (prefix == nullptr || handler == nullptr) {
     return false;
   }
-
-  int marker = raw.indexOf(F("+QHTTPREAD:"));
-  if (marker == -1) {
-    payload = raw;
-    return true;
-  }
-
-  int headerEnd = raw.indexOf(F("\r\n"), marker);
-  if (headerEnd == -1) {
-    payload = raw;
-    return true;
+  for (uint8_t i = 0; i < _urcCount; i++) {
+    if (_urcHandlers[i].handler == handler && strcmp(_urcHandlers[i].prefix, prefix) == 0) {
+      _urcHandlers[i].ctx = ctx;
+      return true;
+    }
   }
-  int dataStart = headerEnd + 2;
-  while (dataStart < (int)raw.length() && (raw[dataStart] == '\r' || raw[dataStart] == '\n')) {
-    dataStart++;
+  bool full = library ? _urcLibrary >= URC_LIBRARY_HANDLERS
+                      : _urcCount - _urcLibrary >= MAX_URC_HANDLERS;
+  if (full) {
+    logError(F("URC handler table full"));
+    return false;
   }
-
-  int okIdx = raw.indexOf(F("\r\nOK"), dataStart);
-  if (okIdx == -1) {
-    okIdx = raw.length();
+  if (library) {
+    _urcLibrary++;
   }
-
-  payload = raw.substring(dataStart, okIdx);
+  URCEntry &e = _urcHandlers[_urcCount++];
+  e.prefix = prefix;
+  e.length = (uint8_t)strlen(prefix);
+  e.handler = handler;
+  e.ctx = ctx;
   return true;
 }
 
+bool QuectelEC200U::removeURC(const char *prefix, URCHandler handler) {
+  for (uint8_t i = 0; i < _urcCount; i++) {
+    if (_urcHandlers[i].handler == handler && strcmp(_urcHandlers[i].prefix, prefix) == 0) {
+      for (uint8_t j = i; j + 1 < _urcCount; j++) {
+        _urcHandlers[j] = _urcHandlers[j + 1];
+      }
+      _urcCount--;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool QuectelEC200U::_dispatchURC(const ATSlice &line) {
+  size_t len = line.length();
+  if (len == 0 || _urcCount == 0) {
+    return false;
+  }
+
+  char first = line.at(0);
+  char copy[URC_LINE_MAX];
+  bool copied = false;
+  bool handled = false;
+
+  for (uint8_t i = 0; i < _urcCount; i++) {
+    const URCEntry &e = _urcHandlers[i];
+    if (e.prefix[0] != first || e.length > len || !line.startsWith(e.prefix)) {
+      continue;
+    }
+    if (!copied) {
+      line.copyTo(copy, sizeof(copy));
+      copied = true;
+    }
+    e.handler(copy, e.ctx);
+    handled = true;
+  }
+  return handled;
+}
+
+// Consumes whatever is waiting on the UART while no command is in flight and
+// dispatches each completed URC line.
+void QuectelEC200U::_drainURCs() {
+  _metricIdle();
+  while (_serial->available()) {
+    char c = (char)_serial->read();
+    if (_captureRaw(c)) {
+      continue;
+    }
+    if (_urcTok.feed(c) == AT_TOKEN_LINE) {
+      _dispatchURC(_urcTok.line());
+    }
+  }
+}
+
+// ===== Metrics =====
+// With EC200U_ENABLE_METRICS the UART is wrapped in a MeteredStream that charges
+// every byte to the row of the command being run (row 0 between commands).
+// Latency runs from writing the command to its final result code. The table is
+// fixed; nothing is allocated.
+#ifdef EC200U_ENABLE_METRICS
+int QuectelEC200U::MeteredStream::read() {
+  int c = inner->read();
+  if (c >= 0) {
+    owner->_metrics[owner->_metricRow].bytesReceived++;
+  }
+  return c;
+}
+
+size_t QuectelEC200U::MeteredStream::write(uint8_t b) {
+  size_t n = inner->write(b);
+  owner->_metrics[owner->_metricRow].bytesSent += n;
+  return n;
+}
+
+size_t QuectelEC200U::MeteredStream::write(const uint8_t *buf, size_t size) {
+  size_t n = inner->write(buf, size);
+  owner->_metrics[owner->_metricRow].bytesSent += n;
+  return n;
+}
+
+void QuectelEC200U::_initMetrics() {
+  _meter.inner = _serial;
+  _meter.owner = this;
+  _serial = &_meter;
+  resetMetrics();
+}
+
+void QuectelEC200U::_metricBegin(const char *cmd) {
+  // A command whose response nobody waited for ends when the next one starts
+  _metricEnd(true, false);
+
+  char name[EC200U_METRICS_CMD_LEN];
+  size_t n = 0;
+  while (n < sizeof(name) - 1 && cmd[n] != '\0' && strchr("=?;\"\r\n", cmd[n]) == nullptr) {
+    name[n] = cmd[n];
+    n++;
+  }
+  name[n] = '\0';
+
+  uint8_t row = 0;
+  for (uint8_t i = 1; i < _metricsCount; i++) {
+    if (strcmp(_metrics[i].command, name) == 0) {
+      row = i;
+      break;
+    }
+  }
+  if (row == 0) {
+    if (_metricsCount < EC200U_METRICS_SLOTS) {
+      row = _metricsCount++;
+      memcpy(_metrics[row].command, name, n + 1);
+    } else {
+      row = EC200U_METRICS_SLOTS - 1;
+      strcpy(_metrics[row].command, "*");
+    }
+  }
+
+  _metrics[row].calls++;
+  _metricRow = row;
+  _metricTiming = true;
+  _metricStart = millis();
+}
+
+void QuectelEC200U::_metricEnd(bool ok, bool timedOut) {
+  if (!_metricTiming) {
+    return;
+  }
+  _metricTiming = false;
+  ATMetrics &m = _metrics[_metricRow];
+  uint32_t elapsed = millis() - _metricStart;
+  m.totalLatencyMs += elapsed;
+  if (elapsed > m.maxLatencyMs) {
+    m.maxLatencyMs = elapsed;
+  }
+  if (timedOut) {
+    m.timeouts++;
+  } else if (!ok) {
+    m.failures++;
+  }
+}
+#endif
+
+size_t QuectelEC200U::metricsCount() const {
+#ifdef EC200U_ENABLE_METRICS
+  return _metricsCount;
+#else
+  return 0;
+#endif
+}
+
+const ATMetrics *QuectelEC200U::metrics(size_t index) const {
+#ifdef EC200U_ENABLE_METRICS
+  if (index < _metricsCount) {
+    return &_metrics[index];
+  }
+#else
+  (void)index;
+#endif
+  return nullptr;
+}
+
+const ATMetrics *QuectelEC200U::findMetrics(const char *command) const {
+#ifdef EC200U_ENABLE_METRICS
+  for (uint8_t i = 0; i < _metricsCount; i++) {
+    if (strcmp(_metrics[i].command, command) == 0) {
+      return &_metrics[i];
+    }
+  }
+#else
+  (void)command;
+#endif
+  return nullptr;
+}
+
+void QuectelEC200U::resetMetrics() {
+#ifdef EC200U_ENABLE_METRICS
+  memset(_metrics, 0, sizeof(_metrics));
+  strcpy(_metrics[0].command, "URC");
+  _metricsCount = 1;
+  _metricRow = 0;
+  _metricTiming = false;
+  _metricStart = 0;
+#endif
+}
+
+// [{"command":"AT+CSQ","calls":3,...},...], written straight to 'out'
+size_t QuectelEC200U::printMetricsJson(Print &out) const {
+  size_t n = out.print('[');
+#ifdef EC200U_ENABLE_METRICS
+  for (uint8_t i = 0; i < _metricsCount; i++) {
+    const ATMetrics &m = _metrics[i];
+    if (i > 0) {
+      n += out.print(',');
+    }
+    n += out.print(F("{\"command\":\""));
+    n += out.print(m.command);
+    n += out.print(F("\",\"calls\":"));
+    n += out.print(m.calls);
+    n += out.print(F(",\"failures\":"));
+    n += out.print(m.failures);
+    n += out.print(F(",\"timeouts\":"));
+    n += out.print(m.timeouts);
+    n += out.print(F(",\"bytes_sent\":"));
+    n += out.print(m.bytesSent);
+    n += out.print(F(",\"bytes_received\":"));
+    n += out.print(m.bytesReceived);
+    n += out.print(F(",\"latency_total_ms\":"));
+    n += out.print(m.totalLatencyMs);
+    n += out.print(F(",\"latency_max_ms\":"));
+    n += out.print(m.maxLatencyMs);
+    n += out.print('}');
+  }
+#endif
+  n += out.print(']');
+  return n;
+}
+
+// Command history implementation
+void QuectelEC200U::addToHistory(const String &cmd) {
+  if (cmd.length() == 0) return;
+  
+  // Avoid duplicates
+  if (_historyCount > 0 && _cmdHistory[_historyCount - 1] == cmd) {
+    return;
+  }
+  
+  // Shift history if full
+  if (_historyCount >= MAX_HISTORY) {
+    for (int i = 0; i < MAX_HISTORY - 1; i++) {
+      _cmdHistory[i] = _cmdHistory[i + 1];
+    }
+    _historyCount = MAX_HISTORY - 1;
+  }
+  
+  _cmdHistory[_historyCount++] = cmd;
+  _historyIndex = _historyCount;
+}
+
+String QuectelEC200U::getFromHistory(int index) {
+  if (index >= 0 && index < _historyCount) {
+    return _cmdHistory[index];
+  }
+  return "";
+}
+
+String QuectelEC200U::getPreviousCommand() {
+  if (_historyCount == 0) return "";
+  
+  if (_historyIndex > 0) {
+    _historyIndex--;
+  }
+  
+  return _cmdHistory[_historyIndex];
+}
+
+String QuectelEC200U::getNextCommand() {
+  if (_historyCount == 0) return "";
+  
+  if (_historyIndex < _historyCount - 1) {
+    _historyIndex++;
+    return _cmdHistory[_historyIndex];
+  }
+  
+  _historyIndex = _historyCount;
+  return "";
+}
+
+void QuectelEC200U::clearHistory() {
+  _historyCount = 0;
+  _historyIndex = 0;
+}
+
+// Utility functions
+String QuectelEC200U::extractQuotedString(const char* response, const String &tag) {
+  const char* tag_c = tag.c_str();
+  const char* tagIdx = strstr(response, tag_c);
+  if (tagIdx == NULL) return "";
+
+  const char* start = strchr(tagIdx, '"');
+  if (start == NULL) return "";
+
+  const char* end = strchr(start + 1, '"');
+  if (end == NULL) return "";
+
+  int length = end - (start + 1);
+  char buffer[length + 1];
+  strncpy(buffer, start + 1, length);
+  buffer[length] = '\0';
+
+  return String(buffer);
+}
+
+int QuectelEC200U::extractInteger(const char* response, const String &tag) {
+  const char* tag_c = tag.c_str();
+  const char* tagIdx = strstr(response, tag_c);
+  if (tagIdx == NULL) return -1;
+
+  const char* start = tagIdx + strlen(tag_c);
+  while (*start != '\0' && !isDigit(*start) && *start != '-') {
+    start++;
+  }
+
+  if (*start == '\0') return -1;
+
+  return atoi(start);
+}
+
+String QuectelEC200U::_extractFirstLine(const String &resp) const {
+  if (resp.length() == 0) {
+    return String();
+  }
+
+  unsigned int start = 0;
+  while (start < resp.length() && (resp[start] == '\r' || resp[start] == '\n')) {
+    start++;
+  }
+
+  if (start >= resp.length()) {
+    return String();
+  }
+
+  int end = resp.indexOf('\r', start);
+  int lf = resp.indexOf('\n', start);
+  if (end == -1 || (lf != -1 && lf < end)) {
+    end = lf;
+  }
+  if (end == -1) {
+    end = resp.length();
+  }
+
+  String line = resp.substring(start, end);
+  line.trim();
+  return line;
+}
+
+String QuectelEC200U::_collectResponse(uint32_t timeout) {
+  String resp;
+  uint32_t start = millis();
+  while (millis() - start < timeout) {
+    while (_serial->available()) {
+      resp += (char)_serial->read();
+    }
+
+    if (resp.indexOf(F("\r\nOK\r\n")) != -1 || resp.indexOf(F("\r\nERROR\r\n")) != -1) {
+      break;
+    }
+
+    delay(5);
+  }
+  bool ok = resp.indexOf(F("\r\nOK\r\n")) != -1;
+  _metricEnd(ok, !ok && resp.indexOf(F("\r\nERROR\r\n")) == -1);
+  if (_debugSerial) {
+    _debugSerial->print(F("RESP: "));
+    _debugSerial->println(resp);
+  }
+  return resp;
+}
+
+// Custom headers are only re-sent when the set differs from the one the module
+// already holds; an empty set switches "requestheader" off if it is on.
 void QuectelEC200U::_sendHttpHeaders(String headers[], size_t header_size) {
   if (headers == nullptr || header_size == 0) {
+    if (_httpCfg.requestHeader == 0) {
+      _httpSavedRoundTrips++;
+      return;
+    }
+    _httpCfg.requestHeader = sendAT(F("AT+QHTTPCFG=\"requestheader\",0")) ? 0 : -1;
+    return;
+  }
+
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < header_size; i++) {
+    hash = _hashString(headers[i], hash);
+  }
+  if (_httpCfg.requestHeader == 1 && _httpCfg.headerHash == hash) {
+    _httpSavedRoundTrips += header_size + 1;
     return;
   }
 
   logDebug(F("Sending custom HTTP headers..."));
+  // Drop the previous header set before configuring a different one
+  if (_httpCfg.requestHeader != 0) {
+    sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
+  }
   if (!sendAT(F("AT+QHTTPCFG=\"requestheader\",1"))) {
+    _httpCfg.requestHeader = -1;
     logError(F("Failed to enable custom request headers."));
     return;
   }
+  _httpCfg.requestHeader = 1;
 
+  bool allSent = true;
   for (size_t i = 0; i < header_size; i++) {
     String headerLine = headers[i];
     headerLine.trim();
     if (headerLine.length() > 0) {
       String cmd = "AT+QHTTPCFG=\"header\",\"" + headerLine + "\\r\\n\"";
       if (!sendAT(cmd)) {
+        allSent = false;
         logError(String(F("Failed to send header: ")) + headerLine);
       }
     }
   }
+  // A partial set is retried in full next time
+  _httpCfg.headerHash = hash;
+  if (!allSent) {
+    _httpCfg.requestHeader = -1;
+  }
+}
+
+void QuectelEC200U::_httpInvalidateConfig() {
+  _httpCfg.contextId = -1;
+  _httpCfg.sslContextId = -1;
+  _httpCfg.requestHeader = -1;
+  _httpCfg.headerHash = 0;
+  _httpCfg.urlHash = 0;
+  _httpCfg.urlLength = 0;
+}
+
+// FNV-1a; each string is terminated with '\n' so ["ab","c"] != ["a","bc"]
+uint32_t QuectelEC200U::_hashString(const String &s, uint32_t hash) {
+  const char *p = s.c_str();
+  for (size_t i = 0; i < s.length(); i++) {
+    hash = (hash ^ (uint8_t)p[i]) * 16777619UL;
+  }
+  return (hash ^ '\n') * 16777619UL;
 }
 
 // Modem info functions with better formatting
@@ -526,7 +1345,7 @@ String QuectelEC200U::getModemInfo() {
 
   info += F("=== Modem Information ===\n");
 
-  _serial->println(F("ATI"));
+  sendATRaw(F("ATI"));
   String model = readResponse(1000);
   int crIdx = model.indexOf('\r');
   if (crIdx > 0) {
@@ -567,7 +1386,7 @@ String QuectelEC200U::getModemInfo() {
 }
 
 String QuectelEC200U::getOperator() {
-  _serial->println(F("AT+COPS?"));
+  sendATRaw(F("AT+COPS?"));
   String resp = readResponse(1000);
   return extractQuotedString(resp.c_str(), F("+COPS:"));
 }
@@ -576,6 +1395,7 @@ bool QuectelEC200U::factoryReset() {
   logDebug(F("Performing factory reset..."));
   bool result = sendAT(F("AT&F"), F("OK"), 5000);
   if (result) {
+    _httpInvalidateConfig();
     _initialized = false;
     _echoDisabled = false;
     _simChecked = false;
@@ -591,6 +1411,7 @@ bool QuectelEC200U::factoryReset() {
 
 bool QuectelEC200U::powerOff() {
   logDebug(F("Powering off modem..."));
+  _httpInvalidateConfig();
   return sendAT(F("AT+QPOWD=1"), F("OK"), 5000);
 }
 
@@ -598,6 +1419,12 @@ bool QuectelEC200U::reboot() {
   logDebug(F("Rebooting modem..."));
   bool result = sendAT(F("AT+CFUN=1,1"), F("OK"), 5000);
   if (result) {
+    _httpInvalidateConfig();
+    _bootURCs = 0;
+    invalidateDeviceInfo();
+    _initNetworkState();
+    _netURCs = false;
+    _initMqtt(false);
     _initialized = false;
     _echoDisabled = false;
     _simChecked = false;
@@ -610,7 +1437,7 @@ bool QuectelEC200U::reboot() {
 
 // SMS utilities
 int QuectelEC200U::getSMSCount() {
-  _serial->println(F("AT+CPMS?"));
+  sendATRaw(F("AT+CPMS?"));
   String resp = readResponse(1000);
   
   int start = resp.indexOf(":") + 1;
@@ -635,34 +1462,71 @@ bool QuectelEC200U::ftpLogout() {
 
 // Filesystem utilities
 bool QuectelEC200U::fsExists(const String &path) {
-  _serial->println("AT+QFLST=\"" + path + "\"");
+  sendATRaw("AT+QFLST=\"" + path + "\"");
   String resp = readResponse(1000);
   return resp.indexOf(F("+QFLST:")) != -1;
 }
 
-// MQTT utilities
-bool QuectelEC200U::mqttDisconnect() {
-  return sendAT("AT+QMTDISC=0", "OK", 5000);
-}
-
 // ===== Core =====
 String QuectelEC200U::getIMEI() {
-  _serial->println(F("AT+GSN"));
-  String resp = readResponse(1000);
-  String imei = _extractFirstLine(resp);
-  if (imei.length() == 0) {
-    return "";
+  return String(getDeviceInfo(DeviceInfoField::IMEI));
+}
+
+// ===== Device-info cache =====
+const char *QuectelEC200U::getDeviceInfo(DeviceInfoField field) {
+  char *dst;
+  size_t size;
+  const __FlashStringHelper *cmd;
+  switch (field) {
+    case DeviceInfoField::IMEI:
+      dst = _info.imei; size = sizeof(_info.imei); cmd = F("AT+GSN"); break;
+    case DeviceInfoField::IMSI:
+      dst = _info.imsi; size = sizeof(_info.imsi); cmd = F("AT+CIMI"); break;
+    case DeviceInfoField::ICCID:
+      dst = _info.iccid; size = sizeof(_info.iccid); cmd = F("AT+QCCID"); break;
+    case DeviceInfoField::MANUFACTURER:
+      dst = _info.manufacturer; size = sizeof(_info.manufacturer); cmd = F("AT+GMI"); break;
+    case DeviceInfoField::MODEL:
+      dst = _info.model; size = sizeof(_info.model); cmd = F("AT+GMM"); break;
+    case DeviceInfoField::FIRMWARE:
+      dst = _info.firmware; size = sizeof(_info.firmware); cmd = F("AT+GMR"); break;
+    default:
+      dst = _info.version; size = sizeof(_info.version); cmd = F("ATI"); break;
   }
-  for (int i = 0; i < imei.length(); i++) {
-    if (!isDigit(imei.charAt(i))) {
-      return "";
-    }
+  if (dst[0] != '\0') {
+    return dst;
+  }
+
+  char buf[128];
+  sendATRaw(cmd);
+  readResponse(buf, sizeof(buf), 1000);
+  if (_lastFinal != AT_TOKEN_OK) {
+    return dst;
   }
-  return imei;
+  switch (field) {
+    case DeviceInfoField::IMEI:
+    case DeviceInfoField::IMSI:
+      _copyDigits(buf, 0, dst, size);
+      break;
+    case DeviceInfoField::ICCID:
+      _copyAfter(buf, "+QCCID: ", dst, size);
+      break;
+    case DeviceInfoField::VERSION:
+      _copyLines(buf, 4, dst, size);
+      break;
+    default:
+      _copyLines(buf, 1, dst, size);
+      break;
+  }
+  return dst;
+}
+
+void QuectelEC200U::invalidateDeviceInfo() {
+  memset(&_info, 0, sizeof(_info));
 }
 
 int QuectelEC200U::getSignalStrength() {
-  _serial->println(F("AT+CSQ"));
+  sendATRaw(F("AT+CSQ"));
   String resp = readResponse(1000);
   return _parseCsvInt(resp, F("+CSQ: "), 0);
 }
@@ -670,7 +1534,7 @@ int QuectelEC200U::getSignalStrength() {
 bool QuectelEC200U::setAPN(const char* apn) {
   // First check if PDP contexts are active and deactivate them
   flushInput();
-  _serial->println(F("AT+QIACT?"));
+  sendATRaw(F("AT+QIACT?"));
   String actResp = readResponse(2000);
   
   // If any context is active, deactivate all
@@ -701,7 +1565,7 @@ bool QuectelEC200U::setAPN(const char* apn) {
     
     // Query current APN settings
     flushInput();
-    _serial->println(F("AT+CGDCONT?"));
+    sendATRaw(F("AT+CGDCONT?"));
     String queryResp = readResponse(2000);
     
     // If our APN is already set, that's fine
@@ -717,27 +1581,141 @@ bool QuectelEC200U::setAPN(const char* apn) {
   return false;
 }
 
-// ===== Network + PDP =====
-bool QuectelEC200U::waitForNetwork(uint32_t timeoutMs) {
-  uint32_t start = millis();
-  while (millis() - start < timeoutMs) {
-    int status = getRegistrationStatus();
-    if (status == 1 || status == 5) {
-      logDebug(F("Network registered"));
-      return true;
-    }
-    delay(2000);
-  }
-  logError(F("Network registration timeout"));
-  return false;
+// ===== Network state tracker =====
+// Registration, signal and PDP state follow the URCs (and the replies to
+// AT+CREG?/+CGREG?/+CEREG?/+CSQ, which pass through the same handlers), so
+// reading them costs nothing once enableNetworkURCs() has run.
+void QuectelEC200U::_initNetworkState() {
+  _net.creg = -1;
+  _net.cgreg = -1;
+  _net.cereg = -1;
+  _net.csq = 99;
+  _net.pdpLost = 0;
+  _net.changedMs = 0;
 }
 
-bool QuectelEC200U::attachData(const char* apn, const char* user, const char* pass, int auth) {
-  logDebug(F("Attaching to data network..."));
-  
-  // Check current GPRS attach status
+bool QuectelEC200U::_registerNetworkURCs() {
+  return _addURC("+CREG: ", _onNetworkURC, this, true) &&
+         _addURC("+CGREG: ", _onNetworkURC, this, true) &&
+         _addURC("+CEREG: ", _onNetworkURC, this, true) &&
+         _addURC("+CSQ: ", _onNetworkURC, this, true) &&
+         _addURC("+QIND: \"csq\",", _onNetworkURC, this, true) &&
+         _addURC("+QIURC: \"pdpdeact\",", _onNetworkURC, this, true);
+}
+
+bool QuectelEC200U::enableNetworkURCs(bool signal) {
+  if (!_registerNetworkURCs()) {
+    return false;
+  }
+  if (!sendAT(F("AT+CREG=1;+CGREG=1;+CEREG=1"))) {
+    return false;
+  }
+  if (signal && !sendAT(F("AT+QINDCFG=\"csq\",1"))) {
+    return false;
+  }
+  _netURCs = true;
+  // The replies seed the state through _onNetworkURC
+  return sendAT(F("AT+CREG?;+CGREG?;+CEREG?;+CSQ"));
+}
+
+void QuectelEC200U::onNetworkChange(NetworkCallback callback, void *ctx) {
+  _netCallback = callback;
+  _netCallbackCtx = ctx;
+}
+
+void QuectelEC200U::_networkChanged(uint8_t changed) {
+  _net.changedMs = millis();
+  if (changed & NETWORK_CHANGED_REGISTRATION) {
+    bool registered = _net.creg == 1 || _net.creg == 5 || _net.cgreg == 1 || _net.cgreg == 5 ||
+                      _net.cereg == 1 || _net.cereg == 5;
+    _networkRegistered = registered;
+    if (registered && _state == MODEM_READY) {
+      _state = MODEM_NETWORK_CONNECTED;
+    } else if (!registered && _state == MODEM_NETWORK_CONNECTED) {
+      _state = MODEM_READY;
+    }
+  }
+  if (_netCallback) {
+    _netCallback(_net, changed, _netCallbackCtx);
+  }
+}
+
+void QuectelEC200U::_onNetworkURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  NetworkState &net = self->_net;
+
+  if (urc[1] == 'Q' && urc[3] == 'U') {
+    // +QIURC: "pdpdeact",<contextID>
+    int contextId = atoi(urc + 19);
+    if (contextId >= 1 && contextId <= 8 && !(net.pdpLost & (1 << (contextId - 1)))) {
+      net.pdpLost |= 1 << (contextId - 1);
+      self->_networkChanged(NETWORK_CHANGED_PDP);
+    }
+    return;
+  }
+
+  if (urc[1] == 'Q' || urc[2] == 'S') {
+    // +QIND: "csq",<rssi>,<ber> or +CSQ: <rssi>,<ber>
+    int rssi = atoi(urc + (urc[1] == 'Q' ? 13 : 6));
+    if (rssi >= 0 && rssi != net.csq) {
+      net.csq = (uint8_t)rssi;
+      self->_networkChanged(NETWORK_CHANGED_SIGNAL);
+    }
+    return;
+  }
+
+  // +CREG/+CGREG/+CEREG: the URC starts with <stat>, the query reply with <n>,<stat>
+  const char *p = strchr(urc, ':') + 2;
+  const char *comma = strchr(p, ',');
+  int stat = (comma && isDigit(comma[1])) ? atoi(comma + 1) : atoi(p);
+  int8_t *domain = urc[2] == 'R' ? &net.creg : (urc[2] == 'G' ? &net.cgreg : &net.cereg);
+  if (*domain != stat) {
+    *domain = (int8_t)stat;
+    self->_networkChanged(NETWORK_CHANGED_REGISTRATION);
+  }
+}
+
+// ===== Network + PDP =====
+bool QuectelEC200U::waitForNetwork(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  if (_netURCs) {
+    // Registration arrives as a URC; query only now and then in case one was lost
+    uint32_t lastCheck = 0;
+    bool checked = false;
+    while (millis() - start < timeoutMs) {
+      if (!checked || millis() - lastCheck >= NETWORK_RECHECK_MS) {
+        sendAT(F("AT+CREG?;+CGREG?;+CEREG?"));
+        lastCheck = millis();
+        checked = true;
+      }
+      if (_networkRegistered) {
+        logDebug(F("Network registered"));
+        return true;
+      }
+      poll();
+      delay(1);
+    }
+    logError(F("Network registration timeout"));
+    return false;
+  }
+  while (millis() - start < timeoutMs) {
+    int status = getRegistrationStatus();
+    if (status == 1 || status == 5) {
+      logDebug(F("Network registered"));
+      return true;
+    }
+    delay(2000);
+  }
+  logError(F("Network registration timeout"));
+  return false;
+}
+
+bool QuectelEC200U::attachData(const char* apn, const char* user, const char* pass, int auth) {
+  logDebug(F("Attaching to data network..."));
+  
+  // Check current GPRS attach status
   flushInput();
-  _serial->println(F("AT+CGATT?"));
+  sendATRaw(F("AT+CGATT?"));
   String attachResp = readResponse(2000);
   
   // If not attached, attach now
@@ -766,7 +1744,7 @@ bool QuectelEC200U::attachData(const char* apn, const char* user, const char* pa
     String authCmd = String("AT+QICSGP=1,1,\"") + apn + "\",\"" + user + "\",\"" + pass + "\"," + String(auth);
     
     flushInput();
-    _serial->println(authCmd);
+    sendATRaw(authCmd);
     String authResp = readResponse(2000);
     
     if (authResp.indexOf(F("OK")) == -1 && authResp.indexOf(F("Operation not allowed")) == -1) {
@@ -781,7 +1759,18 @@ bool QuectelEC200U::attachData(const char* apn, const char* user, const char* pa
 }
 
 bool QuectelEC200U::activatePDP(int ctxId) {
-  return sendAT("AT+QIACT=" + String(ctxId), "OK", 15000);
+  bool ok = sendAT("AT+QIACT=" + String(ctxId), "OK", 15000);
+  if (ok) {
+    clearPdpLost(ctxId);
+  }
+  return ok;
+}
+
+void QuectelEC200U::clearPdpLost(int contextId) {
+  if (contextId >= 1 && contextId <= 8 && (_net.pdpLost & (1 << (contextId - 1)))) {
+    _net.pdpLost &= ~(1 << (contextId - 1));
+    _networkChanged(NETWORK_CHANGED_PDP);
+  }
 }
 
 bool QuectelEC200U::deactivatePDP(int ctxId) {
@@ -789,7 +1778,7 @@ bool QuectelEC200U::deactivatePDP(int ctxId) {
 }
 
 int QuectelEC200U::getRegistrationStatus(bool eps) {
-  _serial->println(eps ? F("AT+CEREG?") : F("AT+CREG?"));
+  sendATRaw(eps ? F("AT+CEREG?") : F("AT+CREG?"));
   String resp = readResponse(1000);
   String tag = eps ? F("+CEREG: ") : F("+CREG: ");
   return _parseCsvInt(resp, tag, 1);
@@ -812,7 +1801,7 @@ bool QuectelEC200U::sendSMS(const char* number, const char* text) {
 }
 
 String QuectelEC200U::readSMS(int index) {
-  _serial->println("AT+CMGR=" + String(index));
+  sendATRaw("AT+CMGR=" + String(index));
   String resp = readResponse(2000);
   // Response is typically: +CMGR: <stat>,<oa>,<alpha>,<scts><CR><LF><data>
   // OK
@@ -830,6 +1819,45 @@ String QuectelEC200U::readSMS(int index) {
 }
 
 // ===== HTTP =====
+namespace {
+
+// Collects small writes (ArduinoJson emits a few bytes at a time) into
+// HTTP_UPLOAD_CHUNK_SIZE pieces before they go to the UART.
+class ChunkedWriter : public Print {
+  public:
+    ChunkedWriter(Stream &out) : _out(out), _len(0) {}
+    ~ChunkedWriter() { flush(); }
+
+    size_t write(uint8_t b) override {
+      _buf[_len++] = b;
+      if (_len == sizeof(_buf)) {
+        flush();
+      }
+      return 1;
+    }
+
+    size_t write(const uint8_t *data, size_t size) override {
+      for (size_t i = 0; i < size; i++) {
+        write(data[i]);
+      }
+      return size;
+    }
+
+    void flush() override {
+      if (_len > 0) {
+        _out.write(_buf, _len);
+        _len = 0;
+      }
+    }
+
+  private:
+    Stream &_out;
+    uint8_t _buf[HTTP_UPLOAD_CHUNK_SIZE];
+    size_t _len;
+};
+
+}  // namespace
+
 bool QuectelEC200U::httpGet(const String &url, String &response, String headers[], size_t header_size) {
   return _sendHttpRequest(url, "", response, headers, header_size, false, false);
 }
@@ -839,9 +1867,7 @@ bool QuectelEC200U::httpPost(const String &url, const String &data, String &resp
 }
 
 bool QuectelEC200U::httpPost(const String &url, const JsonDocument &json, String &response, String headers[], size_t header_size) {
-  String data;
-  serializeJson(json, data);
-  return httpPost(url, data, response, headers, header_size);
+  return _httpPostJson(url, json, response, headers, header_size, false);
 }
 
 // ===== HTTPS =====
@@ -854,9 +1880,85 @@ bool QuectelEC200U::httpsPost(const String &url, const String &data, String &res
 }
 
 bool QuectelEC200U::httpsPost(const String &url, const JsonDocument &json, String &response, String headers[], size_t header_size) {
-  String data;
-  serializeJson(json, data);
-  return httpsPost(url, data, response, headers, header_size);
+  return _httpPostJson(url, json, response, headers, header_size, true);
+}
+
+// ===== Streaming HTTP(S) =====
+bool QuectelEC200U::httpGetStream(const String &url, HttpBodyCallback onBody, void *ctx, String headers[], size_t header_size) {
+  return _httpGetStream(url, onBody, ctx, headers, header_size, false);
+}
+
+bool QuectelEC200U::httpGetStream(const String &url, Print &sink, String headers[], size_t header_size) {
+  return _httpGetStream(url, _printBodySink, &sink, headers, header_size, false);
+}
+
+bool QuectelEC200U::httpsGetStream(const String &url, HttpBodyCallback onBody, void *ctx, String headers[], size_t header_size) {
+  return _httpGetStream(url, onBody, ctx, headers, header_size, true);
+}
+
+bool QuectelEC200U::httpsGetStream(const String &url, Print &sink, String headers[], size_t header_size) {
+  return _httpGetStream(url, _printBodySink, &sink, headers, header_size, true);
+}
+
+bool QuectelEC200U::httpPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[], size_t header_size) {
+  return _httpPostStream(url, length, source, ctx, response, headers, header_size, false);
+}
+
+bool QuectelEC200U::httpPostStream(const String &url, Stream &body, size_t length, String &response, String headers[], size_t header_size) {
+  return _httpPostStream(url, length, _streamBodySource, &body, response, headers, header_size, false);
+}
+
+bool QuectelEC200U::httpsPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[], size_t header_size) {
+  return _httpPostStream(url, length, source, ctx, response, headers, header_size, true);
+}
+
+bool QuectelEC200U::httpsPostStream(const String &url, Stream &body, size_t length, String &response, String headers[], size_t header_size) {
+  return _httpPostStream(url, length, _streamBodySource, &body, response, headers, header_size, true);
+}
+
+void QuectelEC200U::setHttpContext(int contextId, int sslContextId) {
+  _httpContextId = contextId;
+  _httpSslContextId = sslContextId;
+}
+
+// ===== HTTP POST in steps =====
+bool QuectelEC200U::httpPostBegin(const String &url, size_t length, String headers[], size_t header_size) {
+  _httpBodyLeft = 0;
+  bool ssl = url.startsWith("https://") || url.startsWith("HTTPS://");
+  if (!_httpBegin(url, headers, header_size, ssl) || !_httpPostBegin(length)) {
+    return false;
+  }
+  _httpBodyLeft = length;
+  _httpConnectMs = millis();
+  return true;
+}
+
+// Writes no more than the announced length: the module would take any excess
+// as the next command
+size_t QuectelEC200U::httpPostWrite(const uint8_t *data, size_t length) {
+  if (length > _httpBodyLeft) {
+    length = _httpBodyLeft;
+  }
+  size_t n = length > 0 ? _serial->write(data, length) : 0;
+  _httpBodyLeft -= n;
+  return n;
+}
+
+bool QuectelEC200U::httpPostEnd(String *response) {
+  if (_httpBodyLeft > 0) {
+    _httpBodyLeft = 0;
+    _httpPostAbort(_httpConnectMs);
+    _lastError = ErrorCode::HTTP_POST_DATA_WRITE_FAILED;
+    return false;
+  }
+  if (!_httpPostEnd()) {
+    return false;
+  }
+  if (response == nullptr) {
+    return true;
+  }
+  *response = "";
+  return _httpFinish(true, *response);
 }
 
 ErrorCode QuectelEC200U::getLastError() {
@@ -895,12 +1997,49 @@ String QuectelEC200U::getLastErrorString() {
 }
 
 bool QuectelEC200U::_sendHttpRequest(const String &url, const String &data, String &response, String headers[], size_t header_size, bool ssl, bool isPost) {
-  if (!sendAT(F("AT+QHTTPCFG=\"contextid\",1"))) {
+  response = "";
+  if (!_httpBegin(url, headers, header_size, ssl)) {
+    return false;
+  }
+  bool sent = isPost ? _httpPost(data) : _httpGet();
+  return _httpFinish(sent, response) && response.length() > 0;
+}
+
+// Reads the response of a request that has been sent into 'response' (reserved
+// once from Content-Length).
+bool QuectelEC200U::_httpFinish(bool sent, String &response) {
+  if (!sent) {
+    return false;
+  }
+  if (_httpContentLength > 0) {
+    response.reserve(_httpContentLength);
+  }
+  bool ok = _httpRead(_stringBodySink, &response, 30000);
+  if (!ok) {
+    _lastError = ErrorCode::HTTP_READ_FAILED;
+  }
+  return ok;
+}
+
+// Brings the module's HTTP configuration to what this request needs. Settings
+// and the URL it already holds are skipped and counted in _httpSavedRoundTrips.
+bool QuectelEC200U::_httpBegin(const String &url, String headers[], size_t header_size, bool ssl) {
+  if (_httpCfg.contextId == _httpContextId) {
+    _httpSavedRoundTrips++;
+  } else if (sendAT("AT+QHTTPCFG=\"contextid\"," + String(_httpContextId))) {
+    _httpCfg.contextId = _httpContextId;
+  } else {
+    _httpInvalidateConfig();
     _lastError = ErrorCode::HTTP_CONTEXT_ID_FAILED;
     return false;
   }
   if (ssl) {
-    if (!sendAT(F("AT+QHTTPCFG=\"sslctxid\",1"))) {
+    if (_httpCfg.sslContextId == _httpSslContextId) {
+      _httpSavedRoundTrips++;
+    } else if (sendAT("AT+QHTTPCFG=\"sslctxid\"," + String(_httpSslContextId))) {
+      _httpCfg.sslContextId = _httpSslContextId;
+    } else {
+      _httpInvalidateConfig();
       _lastError = ErrorCode::HTTP_SSL_CONTEXT_ID_FAILED;
       return false;
     }
@@ -908,9 +2047,15 @@ bool QuectelEC200U::_sendHttpRequest(const String &url, const String &data, Stri
 
   _sendHttpHeaders(headers, header_size);
 
+  uint32_t urlHash = _hashString(url);
+  if (_httpCfg.urlLength == url.length() && _httpCfg.urlHash == urlHash) {
+    _httpSavedRoundTrips++;
+    return true;
+  }
+  _httpCfg.urlLength = 0;
+
   // Use a 10-second timeout for the URL
   if (!sendAT("AT+QHTTPURL=" + String(url.length()) + ",10", F("CONNECT"))) {
-    sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
     _lastError = ErrorCode::HTTP_URL_FAILED;
     return false;
   }
@@ -925,52 +2070,262 @@ bool QuectelEC200U::_sendHttpRequest(const String &url, const String &data, Stri
   }
 
   if (!expectURC(F("OK"), 5000)) {
-    sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
     _lastError = ErrorCode::HTTP_URL_WRITE_FAILED;
     return false;
   }
+  _httpCfg.urlHash = urlHash;
+  _httpCfg.urlLength = url.length();
+  return true;
+}
 
-  if (isPost) {
-    String cmd = "AT+QHTTPPOST=" + String(data.length()) + ",60,60";
-    if (!sendAT(cmd, F("CONNECT"))) {
-      sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
-      _lastError = ErrorCode::HTTP_POST_FAILED;
-      return false;
+bool QuectelEC200U::_httpGet() {
+  _httpStatus = -1;
+  _httpContentLength = -1;
+  if (!sendAT(F("AT+QHTTPGET=60"), F("OK"), 15000)) {
+    _lastError = ErrorCode::HTTP_GET_FAILED;
+    return false;
+  }
+  char line[64];
+  if (!expectURC(F("+QHTTPGET:"), 20000, line, sizeof(line)) || !_parseHttpResult(line + 10)) {
+    _lastError = ErrorCode::HTTP_GET_URC_FAILED;
+    return false;
+  }
+  return true;
+}
+
+bool QuectelEC200U::_httpPost(const String &data) {
+  if (!_httpPostBegin(data.length())) {
+    return false;
+  }
+  _serial->print(data);
+  return _httpPostEnd();
+}
+
+bool QuectelEC200U::_httpPostBegin(size_t length) {
+  _httpStatus = -1;
+  _httpContentLength = -1;
+  String cmd = "AT+QHTTPPOST=" + String((unsigned long)length) + "," + String(HTTP_POST_INPUT_TIME) + ",60";
+  if (!sendAT(cmd, F("CONNECT"))) {
+    _lastError = ErrorCode::HTTP_POST_FAILED;
+    return false;
+  }
+  return true;
+}
+
+// Called once all announced body bytes have been written after CONNECT
+bool QuectelEC200U::_httpPostEnd() {
+  if (!expectURC(F("OK"), 10000)) {
+    _lastError = ErrorCode::HTTP_POST_DATA_WRITE_FAILED;
+    return false;
+  }
+  char line[64];
+  if (!expectURC(F("+QHTTPPOST:"), 20000, line, sizeof(line)) || !_parseHttpResult(line + 11)) {
+    _lastError = ErrorCode::HTTP_POST_URC_FAILED;
+    return false;
+  }
+  return true;
+}
+
+// The body came up short: the module is still in data mode and would take the
+// next command as body bytes. Padding would post a corrupted body, so wait for
+// the module to drop the upload when the input time runs out; it then answers
+// with an error and is back in command mode, its HTTP state unknown.
+void QuectelEC200U::_httpPostAbort(uint32_t connectMs) {
+  uint32_t limit = HTTP_POST_INPUT_TIME * 1000UL + 5000;
+  uint32_t elapsed = millis() - connectMs;
+  char buf[64];
+  logError(F("HTTP body ended early, waiting for the module to drop the upload"));
+  _readResponse(buf, sizeof(buf), elapsed < limit ? limit - elapsed : 0, AT_TOKEN_FINAL_MASK);
+  _httpInvalidateConfig();
+}
+
+// The module expects exactly 'length' bytes after CONNECT; a source that runs
+// dry early costs the rest of the input time (see _httpPostAbort()).
+bool QuectelEC200U::_httpPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[], size_t header_size, bool ssl) {
+  response = "";
+  if (source == nullptr || !_httpBegin(url, headers, header_size, ssl)) {
+    return false;
+  }
+  bool sent = _httpPostBegin(length);
+  if (sent) {
+    uint32_t connectMs = millis();
+    uint8_t chunk[HTTP_UPLOAD_CHUNK_SIZE];
+    size_t written = 0;
+    while (written < length) {
+      size_t want = length - written;
+      if (want > sizeof(chunk)) {
+        want = sizeof(chunk);
+      }
+      size_t got = source(chunk, want, ctx);
+      if (got == 0) {
+        break;
+      }
+      if (got > want) {
+        got = want;
+      }
+      _serial->write(chunk, got);
+      written += got;
     }
-    _serial->print(data);
-    if (!expectURC(F("OK"), 10000)) {
-      sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
+    if (written < length) {
+      _httpPostAbort(connectMs);
       _lastError = ErrorCode::HTTP_POST_DATA_WRITE_FAILED;
-      return false;
+      sent = false;
+    } else {
+      sent = _httpPostEnd();
     }
-    if (!expectURC(F("+QHTTPPOST:"), 20000)) {
-      sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
-      _lastError = ErrorCode::HTTP_POST_URC_FAILED;
-      return false;
+  }
+  return _httpFinish(sent, response);
+}
+
+// measureJson() gives the length up front, so the document is serialized
+// directly onto the UART and never exists as a String.
+bool QuectelEC200U::_httpPostJson(const String &url, const JsonDocument &json, String &response, String headers[], size_t header_size, bool ssl) {
+  response = "";
+  if (!_httpBegin(url, headers, header_size, ssl)) {
+    return false;
+  }
+  bool sent = _httpPostBegin(measureJson(json));
+  if (sent) {
+    ChunkedWriter writer(*_serial);
+    serializeJson(json, writer);
+    writer.flush();
+    sent = _httpPostEnd();
+  }
+  return _httpFinish(sent, response) && response.length() > 0;
+}
+
+size_t QuectelEC200U::_streamBodySource(uint8_t *buffer, size_t maxLen, void *ctx) {
+  return ((Stream *)ctx)->readBytes(buffer, maxLen);
+}
+
+// "<err>,<httprspcode>[,<content_length>]" from +QHTTPGET / +QHTTPPOST
+bool QuectelEC200U::_parseHttpResult(const char *fields) {
+  int err = atoi(fields);
+  const char *p = strchr(fields, ',');
+  if (p != NULL) {
+    _httpStatus = atoi(p + 1);
+    p = strchr(p + 1, ',');
+    if (p != NULL) {
+      _httpContentLength = atol(p + 1);
     }
-  } else {
-    if (!sendAT(F("AT+QHTTPGET=60"), F("OK"), 15000)) {
-      sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
-      _lastError = ErrorCode::HTTP_GET_FAILED;
-      return false;
+  }
+  return err == 0;
+}
+
+// AT+QHTTPREAD answers CONNECT, the raw body, then OK and +QHTTPREAD: <err>.
+// With a known Content-Length exactly that many bytes are passed through;
+// otherwise the body ends at the "OK ... +QHTTPREAD: " trailer, which is held
+// back while it is still being matched. Either way only one chunk is buffered.
+bool QuectelEC200U::_httpRead(HttpBodyCallback onBody, void *ctx, uint32_t timeout) {
+  uint32_t waitSec = timeout / 1000;
+  if (waitSec == 0) {
+    waitSec = 1;
+  }
+  if (!sendAT("AT+QHTTPREAD=" + String(waitSec), F("CONNECT"), timeout)) {
+    return false;
+  }
+
+  static const char kTrailer[] = "\r\nOK\r\n\r\n+QHTTPREAD: ";
+  const size_t trailerLen = sizeof(kTrailer) - 1;
+  bool counted = _httpContentLength >= 0;
+  size_t remaining = counted ? (size_t)_httpContentLength : 0;
+  uint8_t chunk[HTTP_STREAM_CHUNK_SIZE];
+  size_t n = 0;
+  char match[sizeof(kTrailer)];
+  size_t matched = 0;
+  bool deliver = true;
+  bool done = counted && remaining == 0;
+  // A mismatching trailer candidate can release up to trailerLen bytes at once
+  size_t flushAt = counted ? sizeof(chunk) : sizeof(chunk) - trailerLen;
+  uint32_t lastByte = millis();
+
+  _rxBusy = true;
+  while (!done && millis() - lastByte < timeout) {
+    if (!_serial->available()) {
+      delay(1);
+      continue;
     }
-    if (!expectURC(F("+QHTTPGET:"), 20000)) {
-      sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
-      _lastError = ErrorCode::HTTP_GET_URC_FAILED;
-      return false;
+    while (!done && _serial->available()) {
+      char c = (char)_serial->read();
+      lastByte = millis();
+      if (counted) {
+        chunk[n++] = (uint8_t)c;
+        done = --remaining == 0;
+      } else {
+        match[matched++] = c;
+        while (matched > 0 && memcmp(match, kTrailer, matched) != 0) {
+          chunk[n++] = (uint8_t)match[0];
+          memmove(match, match + 1, --matched);
+        }
+        done = matched == trailerLen;
+      }
+      if (done || n >= flushAt) {
+        if (n > 0 && deliver) {
+          deliver = onBody(chunk, n, ctx);
+        }
+        n = 0;
+      }
     }
   }
+  _rxBusy = false;
 
-  sendAT(F("AT+QHTTPREAD"));
-  String raw = _collectResponse(30000);
-  bool ok = _extractHttpPayload(raw, response);
+  if (!done) {
+    return false;
+  }
+  int err = -1;
+  char line[32];
+  if (counted) {
+    if (expectURC(F("+QHTTPREAD:"), 5000, line, sizeof(line))) {
+      err = atoi(line + 11);
+    }
+  } else {
+    // The trailer has been consumed up to the error code
+    size_t len = 0;
+    uint32_t start = millis();
+    while (millis() - start < 5000) {
+      int c = _serial->read();
+      if (c < 0) {
+        delay(1);
+        continue;
+      }
+      if (c == '\n') {
+        break;
+      }
+      if (len < sizeof(line) - 1) {
+        line[len++] = (char)c;
+      }
+    }
+    line[len] = '\0';
+    if (len > 0) {
+      err = atoi(line);
+    }
+  }
+  return err == 0 && deliver;
+}
 
-  sendAT(F("AT+QHTTPCFG=\"requestheader\",0"));
-  if (!ok || response.indexOf(F("ERROR")) != -1) {
-    _lastError = ErrorCode::HTTP_READ_FAILED;
+bool QuectelEC200U::_httpGetStream(const String &url, HttpBodyCallback onBody, void *ctx, String headers[], size_t header_size, bool ssl) {
+  if (onBody == nullptr) {
     return false;
   }
-  return response.length() > 0;
+  if (!_httpBegin(url, headers, header_size, ssl)) {
+    return false;
+  }
+  if (!_httpGet()) {
+    return false;
+  }
+  bool ok = _httpRead(onBody, ctx, 30000);
+  if (!ok) {
+    _lastError = ErrorCode::HTTP_READ_FAILED;
+  }
+  return ok;
+}
+
+bool QuectelEC200U::_printBodySink(const uint8_t *data, size_t len, void *ctx) {
+  return ((Print *)ctx)->write(data, len) == len;
+}
+
+bool QuectelEC200U::_stringBodySink(const uint8_t *data, size_t len, void *ctx) {
+  return ((String *)ctx)->concat((const char *)data, len);
 }
 
 // ===== TCP sockets =====
@@ -978,84 +2333,1046 @@ int QuectelEC200U::tcpOpen(const String &host, int port, int ctxId, int socketId
   String cmd = "AT+QIOPEN=" + String(ctxId) + "," + String(socketId) + ",\"TCP\",\"" + host + "\"," + String(port) + ",0,1";
   if (!sendAT(cmd, F("OK"), 5000)) return -1;
   if (!expectURC("+QIOPEN: " + String(socketId) + ",0", 15000)) return -1;
+  if (!_socketAttach(socketId, SOCKET_CONNECTED, SOCKET_ACCESS_PUSH)) return -1;
   return socketId;
 }
 
 bool QuectelEC200U::tcpSend(int socketId, const String &data) {
-  String cmd = "AT+QISEND=" + String(socketId) + "," + String(data.length());
-  if (!sendAT(cmd, F("> "), 2000)) return false;
-  _serial->print(data);
-  
-  // Wait for "SEND OK"
-  String resp = readResponse(5000);
-  return resp.indexOf(F("SEND OK")) != -1;
+  return tcpWrite(socketId, (const uint8_t *)data.c_str(), data.length()) == data.length();
 }
 
 bool QuectelEC200U::tcpRecv(int socketId, String &out, size_t bytes, uint32_t timeout) {
-  _serial->println("AT+QIRD=" + String(socketId) + "," + String(bytes));
-  String resp = readResponse(timeout);
-  
-  // Response is typically: +QIRD: <len>\r\n<data>
-  String tag = F("+QIRD: ");
-  int tag_index = resp.indexOf(tag);
-  if (tag_index == -1) {
-    return false;
+  out = "";
+  out.reserve(bytes);
+  uint8_t chunk[128];
+  while (bytes > 0) {
+    size_t n = tcpRead(socketId, chunk, bytes < sizeof(chunk) ? bytes : sizeof(chunk), out.length() ? 0 : timeout);
+    if (n == 0) {
+      break;
+    }
+    out.concat((const char *)chunk, n);
+    bytes -= n;
   }
+  return out.length() > 0;
+}
 
-  int len_start = tag_index + tag.length();
-  int len_end = resp.indexOf('\r', len_start);
-  if (len_end == -1) {
-    return false;
+size_t QuectelEC200U::tcpWrite(int socketId, const uint8_t *data, size_t length, uint32_t timeout) {
+  if (!_validSocket(socketId)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return 0;
   }
-  String len_str = resp.substring(len_start, len_end);
-  len_str.trim();
-  int len = len_str.toInt();
+  return _sendData(socketId, data, length, timeout);
+}
 
-  if (len > 0) {
-    int data_start = len_end + 2; // Skip \r\n
-    out = resp.substring(data_start, data_start + len);
-    return true;
+size_t QuectelEC200U::tcpRead(int socketId, uint8_t *buffer, size_t length, uint32_t timeout) {
+  if (!_validSocket(socketId) || length == 0) {
+    return 0;
   }
-  
-  return false;
+  SocketSlot &sock = _sockets[socketId];
+  uint32_t start = millis();
+  bool pulled = false;
+  do {
+    // Data already in the socket ring (pushed, or pulled by poll()) comes first
+    if (sock.rxCount > 0) {
+      return (size_t)socketRead(socketId, buffer, length);
+    }
+    // Buffer access mode: read the module's buffer straight into the caller's
+    if (sock.accessMode == SOCKET_ACCESS_BUFFER && (!pulled || sock.dataPending)) {
+      pulled = true;
+      size_t want = length < SOCKET_READ_MAX ? length : SOCKET_READ_MAX;
+      int n = _readQIRD(socketId, buffer, want, 2000);
+      if (n > 0) {
+        sock.dataPending = ((size_t)n == want);
+        return (size_t)n;
+      }
+      sock.dataPending = false;
+    }
+    if (millis() - start >= timeout) {
+      break;
+    }
+    poll();
+    delay(1);
+  } while (sock.state != SOCKET_CLOSED);
+  return 0;
 }
 
 bool QuectelEC200U::tcpClose(int socketId) {
-  return sendAT("AT+QICLOSE=" + String(socketId), "OK", 5000);
+  bool ok = sendAT("AT+QICLOSE=" + String(socketId), "OK", 5000);
+  _socketRelease(socketId);
+  return ok;
+}
+
+// ===== Socket manager =====
+// Tracks all connectIDs. Incoming data is announced by +QIURC: "recv" and lands
+// in a per-socket ring: pushed bytes are captured straight from the UART in
+// direct push mode, buffered data is pulled with AT+QIRD from poll() or on read.
+void QuectelEC200U::_initSockets() {
+  for (int i = 0; i < EC200U_MAX_SOCKETS; i++) {
+    SocketSlot &sock = _sockets[i];
+    sock.state = SOCKET_CLOSED;
+    sock.accessMode = SOCKET_ACCESS_BUFFER;
+    sock.datagram = false;
+    sock.tls = false;
+    sock.dataPending = false;
+    sock.error = 0;
+    sock.rx = nullptr;
+    sock.rxHead = 0;
+    sock.rxCount = 0;
+    sock.rxOverflow = 0;
+  }
+  _socketURCsRegistered = false;
+  _acceptCount = 0;
+  _acceptCallback = nullptr;
+  _acceptCtx = nullptr;
+  _rawSocket = -1;
+  _rawRemaining = 0;
+  _sendPipelining = true;
+  memset(&_sendStats, 0, sizeof(_sendStats));
+  _transparentId = -1;
+  _transparentLastTx = 0;
+  _transparentCarrier = 0;
+}
+
+// Retried on the next attach until every handler is in
+bool QuectelEC200U::_registerSocketURCs() {
+  if (!_socketURCsRegistered) {
+    _socketURCsRegistered = _addURC("+QIOPEN:", _onSocketOpenURC, this, true) &&
+                            _addURC("+QSSLOPEN:", _onSocketOpenURC, this, true) &&
+                            _addURC("+QIURC: \"", _onSocketEventURC, this, true) &&
+                            _addURC("+QSSLURC: \"", _onSocketEventURC, this, true);
+  }
+  return _socketURCsRegistered;
 }
 
-// ===== USSD =====
-bool QuectelEC200U::sendUSSD(const String &code, String &response) {
-  _serial->println("AT+CUSD=1,\"" + code + "\",15");
-  String resp = readResponse(15000); // Increased timeout
-  
-  if (resp.indexOf(F("OK")) != -1 && resp.indexOf(F("+CUSD:")) != -1) {
-    int urc_start = resp.indexOf(F("+CUSD:"));
-    response = resp.substring(urc_start);
-    return true;
-  }
-  
-  return false;
+bool QuectelEC200U::_validSocket(int socketId) const {
+  return socketId >= 0 && socketId < EC200U_MAX_SOCKETS;
 }
 
-// ===== NTP / Clock =====
-bool QuectelEC200U::ntpSync(const String &server, int timezone, int contextID, int port) {
-    if (server.length() == 0) {
-        return false;
-    }
-    if (timezone < -48 || timezone > 56) {
-        return false;
-    }
-    String cmd = "AT+QNTP=" + String(contextID) + ",\"" + server + "\"," + String(port) + "," + String(timezone);
-    if (!sendAT(cmd, F("OK"), 1000)) return false;
-    return expectURC(F("+QNTP: 0"), 125000);
+// Fails only for a bad id or when the socket URC handlers could not be added,
+// in which case the slot would never hear of its data
+bool QuectelEC200U::_socketAttach(int socketId, SocketState state, int accessMode) {
+  if (!_validSocket(socketId) || !_registerSocketURCs()) {
+    return false;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  if (sock.rx == nullptr) {
+    sock.rx = (uint8_t *)malloc(SOCKET_RX_BUFFER_SIZE);
+  }
+  sock.state = state;
+  sock.accessMode = (uint8_t)accessMode;
+  sock.datagram = false;
+  sock.tls = false;
+  sock.dataPending = false;
+  sock.error = 0;
+  sock.rxHead = 0;
+  sock.rxCount = 0;
+  sock.rxOverflow = 0;
+  return true;
 }
 
-String QuectelEC200U::getClock() {
-  _serial->println(F("AT+CCLK?"));
-  String resp = readResponse(1000);
-  // Response is typically: +CCLK: "yy/MM/dd,HH:mm:ss±zz"
-  // OK
+void QuectelEC200U::_socketRelease(int socketId) {
+  if (!_validSocket(socketId)) {
+    return;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  free(sock.rx);
+  sock.rx = nullptr;
+  sock.state = SOCKET_CLOSED;
+  sock.dataPending = false;
+  sock.rxHead = 0;
+  sock.rxCount = 0;
+  if (_rawSocket == socketId) {
+    _rawRemaining = 0;
+    _rawSocket = -1;
+  }
+  if (_transparentId == socketId) {
+    _transparentId = -1;
+  }
+  // Closed before anyone accepted it
+  for (uint8_t i = 0; i < _acceptCount; i++) {
+    if (_accepts[i].socketId == socketId) {
+      memmove(&_accepts[i], &_accepts[i + 1], (_acceptCount - i - 1) * sizeof(PendingAccept));
+      _acceptCount--;
+      break;
+    }
+  }
+}
+
+size_t QuectelEC200U::_socketPush(int socketId, const uint8_t *data, size_t len) {
+  SocketSlot &sock = _sockets[socketId];
+  if (sock.rx == nullptr) {
+    sock.rxOverflow += len;
+    return 0;
+  }
+  size_t stored = 0;
+  while (stored < len && sock.rxCount < SOCKET_RX_BUFFER_SIZE) {
+    sock.rx[(sock.rxHead + sock.rxCount) % SOCKET_RX_BUFFER_SIZE] = data[stored++];
+    sock.rxCount++;
+  }
+  sock.rxOverflow += len - stored;
+  return stored;
+}
+
+// Bytes announced by a direct-push URC follow its line immediately and are
+// routed to the socket ring before the tokenizer ever sees them.
+bool QuectelEC200U::_captureRaw(char c) {
+  if (_rawRemaining == 0) {
+    return false;
+  }
+  _rawRemaining--;
+  uint8_t b = (uint8_t)c;
+  _socketPush(_rawSocket, &b, 1);
+  return true;
+}
+
+// Reads one AT+QIRD response, copying exactly the announced number of bytes
+// into 'dst'. Returns the byte count, or -1 on error or timeout. A UDP SERVICE
+// answers "+QIRD: <len>,<ip>,<port>"; the sender goes to 'remoteIp'/'remotePort'.
+int QuectelEC200U::_readQIRD(int socketId, uint8_t *dst, size_t maxLen, uint32_t timeout,
+                             char *remoteIp, size_t ipSize, uint16_t *remotePort) {
+  if (maxLen > SOCKET_READ_MAX) {
+    maxLen = SOCKET_READ_MAX;
+  }
+  // TLS sockets: AT+QSSLRECV, answered like AT+QIRD
+  const char *header = _sockets[socketId].tls ? "+QSSLRECV:" : "+QIRD:";
+  size_t headerLen = strlen(header);
+  char cmd[32];
+  snprintf(cmd, sizeof(cmd), "AT%s=%d,%u", _sockets[socketId].tls ? "+QSSLRECV" : "+QIRD", socketId, (unsigned)maxLen);
+  if (!_writeCommand(cmd)) {
+    return -1;
+  }
+
+  char head[URC_LINE_MAX];
+  ATTokenizer tok;
+  tok.begin(nullptr, 0);
+  tok.setLineBuffer(head, sizeof(head));
+  uint32_t start = millis();
+  int announced = -1;
+  size_t got = 0;
+  int result = -1;
+  bool done = false;
+  _rxBusy = true;
+
+  while (!done && millis() - start < timeout) {
+    while (_serial->available()) {
+      if (announced > 0 && got < (size_t)announced) {
+        dst[got++] = (uint8_t)_serial->read();
+        continue;
+      }
+      char c = (char)_serial->read();
+      if (_captureRaw(c)) {
+        continue;
+      }
+      ATToken t = tok.feed(c);
+      if (t == AT_TOKEN_NONE) {
+        continue;
+      }
+      if (t == AT_TOKEN_ERROR || t == AT_TOKEN_CME_ERROR || t == AT_TOKEN_CMS_ERROR) {
+        done = true;
+        break;
+      }
+      if (t == AT_TOKEN_OK && announced >= 0) {
+        result = (int)got;
+        done = true;
+        break;
+      }
+      ATSlice line = tok.line();
+      if (announced < 0 && line.startsWith(header)) {
+        char field[64];
+        line.copyTo(field, sizeof(field));
+        announced = atoi(field + headerLen);
+        if (announced < 0 || (size_t)announced > maxLen) {
+          done = true;
+          break;
+        }
+        if (remoteIp != nullptr && ipSize > 0) {
+          remoteIp[0] = '\0';
+          const char *open = strchr(field, '"');
+          const char *close = open ? strchr(open + 1, '"') : nullptr;
+          if (close != nullptr) {
+            size_t n = (size_t)(close - open - 1) < ipSize - 1 ? (size_t)(close - open - 1) : ipSize - 1;
+            memcpy(remoteIp, open + 1, n);
+            remoteIp[n] = '\0';
+          }
+        }
+        if (remotePort != nullptr) {
+          const char *comma = strrchr(field, ',');
+          *remotePort = (comma != nullptr && strchr(field, '"') != nullptr) ? (uint16_t)atoi(comma + 1) : 0;
+        }
+      } else if (t == AT_TOKEN_LINE) {
+        _dispatchURC(line);
+      }
+    }
+
+    if (!done && !_serial->available()) {
+      delay(1);
+    }
+  }
+
+  _rxBusy = false;
+  return result;
+}
+
+bool QuectelEC200U::_socketFill(int socketId) {
+  SocketSlot &sock = _sockets[socketId];
+  if (sock.rx == nullptr || sock.rxCount >= SOCKET_RX_BUFFER_SIZE) {
+    return false;
+  }
+  size_t tail = (sock.rxHead + sock.rxCount) % SOCKET_RX_BUFFER_SIZE;
+  size_t space = SOCKET_RX_BUFFER_SIZE - sock.rxCount;
+  size_t contiguous = SOCKET_RX_BUFFER_SIZE - tail;
+  size_t want = space < contiguous ? space : contiguous;
+  if (want > SOCKET_READ_MAX) {
+    want = SOCKET_READ_MAX;
+  }
+
+  int n = _readQIRD(socketId, sock.rx + tail, want, 2000);
+  if (n < 0) {
+    return false;
+  }
+  sock.rxCount += n;
+  // The module stays silent until its buffer is emptied, so keep pulling while
+  // reads come back full.
+  sock.dataPending = ((size_t)n == want);
+  return n > 0;
+}
+
+void QuectelEC200U::_serviceSockets() {
+  if (!_rxBusy) {
+    _reportAccepts();
+  }
+  for (int i = 0; i < EC200U_MAX_SOCKETS; i++) {
+    SocketSlot &sock = _sockets[i];
+    if (sock.dataPending && !sock.datagram && sock.rxCount < SOCKET_RX_BUFFER_SIZE) {
+      _socketFill(i);
+      return;  // One AT+QIRD per poll() keeps the caller responsive
+    }
+  }
+}
+
+// Splits 'buf' into AT+QISEND frames of up to SOCKET_SEND_MAX bytes. When
+// pipelining, the next AT+QISEND goes out right behind the current payload:
+// the module queues it on its UART and answers "> " straight after SEND OK,
+// which saves a round trip per frame. A frame answered with SEND FAIL is
+// rewound; the prompt already requested is filled from the rewound position,
+// so the stream stays in order, and the send stops there. Each frame is one
+// metrics call ending on its SEND OK; a pipelined frame's call starts there,
+// since the module only takes its AT+QISEND up after that.
+size_t QuectelEC200U::_sendData(int socketId, const uint8_t *buf, size_t len, uint32_t timeout) {
+  uint32_t start = millis();
+  _sendStats.bytes = 0;
+  _sendStats.frames = 0;
+  _sendStats.failed = 0;
+  _sendStats.elapsedMs = 0;
+  _sendStats.bytesPerSecond = 0;
+  if (len == 0) {
+    return 0;
+  }
+
+  size_t written = 0;
+  size_t frame = len < SOCKET_SEND_MAX ? len : SOCKET_SEND_MAX;
+  if (!_sendFrame(socketId, frame)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return 0;
+  }
+
+  char resp[64];
+  char cmd[32];
+  bool more = true;
+  while (true) {
+    _serial->write(buf + written, frame);
+    written += frame;
+    size_t next = 0;
+    if (_sendPipelining && more && written < len) {
+      next = len - written < SOCKET_SEND_MAX ? len - written : SOCKET_SEND_MAX;
+      snprintf(cmd, sizeof(cmd), "AT%s=%d,%u", _sockets[socketId].tls ? "+QSSLSEND" : "+QISEND", socketId, (unsigned)next);
+      _serial->println(cmd);
+    }
+
+    _readResponse(resp, sizeof(resp), timeout, AT_TOKEN_FINAL_MASK);
+    _metricEnd(_lastFinal == AT_TOKEN_SEND_OK, _lastFinal == AT_TOKEN_NONE);
+    if (_lastFinal == AT_TOKEN_SEND_OK) {
+      _sendStats.bytes += frame;
+      _sendStats.frames++;
+    } else {
+      written -= frame;
+      _sendStats.failed++;
+      _lastError = ErrorCode::TCP_ERROR;
+      more = false;
+    }
+
+    if (next == 0) {
+      if (!more || written >= len) {
+        break;
+      }
+      // Not pipelining: request the next frame now
+      next = len - written < SOCKET_SEND_MAX ? len - written : SOCKET_SEND_MAX;
+      if (!_sendFrame(socketId, next)) {
+        _lastError = ErrorCode::TCP_ERROR;
+        break;
+      }
+    } else {
+      _metricBegin(cmd);
+      _readResponse(resp, sizeof(resp), 2000, AT_TOKEN_FINAL_MASK);
+      if (_lastFinal != AT_TOKEN_PROMPT) {
+        _metricEnd(false, _lastFinal == AT_TOKEN_NONE);
+        _lastError = ErrorCode::TCP_ERROR;
+        break;
+      }
+    }
+    frame = next;
+  }
+
+  _sendStats.elapsedMs = millis() - start;
+  if (_sendStats.elapsedMs > 0) {
+    _sendStats.bytesPerSecond = (uint32_t)((uint64_t)_sendStats.bytes * 1000 / _sendStats.elapsedMs);
+  }
+  return _sendStats.bytes;
+}
+
+// Issues AT+QISEND for one frame and waits for the "> " prompt. A UDP SERVICE
+// names the destination of each datagram. On success the metrics call stays
+// open for the caller to end on SEND OK.
+bool QuectelEC200U::_sendFrame(int socketId, size_t length, const char *ip, uint16_t port) {
+  char cmd[80];
+  if (ip != nullptr) {
+    snprintf(cmd, sizeof(cmd), "AT+QISEND=%d,%u,\"%s\",%u", socketId, (unsigned)length, ip, (unsigned)port);
+  } else {
+    snprintf(cmd, sizeof(cmd), "AT%s=%d,%u", _sockets[socketId].tls ? "+QSSLSEND" : "+QISEND", socketId, (unsigned)length);
+  }
+  if (!_writeCommand(cmd)) {
+    return false;
+  }
+  char resp[64];
+  _readResponse(resp, sizeof(resp), 2000, AT_TOKEN_FINAL_MASK);
+  if (_lastFinal != AT_TOKEN_PROMPT) {
+    _metricEnd(false, _lastFinal == AT_TOKEN_NONE);
+    return false;
+  }
+  return true;
+}
+
+int QuectelEC200U::socketOpen(const String &host, int port, int socketId, int ctxId, int accessMode) {
+  if (socketId < 0) {
+    socketId = findFreeSocket();
+  }
+  // A slot in use is refused: attaching would reset a live connection
+  if (!_validSocket(socketId) || _sockets[socketId].state != SOCKET_CLOSED) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+
+  // Mark the slot first: +QIOPEN may arrive while the OK is still being read
+  if (!_socketAttach(socketId, SOCKET_OPENING, accessMode)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  String cmd = "AT+QIOPEN=" + String(ctxId) + "," + String(socketId) + ",\"TCP\",\"" + host + "\"," + String(port) + ",0," + String(accessMode);
+  if (!sendAT(cmd, F("OK"), 5000)) {
+    _socketRelease(socketId);
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  return socketId;
+}
+
+bool QuectelEC200U::socketWaitConnected(int socketId, uint32_t timeout) {
+  if (!_validSocket(socketId)) {
+    return false;
+  }
+  uint32_t start = millis();
+  while (_sockets[socketId].state == SOCKET_OPENING && millis() - start < timeout) {
+    poll();
+    delay(1);
+  }
+  return _sockets[socketId].state == SOCKET_CONNECTED;
+}
+
+SocketState QuectelEC200U::socketState(int socketId) const {
+  return _validSocket(socketId) ? _sockets[socketId].state : SOCKET_CLOSED;
+}
+
+int QuectelEC200U::socketError(int socketId) const {
+  return _validSocket(socketId) ? _sockets[socketId].error : -1;
+}
+
+int QuectelEC200U::findFreeSocket() const {
+  for (int i = 0; i < EC200U_MAX_SOCKETS; i++) {
+    if (_sockets[i].state == SOCKET_CLOSED) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+size_t QuectelEC200U::socketAvailable(int socketId) {
+  if (!_validSocket(socketId)) {
+    return 0;
+  }
+  if (!_inPoll && !_rxBusy) {
+    poll();
+  }
+  SocketSlot &sock = _sockets[socketId];
+  if (sock.rxCount == 0 && sock.dataPending && !sock.datagram && !_rxBusy) {
+    _awaitAsyncIdle();
+    _socketFill(socketId);
+  }
+  return sock.rxCount;
+}
+
+int QuectelEC200U::socketRead(int socketId, uint8_t *buf, size_t len) {
+  if (socketAvailable(socketId) == 0) {
+    return 0;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  size_t n = 0;
+  while (n < len && sock.rxCount > 0) {
+    buf[n++] = sock.rx[sock.rxHead];
+    sock.rxHead = (sock.rxHead + 1) % SOCKET_RX_BUFFER_SIZE;
+    sock.rxCount--;
+  }
+  return (int)n;
+}
+
+int QuectelEC200U::socketPeek(int socketId) {
+  if (socketAvailable(socketId) == 0) {
+    return -1;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  return sock.rx[sock.rxHead];
+}
+
+size_t QuectelEC200U::socketWrite(int socketId, const uint8_t *buf, size_t len, uint32_t timeout) {
+  if (socketState(socketId) != SOCKET_CONNECTED) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return 0;
+  }
+  return _sendData(socketId, buf, len, timeout);
+}
+
+bool QuectelEC200U::socketClose(int socketId) {
+  if (!_validSocket(socketId)) {
+    return false;
+  }
+  bool ok = true;
+  if (_sockets[socketId].state != SOCKET_CLOSED) {
+    ok = _sockets[socketId].tls ? sendAT("AT+QSSLCLOSE=" + String(socketId) + ",10", F("OK"), 12000)
+                                : sendAT("AT+QICLOSE=" + String(socketId), F("OK"), 10000);
+  }
+  _socketRelease(socketId);
+  return ok;
+}
+
+int QuectelEC200U::socketOpenAsync(const String &host, int port, int socketId, int ctxId, int accessMode, ATCallback callback, void *ctx) {
+  if (!_validSocket(socketId) || _sockets[socketId].state != SOCKET_CLOSED) {
+    return -1;
+  }
+  if (!_socketAttach(socketId, SOCKET_OPENING, accessMode)) {
+    return -1;
+  }
+  int handle = sendATAsync("AT+QIOPEN=" + String(ctxId) + "," + String(socketId) + ",\"TCP\",\"" + host + "\"," + String(port) + ",0," + String(accessMode),
+                           callback, ctx, 5000);
+  if (handle < 0) {
+    _socketRelease(socketId);
+  }
+  return handle;
+}
+
+void QuectelEC200U::socketDiscard(int socketId, bool closeOnModule) {
+  if (!_validSocket(socketId)) {
+    return;
+  }
+  _socketRelease(socketId);
+  if (closeOnModule) {
+    sendATAsync("AT+QICLOSE=" + String(socketId), nullptr, nullptr, 10000);
+  }
+}
+
+size_t QuectelEC200U::socketRxCount(int socketId) const {
+  return _validSocket(socketId) ? _sockets[socketId].rxCount : 0;
+}
+
+// +QIOPEN: <connectID>,<err>
+// +QSSLOPEN: <clientID>,<err>
+void QuectelEC200U::_onSocketOpenURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  const char *p = strchr(urc, ':') + 1;
+  int id = atoi(p);
+  const char *comma = strchr(p, ',');
+  if (!self->_validSocket(id) || comma == NULL) {
+    return;
+  }
+  SocketSlot &sock = self->_sockets[id];
+  if (sock.state != SOCKET_OPENING) {
+    return;
+  }
+  int err = atoi(comma + 1);
+  if (err == 0) {
+    sock.state = SOCKET_CONNECTED;
+  } else {
+    self->_socketRelease(id);
+    sock.error = err;
+  }
+}
+
+// +QIURC: "<event>",... and +QSSLURC: "<event>",...: one handler per prefix
+// routes recv, closed and incoming; other events (pdpdeact) are not for sockets
+void QuectelEC200U::_onSocketEventURC(const char *urc, void *ctx) {
+  const char *event = strchr(urc, '"') + 1;
+  if (strncmp(event, "recv\",", 6) == 0) {
+    _onSocketRecvURC(urc, ctx);
+  } else if (strncmp(event, "closed\",", 8) == 0) {
+    _onSocketClosedURC(urc, ctx);
+  } else if (strncmp(event, "incoming\",", 10) == 0 && urc[2] == 'I') {
+    _onSocketIncomingURC(urc, ctx);
+  }
+}
+
+// +QIURC: "recv",<connectID>                 (buffer access mode)
+// +QIURC: "recv",<connectID>,<length>...     (direct push mode, data follows)
+// +QSSLURC: "recv",... has the same form.
+void QuectelEC200U::_onSocketRecvURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  const char *p = strchr(urc, ',') + 1;
+  int id = atoi(p);
+  if (!self->_validSocket(id)) {
+    return;
+  }
+  const char *comma = strchr(p, ',');
+  if (comma != NULL) {
+    self->_rawSocket = id;
+    self->_rawRemaining = (size_t)atoi(comma + 1);
+  } else {
+    self->_sockets[id].dataPending = true;
+  }
+}
+
+// +QIURC: "closed",<connectID> / +QSSLURC: "closed",<clientID>
+void QuectelEC200U::_onSocketClosedURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  int id = atoi(strchr(urc, ',') + 1);
+  if (self->_validSocket(id) && self->_sockets[id].state != SOCKET_CLOSED) {
+    self->_sockets[id].state = SOCKET_REMOTE_CLOSED;
+  }
+}
+
+// +QIURC: "incoming",<connectID>,<serverID>,"<remoteIP>",<remote_port>
+void QuectelEC200U::_onSocketIncomingURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  const char *p = urc + 19;
+  int id = atoi(p);
+  const char *comma = strchr(p, ',');
+  if (!self->_validSocket(id) || comma == NULL) {
+    return;
+  }
+  int listener = atoi(comma + 1);
+  char ip[16] = "";
+  const char *open = strchr(comma, '"');
+  const char *close = open ? strchr(open + 1, '"') : NULL;
+  if (close != NULL) {
+    size_t n = (size_t)(close - open - 1) < sizeof(ip) - 1 ? (size_t)(close - open - 1) : sizeof(ip) - 1;
+    memcpy(ip, open + 1, n);
+    ip[n] = '\0';
+  }
+  const char *last = strrchr(p, ',');
+  uint16_t port = (close != NULL && last > close) ? (uint16_t)atoi(last + 1) : 0;
+
+  int accessMode = self->_validSocket(listener) ? self->_sockets[listener].accessMode : SOCKET_ACCESS_BUFFER;
+  // Queued even for an onSocketAccept() callback: the URC may arrive in the
+  // middle of another command's response, so poll() hands it over
+  if (!self->_socketAttach(id, SOCKET_CONNECTED, accessMode) || self->_acceptCount >= SOCKET_ACCEPT_QUEUE) {
+    self->socketDiscard(id, true);
+    return;
+  }
+  PendingAccept &a = self->_accepts[self->_acceptCount++];
+  a.listener = (int8_t)listener;
+  a.socketId = (int8_t)id;
+  a.port = port;
+  memcpy(a.ip, ip, sizeof(a.ip));
+}
+
+// ===== UDP sockets =====
+// Datagram boundaries and senders only survive AT+QIRD, so UDP sockets stay in
+// buffer access mode and bypass the socket ring: poll() notes the "recv" URC
+// and udpReceive() pulls one datagram per AT+QIRD into the caller's buffer.
+int QuectelEC200U::udpOpen(uint16_t localPort, int socketId, int ctxId) {
+  socketId = _openService("UDP SERVICE", "127.0.0.1", 0, localPort, socketId, ctxId, SOCKET_ACCESS_BUFFER);
+  if (socketId >= 0) {
+    _sockets[socketId].datagram = true;
+  }
+  return socketId;
+}
+
+int QuectelEC200U::udpConnect(const String &host, int port, int socketId, int ctxId) {
+  socketId = _openService("UDP", host, port, 0, socketId, ctxId, SOCKET_ACCESS_BUFFER);
+  if (socketId >= 0) {
+    _sockets[socketId].datagram = true;
+  }
+  return socketId;
+}
+
+// Opens a service that needs no handshake (UDP, TCP LISTENER) and waits for
+// its +QIOPEN, which follows at once
+int QuectelEC200U::_openService(const char *service, const String &host, int port, uint16_t localPort, int socketId, int ctxId, int accessMode) {
+  if (socketId < 0) {
+    socketId = findFreeSocket();
+  }
+  if (!_validSocket(socketId) || _sockets[socketId].state != SOCKET_CLOSED) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+
+  if (!_socketAttach(socketId, SOCKET_OPENING, accessMode)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  String cmd = "AT+QIOPEN=" + String(ctxId) + "," + String(socketId) + ",\"" + service + "\",\"" + host + "\"," + String(port) + "," + String(localPort) + "," + String(accessMode);
+  if (!sendAT(cmd, F("OK"), 5000)) {
+    _socketRelease(socketId);
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  if (!socketWaitConnected(socketId, 5000)) {
+    socketClose(socketId);
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  return socketId;
+}
+
+bool QuectelEC200U::udpSend(int socketId, const uint8_t *data, size_t length, uint32_t timeout) {
+  return udpSendTo(socketId, nullptr, 0, data, length, timeout);
+}
+
+bool QuectelEC200U::udpSendTo(int socketId, const char *ip, uint16_t port, const uint8_t *data, size_t length, uint32_t timeout) {
+  if (socketState(socketId) != SOCKET_CONNECTED || !_sockets[socketId].datagram || length == 0 || length > SOCKET_SEND_MAX) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  if (!_sendFrame(socketId, length, ip, port)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  _serial->write(data, length);
+  char resp[32];
+  _readResponse(resp, sizeof(resp), timeout, AT_TOKEN_FINAL_MASK);
+  _metricEnd(_lastFinal == AT_TOKEN_SEND_OK, _lastFinal == AT_TOKEN_NONE);
+  if (_lastFinal != AT_TOKEN_SEND_OK) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  return true;
+}
+
+int QuectelEC200U::udpReceive(int socketId, uint8_t *buffer, size_t length, char *remoteIp, size_t ipSize,
+                              uint16_t *remotePort, uint32_t timeout) {
+  if (!_validSocket(socketId) || !_sockets[socketId].datagram || length == 0) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return -1;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  uint32_t start = millis();
+  while (true) {
+    if (!_inPoll && !_rxBusy) {
+      poll();
+    }
+    if (sock.dataPending && !_rxBusy) {
+      int n = _readQIRD(socketId, buffer, length, 2000, remoteIp, ipSize, remotePort);
+      if (n != 0) {
+        return n;
+      }
+      // Drained; the module announces the next datagram with a new "recv"
+      sock.dataPending = false;
+    }
+    if (sock.state == SOCKET_CLOSED || millis() - start >= timeout) {
+      return 0;
+    }
+    delay(1);
+  }
+}
+
+// ===== TCP listener =====
+// The module accepts connections on its own and reports each with
+// +QIURC: "incoming". The new connectID is served by the socket manager like
+// any client connection: its ring is filled from poll(), so several sessions
+// run side by side.
+int QuectelEC200U::tcpListen(uint16_t localPort, int socketId, int ctxId, int accessMode) {
+  socketId = _openService("TCP LISTENER", "127.0.0.1", 0, localPort, socketId, ctxId, accessMode);
+  if (socketId >= 0) {
+    _sockets[socketId].state = SOCKET_LISTENING;
+  }
+  return socketId;
+}
+
+int QuectelEC200U::socketAccept(int listenerId, char *remoteIp, size_t ipSize, uint16_t *remotePort) {
+  if (!_inPoll && !_rxBusy) {
+    poll();
+  }
+  for (uint8_t i = 0; i < _acceptCount; i++) {
+    PendingAccept &a = _accepts[i];
+    if (a.listener != listenerId) {
+      continue;
+    }
+    int id = a.socketId;
+    if (remoteIp != nullptr && ipSize > 0) {
+      strncpy(remoteIp, a.ip, ipSize - 1);
+      remoteIp[ipSize - 1] = '\0';
+    }
+    if (remotePort != nullptr) {
+      *remotePort = a.port;
+    }
+    memmove(&_accepts[i], &_accepts[i + 1], (_acceptCount - i - 1) * sizeof(PendingAccept));
+    _acceptCount--;
+    return id;
+  }
+  return -1;
+}
+
+// Oldest first; each connection leaves the queue before its callback runs
+void QuectelEC200U::_reportAccepts() {
+  while (_acceptCallback && _acceptCount > 0) {
+    PendingAccept a = _accepts[0];
+    _acceptCount--;
+    memmove(&_accepts[0], &_accepts[1], _acceptCount * sizeof(PendingAccept));
+    _acceptCallback(a.listener, a.socketId, a.ip, a.port, _acceptCtx);
+  }
+}
+
+void QuectelEC200U::onSocketAccept(SocketAcceptCallback callback, void *ctx) {
+  _acceptCallback = callback;
+  _acceptCtx = ctx;
+}
+
+// ===== TLS sockets =====
+// AT+QSSLOPEN clients share the connectID space and the socket manager with
+// AT+QIOPEN: the slot is flagged 'tls' and the data path swaps AT+QISEND and
+// AT+QIRD for AT+QSSLSEND and AT+QSSLRECV, so socketRead()/socketWrite(),
+// tcpRead()/tcpWrite() and QuectelClient work unchanged.
+int QuectelEC200U::sslOpen(const String &host, int port, int sslCtxId, int socketId, int ctxId, int accessMode) {
+  if (socketId < 0) {
+    socketId = findFreeSocket();
+  }
+  // A slot in use is refused: attaching would reset a live connection
+  if (!_validSocket(socketId) || _sockets[socketId].state != SOCKET_CLOSED ||
+      accessMode == SOCKET_ACCESS_TRANSPARENT) {
+    _lastError = ErrorCode::SSL_ERROR;
+    return -1;
+  }
+
+  // Mark the slot first: +QSSLOPEN may arrive while the OK is still being read
+  if (!_socketAttach(socketId, SOCKET_OPENING, accessMode)) {
+    _lastError = ErrorCode::SSL_ERROR;
+    return -1;
+  }
+  _sockets[socketId].tls = true;
+  String cmd = "AT+QSSLOPEN=" + String(ctxId) + "," + String(sslCtxId) + "," + String(socketId) + ",\"" + host + "\"," + String(port) + "," + String(accessMode);
+  if (!sendAT(cmd, F("OK"), 5000)) {
+    _socketRelease(socketId);
+    _lastError = ErrorCode::SSL_ERROR;
+    return -1;
+  }
+  return socketId;
+}
+
+// With the cache on, the module keeps the session of each server it talked to
+// and offers it on the next AT+QSSLOPEN, which then skips the certificate
+// exchange and key agreement.
+bool QuectelEC200U::sslSetSessionResumption(int sslCtxId, bool enable) {
+  return sendAT("AT+QSSLCFG=\"session_cache\"," + String(sslCtxId) + "," + String(enable ? 1 : 0));
+}
+
+bool QuectelEC200U::sslSetSNI(int sslCtxId, bool enable) {
+  return sendAT("AT+QSSLCFG=\"sni\"," + String(sslCtxId) + "," + String(enable ? 1 : 0));
+}
+
+bool QuectelEC200U::sslSetNegotiateTimeout(int sslCtxId, uint16_t seconds) {
+  return sendAT("AT+QSSLCFG=\"negotiatetime\"," + String(sslCtxId) + "," + String(seconds));
+}
+
+// ===== Transparent access mode =====
+// After CONNECT the UART carries raw socket data in both directions and no AT
+// command can be sent. poll(), sendAT() and the async queue stand aside until
+// transparentExit() has escaped with "+++" or the module reported NO CARRIER.
+bool QuectelEC200U::transparentEnter(int socketId, uint32_t timeout) {
+  if (_transparentId >= 0) {
+    return _transparentId == socketId;
+  }
+  // AT+QISWTMD only switches AT+QIOPEN sockets
+  if (socketState(socketId) != SOCKET_CONNECTED || _sockets[socketId].tls) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  // Data the module still holds in buffer mode is emitted right after CONNECT
+  if (!sendAT("AT+QISWTMD=" + String(socketId) + ",2", F("CONNECT"), timeout)) {
+    _lastError = ErrorCode::TCP_ERROR;
+    return false;
+  }
+  SocketSlot &sock = _sockets[socketId];
+  sock.accessMode = SOCKET_ACCESS_TRANSPARENT;
+  sock.dataPending = false;
+  _transparentId = socketId;
+  _transparentLastTx = millis();
+  _transparentCarrier = 0;
+  return true;
+}
+
+// Escape sequence: no data for 'guardTime' ms, "+++", no data for 'guardTime' ms,
+// then OK. Bytes that arrive from the peer meanwhile are kept in the socket ring;
+// afterwards the socket is in buffer access mode.
+bool QuectelEC200U::transparentExit(uint32_t guardTime) {
+  if (_transparentId < 0) {
+    return true;
+  }
+  int id = _transparentId;
+  static const char kOk[] = "\r\nOK\r\n";
+  const size_t okLen = sizeof(kOk) - 1;
+  char match[sizeof(kOk)];
+  size_t matched = 0;
+
+  _serial->flush();
+  uint32_t quietFrom = millis();
+  if (quietFrom - _transparentLastTx >= guardTime) {
+    quietFrom -= guardTime;
+  }
+  bool escaped = false;
+  uint32_t deadline = guardTime * 2 + 2000;
+  uint32_t start = millis();
+  while (millis() - start < deadline) {
+    if (!escaped && millis() - quietFrom >= guardTime) {
+      _serial->print(F("+++"));
+      escaped = true;
+    }
+    while (_serial->available()) {
+      char c = (char)_serial->read();
+      if (!escaped) {
+        _socketPush(id, (const uint8_t *)&c, 1);
+        continue;
+      }
+      match[matched++] = c;
+      // Keep only the longest tail that can still grow into "\r\nOK\r\n"
+      while (matched > 0 && memcmp(match, kOk, matched) != 0) {
+        _socketPush(id, (const uint8_t *)match, 1);
+        memmove(match, match + 1, --matched);
+      }
+      if (matched == okLen) {
+        _transparentId = -1;
+        _sockets[id].accessMode = SOCKET_ACCESS_BUFFER;
+        _lastError = ErrorCode::NONE;
+        return true;
+      }
+    }
+    delay(1);
+  }
+  _socketPush(id, (const uint8_t *)match, matched);
+  _lastError = ErrorCode::TCP_ERROR;
+  return false;
+}
+
+// NO CARRIER in transparent mode: the peer closed and the module is back in
+// command mode on its own.
+void QuectelEC200U::_transparentClosed() {
+  if (_transparentId < 0) {
+    return;
+  }
+  SocketSlot &sock = _sockets[_transparentId];
+  sock.state = SOCKET_REMOTE_CLOSED;
+  sock.accessMode = SOCKET_ACCESS_BUFFER;
+  _transparentId = -1;
+}
+
+int QuectelEC200U::transparentAvailable() {
+  return _transparentId >= 0 ? _serial->available() : 0;
+}
+
+// The module announces a peer close with NO CARRIER and drops back to command
+// mode. The line itself has already been handed to the caller as data.
+size_t QuectelEC200U::transparentRead(uint8_t *buf, size_t size) {
+  static const char kNoCarrier[] = "\r\nNO CARRIER\r\n";
+  size_t n = 0;
+  while (n < size && _transparentId >= 0 && _serial->available() > 0) {
+    int c = _serial->read();
+    if (c < 0) {
+      break;
+    }
+    buf[n++] = (uint8_t)c;
+    if (c == kNoCarrier[_transparentCarrier]) {
+      _transparentCarrier++;
+      if (kNoCarrier[_transparentCarrier] == '\0') {
+        _transparentCarrier = 0;
+        _transparentClosed();
+      }
+    } else {
+      _transparentCarrier = (c == '\r') ? 1 : 0;
+    }
+  }
+  return n;
+}
+
+int QuectelEC200U::transparentPeek() {
+  return _transparentId >= 0 ? _serial->peek() : -1;
+}
+
+size_t QuectelEC200U::transparentWrite(const uint8_t *buf, size_t size) {
+  if (_transparentId < 0) {
+    return 0;
+  }
+  size_t n = _serial->write(buf, size);
+  _transparentLastTx = millis();
+  return n;
+}
+
+void QuectelEC200U::transparentFlush() {
+  if (_transparentId >= 0) {
+    _serial->flush();
+    _transparentLastTx = millis();
+  }
+}
+
+// ===== USSD =====
+bool QuectelEC200U::sendUSSD(const String &code, String &response) {
+  sendATRaw("AT+CUSD=1,\"" + code + "\",15");
+  String resp = readResponse(15000); // Increased timeout
+  
+  if (resp.indexOf(F("OK")) != -1 && resp.indexOf(F("+CUSD:")) != -1) {
+    int urc_start = resp.indexOf(F("+CUSD:"));
+    response = resp.substring(urc_start);
+    return true;
+  }
+  
+  return false;
+}
+
+// ===== NTP / Clock =====
+bool QuectelEC200U::ntpSync(const String &server, int timezone, int contextID, int port) {
+    if (server.length() == 0) {
+        return false;
+    }
+    if (timezone < -48 || timezone > 56) {
+        return false;
+    }
+    String cmd = "AT+QNTP=" + String(contextID) + ",\"" + server + "\"," + String(port) + "," + String(timezone);
+    if (!sendAT(cmd, F("OK"), 1000)) return false;
+    return expectURC(F("+QNTP: 0"), 125000);
+}
+
+// Completes with SUCCESS once "+QNTP: 0" (synchronised) is reported; any other
+// outcome surfaces as FAILED or TIMEOUT. The response carries the +QNTP URC.
+int QuectelEC200U::ntpSyncAsync(const String &server, int timezone, ATCallback callback, void *ctx, int contextID, int port) {
+    if (server.length() == 0) {
+        return -1;
+    }
+    if (timezone < -48 || timezone > 56) {
+        return -1;
+    }
+    String cmd = "AT+QNTP=" + String(contextID) + ",\"" + server + "\"," + String(port) + "," + String(timezone);
+    return sendATAsync(cmd, callback, ctx, 125000, F("+QNTP: 0"));
+}
+
+String QuectelEC200U::getClock() {
+  sendATRaw(F("AT+CCLK?"));
+  String resp = readResponse(1000);
+  // Response is typically: +CCLK: "yy/MM/dd,HH:mm:ss±zz"
+  // OK
   String tag = F("+CCLK: ");
   int tag_index = resp.indexOf(tag);
   if (tag_index == -1) return "";
@@ -1089,7 +3406,7 @@ bool QuectelEC200U::setGNSSConfig(const String &item, const String &value) {
 }
 
 String QuectelEC200U::getNMEASentence(const String &type) {
-  _serial->println(String("AT+QGPSGNMEA=") + type);
+  sendATRaw(String("AT+QGPSGNMEA=") + type);
   String resp = readResponse(1500);
   // Response is typically: +QGPSGNMEA: <nmea_sentence>
   // OK
@@ -1105,7 +3422,7 @@ String QuectelEC200U::getNMEASentence(const String &type) {
 }
 
 String QuectelEC200U::getGNSSLocation() {
-  _serial->println(F("AT+QGPSLOC=2"));
+  sendATRaw(F("AT+QGPSLOC=2"));
   String resp = readResponse(2000);
   // Response is typically: +QGPSLOC: <latitude>,<longitude>,...
   // OK
@@ -1129,161 +3446,976 @@ String QuectelEC200U::getGNSSLocation(uint32_t fixWaitMs) {
     }
     delay(1000);
   }
-  return String();
+  return String();
+}
+
+// ===== TTS =====
+bool QuectelEC200U::playTTS(const char* text) {
+  return sendAT(String("AT+QTTS=1,\"") + text + "\"");
+}
+
+// ===== FTP =====
+bool QuectelEC200U::ftpLogin(const String &server, const String &user, const String &pass) {
+  if (!sendAT("AT+QFTPCFG=\"account\",\"" + user + "\",\"" + pass + "\"")) return false;
+  return sendAT("AT+QFTPOPEN=\"" + server + "\",21", F("+QFTP"), 15000);
+}
+
+bool QuectelEC200U::ftpDownload(const String &filename, String &data) {
+  sendATRaw("AT+QFTPGET=\"" + filename + "\"");
+  String resp = readResponse(10000);
+  
+  // Response is typically:
+  // +QFTPGET: 1,0
+  // +QFTPGET: 2,77
+  // ... (77 bytes of data) ...
+  // +QFTPGET: 0,0
+  
+  if (resp.indexOf(F("+QFTPGET: 1,0")) == -1) {
+    return false;
+  }
+
+  String size_tag = F("+QFTPGET: 2,");
+  int size_tag_index = resp.indexOf(size_tag);
+  if (size_tag_index == -1) {
+    return false;
+  }
+
+  int size_start = size_tag_index + size_tag.length();
+  int size_end = resp.indexOf('\r', size_start);
+  if (size_end == -1) {
+    return false;
+  }
+  String size_str = resp.substring(size_start, size_end);
+  size_str.trim();
+  int size = size_str.toInt();
+
+  if (size > 0) {
+    int data_start = size_end + 2; // Skip \r\n
+    data = resp.substring(data_start, data_start + size);
+    return true;
+  }
+
+  return false;
+}
+
+// ===== Filesystem =====
+bool QuectelEC200U::fsList(String &out) {
+  sendATRaw(F("AT+QFLST"));
+  String resp = readResponse(2000);
+  // Response is typically: +QFLST: ...
+  // OK
+  int list_start = resp.indexOf(F("+QFLST:"));
+  if (list_start != -1) {
+    int list_end = resp.indexOf(F("\r\nOK\r\n"), list_start);
+    if (list_end != -1) {
+      out = resp.substring(list_start, list_end);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool QuectelEC200U::fsUpload(const String &path, const String &content) {
+  String cmd = "AT+QFUPL=\"" + path + "\"," + String(content.length()) + ",100";
+  if (!sendAT(cmd, F("CONNECT"), 3000)) return false;
+  _serial->print(content);
+  
+  // Wait for "OK"
+  String resp = readResponse(5000);
+  return resp.indexOf(F("OK")) != -1;
+}
+
+bool QuectelEC200U::fsRead(const String &path, String &out, size_t length) {
+  // Open file
+  sendATRaw("AT+QFOPEN=\"" + path + "\",0");
+  String resp = readResponse(1000);
+  if (resp.indexOf(F("+QFOPEN:")) == -1) {
+    return false;
+  }
+  int handle_start = resp.indexOf(":") + 1;
+  int handle_end = resp.indexOf('\r', handle_start);
+  if (handle_end == -1) {
+    return false;
+  }
+  String handle_str = resp.substring(handle_start, handle_end);
+  handle_str.trim();
+  int handle = handle_str.toInt();
+
+  // Read file
+  sendATRaw("AT+QFREAD=" + String(handle) + "," + String(length ? length : 1024));
+  String read_resp = readResponse(5000);
+  
+  // Close file
+  sendAT("AT+QFCLOSE=" + String(handle));
+
+  int content_start = read_resp.indexOf(F("CONNECT\r\n"));
+  if (content_start == -1) {
+    return false;
+  }
+  content_start += 9; // length of "CONNECT\r\n"
+
+  int content_end = read_resp.indexOf(F("\r\nOK\r\n"), content_start);
+  if (content_end == -1) {
+    return false;
+  }
+
+  out = read_resp.substring(content_start, content_end);
+  return true;
+}
+
+bool QuectelEC200U::fsDelete(const String &path) {
+  return sendAT("AT+QFDEL=\"" + path + "\"");
+}
+
+int QuectelEC200U::fsOpen(const String &path, int mode) {
+  char buf[64];
+  sendATRaw("AT+QFOPEN=\"" + path + "\"," + String(mode));
+  readResponse(buf, sizeof(buf), 2000);
+  const char *p = strstr(buf, "+QFOPEN:");
+  if (_lastFinal != AT_TOKEN_OK || p == nullptr) {
+    _lastError = ErrorCode::FS_ERROR;
+    return -1;
+  }
+  return atoi(p + 8);
+}
+
+// "CONNECT <n>" is followed by exactly n bytes, then OK. Returns n or -1.
+int QuectelEC200U::fsRead(int handle, uint8_t *buffer, size_t length) {
+  sendATRaw("AT+QFREAD=" + String(handle) + "," + String((unsigned long)length));
+
+  char head[URC_LINE_MAX];
+  ATTokenizer tok;
+  tok.begin(nullptr, 0);
+  tok.setLineBuffer(head, sizeof(head));
+  uint32_t start = millis();
+  long announced = -1;
+  size_t got = 0;
+  int result = -1;
+  bool done = false;
+  _rxBusy = true;
+
+  while (!done && millis() - start < 5000) {
+    while (_serial->available()) {
+      if (announced > 0 && got < (size_t)announced) {
+        buffer[got++] = (uint8_t)_serial->read();
+        continue;
+      }
+      char c = (char)_serial->read();
+      if (_captureRaw(c)) {
+        continue;
+      }
+      ATToken t = tok.feed(c);
+      if (t == AT_TOKEN_NONE) {
+        continue;
+      }
+      if (t == AT_TOKEN_ERROR || t == AT_TOKEN_CME_ERROR || t == AT_TOKEN_CMS_ERROR) {
+        done = true;
+        break;
+      }
+      if (t == AT_TOKEN_OK && announced >= 0) {
+        result = (int)got;
+        done = true;
+        break;
+      }
+      ATSlice line = tok.line();
+      if (t == AT_TOKEN_CONNECT && announced < 0) {
+        char field[24];
+        line.copyTo(field, sizeof(field));
+        announced = atol(field + 7);
+        if (announced < 0 || (size_t)announced > length) {
+          done = true;
+          break;
+        }
+      } else if (t == AT_TOKEN_LINE) {
+        _dispatchURC(line);
+      }
+    }
+
+    if (!done && !_serial->available()) {
+      delay(1);
+    }
+  }
+
+  _rxBusy = false;
+  if (result < 0) {
+    _lastError = ErrorCode::FS_ERROR;
+  }
+  return result;
+}
+
+// Returns the number of bytes written (+QFWRITE: <written>,<total>) or -1
+int QuectelEC200U::fsWrite(int handle, const uint8_t *data, size_t length) {
+  if (!sendAT("AT+QFWRITE=" + String(handle) + "," + String((unsigned long)length), F("CONNECT"), 3000)) {
+    _lastError = ErrorCode::FS_ERROR;
+    return -1;
+  }
+  _serial->write(data, length);
+  char buf[64];
+  _readResponse(buf, sizeof(buf), 5000, AT_TOKEN_FINAL_MASK);
+  const char *p = strstr(buf, "+QFWRITE:");
+  if (_lastFinal != AT_TOKEN_OK || p == nullptr) {
+    _lastError = ErrorCode::FS_ERROR;
+    return -1;
+  }
+  return atoi(p + 9);
+}
+
+bool QuectelEC200U::fsSeek(int handle, long offset, int origin) {
+  return sendAT("AT+QFSEEK=" + String(handle) + "," + String(offset) + "," + String(origin));
+}
+
+bool QuectelEC200U::fsClose(int handle) {
+  return sendAT("AT+QFCLOSE=" + String(handle));
+}
+
+// +QFLST: "<name>",<size>
+long QuectelEC200U::fsSize(const String &path) {
+  char buf[96];
+  sendATRaw("AT+QFLST=\"" + path + "\"");
+  readResponse(buf, sizeof(buf), 2000);
+  const char *p = strstr(buf, "+QFLST:");
+  if (_lastFinal != AT_TOKEN_OK || p == nullptr) {
+    return -1;
+  }
+  p = strchr(p, ',');
+  return p ? atol(p + 1) : -1;
+}
+
+// ===== SSL/TLS =====
+bool QuectelEC200U::sslConfigure(int ctxId, const String &caPath, bool verify) {
+  if (!sendAT("AT+QSSLCFG=\"cacert\"," + String(ctxId) + ",\"" + caPath + "\"")) return false;
+  return sendAT("AT+QSSLCFG=\"seclevel\"," + String(ctxId) + "," + String(verify ? 2 : 0));
+}
+
+bool QuectelEC200U::sslUploadCert(const String &cert, const String &path) {
+  return fsUpload(path, cert);
+}
+
+// ===== PSM =====
+bool QuectelEC200U::enablePSM(bool enable) {
+  return sendAT(String("AT+CPSMS=") + (enable ? "1" : "0"));
+}
+
+// ===== MQTT =====
+// Up to six AT+QMT* clients. Every +QMT... line goes to _onMqttURC, which stores
+// open/connect/subscribe/publish results for the blocking call waiting on them,
+// tracks connection loss (+QMTSTAT) and has poll() deliver inbound messages:
+// held back from the URC, or (buffered receive) read with
+// AT+QMTRECV=<client>,<recv_id>.
+#define MQTT_PENDING (-128)
+
+// Client slots always; subscriptions and handlers only on construction, so
+// they survive a module restart and are sent again by mqttConnect().
+void QuectelEC200U::_initMqtt(bool subscriptions) {
+  for (int i = 0; i < EC200U_MQTT_CLIENTS; i++) {
+    MqttSlot &m = _mqtt[i];
+    m.state = MQTT_DISCONNECTED;
+    m.openResult = 0;
+    m.connResult = 0;
+    m.error = 0;
+    m.nextMsgId = 1;
+    m.ackId = 0;
+    m.ackResult = 0;
+    m.recvPending = 0;
+  }
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    _mqttInFlight[i].client = -1;
+  }
+  _mqttRecvCount = 0;
+  if (subscriptions) {
+    for (int i = 0; i < MQTT_MAX_SUBSCRIPTIONS; i++) {
+      _mqttSubs[i].client = -1;
+      _mqttSubs[i].handler = nullptr;
+      _mqttSubs[i].ctx = nullptr;
+    }
+    _mqttHandler = nullptr;
+    _mqttHandlerCtx = nullptr;
+    _mqttURCsRegistered = false;
+    _mqttRx = nullptr;
+    _mqttRecvQueue = nullptr;
+    _mqttWindow = MQTT_MAX_INFLIGHT;
+    _mqttPublished = nullptr;
+    _mqttPublishedCtx = nullptr;
+  }
+}
+
+bool QuectelEC200U::_validMqtt(int client) const {
+  return client >= 0 && client < EC200U_MQTT_CLIENTS;
+}
+
+uint16_t QuectelEC200U::_mqttNextId(int client) {
+  uint16_t id = _mqtt[client].nextMsgId++;
+  if (_mqtt[client].nextMsgId == 0) {
+    _mqtt[client].nextMsgId = 1;
+  }
+  return id;
+}
+
+// Waits for a result stored by _onMqttURC. poll() is skipped when called from
+// inside poll() (e.g. a message handler), where only the URCs are drained.
+bool QuectelEC200U::_mqttWait(const int8_t &result, uint32_t timeout) {
+  uint32_t start = millis();
+  while (result == MQTT_PENDING && millis() - start < timeout) {
+    if (_inPoll) {
+      _drainURCs();
+    } else {
+      poll();
+    }
+    delay(1);
+  }
+  return result != MQTT_PENDING;
+}
+
+bool QuectelEC200U::mqttConnect(const String &server, int port) {
+  MqttOptions options;
+  return mqttConnect(0, server, port, options);
+}
+
+bool QuectelEC200U::mqttConnect(int client, const String &server, int port, const MqttOptions &options) {
+  if (!_validMqtt(client)) {
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  if (!_mqttURCsRegistered) {
+    _mqttURCsRegistered = _addURC("+QMT", _onMqttURC, this, true);
+  }
+  if (!_mqttURCsRegistered) {
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  MqttSlot &m = _mqtt[client];
+  String id = String(client);
+
+  // All settings in one line
+  String cfg = "AT+QMTCFG=\"version\"," + id + "," + String(options.version);
+  cfg += ";+QMTCFG=\"pdpcid\"," + id + "," + String(options.pdpContext);
+  cfg += ";+QMTCFG=\"keepalive\"," + id + "," + String(options.keepAlive);
+  cfg += ";+QMTCFG=\"session\"," + id + "," + String(options.cleanSession ? 1 : 0);
+  cfg += ";+QMTCFG=\"recv/mode\"," + id + "," + String(options.bufferedReceive ? 1 : 0) + ",1";
+  if (options.sslContext >= 0) {
+    cfg += ";+QMTCFG=\"ssl\"," + id + ",1," + String(options.sslContext);
+  } else {
+    cfg += ";+QMTCFG=\"ssl\"," + id + ",0";
+  }
+  if (options.willTopic != nullptr) {
+    cfg += ";+QMTCFG=\"will\"," + id + ",1," + String(options.willQos) + "," + String(options.willRetain ? 1 : 0) +
+           ",\"" + options.willTopic + "\",\"" + (options.willMessage ? options.willMessage : "") + "\"";
+  } else {
+    cfg += ";+QMTCFG=\"will\"," + id + ",0";
+  }
+  if (!sendAT(cfg, F("OK"), 3000)) {
+    logError(F("MQTT configuration failed"));
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+
+  // The result of AT+QMTOPEN/AT+QMTCONN arrives as a URC after the OK.
+  // 2 = the client is already open.
+  m.openResult = MQTT_PENDING;
+  if (!sendAT("AT+QMTOPEN=" + id + ",\"" + server + "\"," + String(port), F("OK"), 5000) ||
+      !_mqttWait(m.openResult, MQTT_OPEN_TIMEOUT) || (m.openResult != 0 && m.openResult != 2)) {
+    logError(F("MQTT open failed"));
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  m.state = MQTT_OPEN;
+
+  String conn = "AT+QMTCONN=" + id + ",\"" + options.clientId + "\"";
+  if (options.username != nullptr) {
+    conn += ",\"" + String(options.username) + "\",\"" + (options.password ? options.password : "") + "\"";
+  }
+  m.connResult = MQTT_PENDING;
+  if (!sendAT(conn, F("OK"), 5000) || !_mqttWait(m.connResult, MQTT_ACK_TIMEOUT) || m.connResult != 0) {
+    logError(F("MQTT connect failed"));
+    sendAT("AT+QMTCLOSE=" + id, F("OK"), 5000);
+    m.state = MQTT_DISCONNECTED;
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  m.state = MQTT_CONNECTED;
+  m.recvPending = 0;
+
+  // A clean session starts with no subscriptions on the broker
+  if (options.cleanSession) {
+    for (int i = 0; i < MQTT_MAX_SUBSCRIPTIONS; i++) {
+      MqttSubscription &sub = _mqttSubs[i];
+      if (sub.client == client && !_mqttSendSubscribe(client, sub.filter, sub.qos)) {
+        logError(F("MQTT resubscribe failed"));
+      }
+    }
+  }
+  return true;
+}
+
+bool QuectelEC200U::mqttDisconnect(int client) {
+  if (!_validMqtt(client)) {
+    return false;
+  }
+  bool ok = sendAT("AT+QMTDISC=" + String(client), F("OK"), 5000);
+  _mqtt[client].state = MQTT_DISCONNECTED;
+  _mqtt[client].recvPending = 0;
+  return ok;
 }
 
-// ===== TTS =====
-bool QuectelEC200U::playTTS(const char* text) {
-  return sendAT(String("AT+QTTS=1,\"") + text + "\"");
+bool QuectelEC200U::mqttPublish(const String &topic, const String &message) {
+  return mqttPublish(0, topic, message, 0, false);
 }
 
-// ===== FTP =====
-bool QuectelEC200U::ftpLogin(const String &server, const String &user, const String &pass) {
-  if (!sendAT("AT+QFTPCFG=\"account\",\"" + user + "\",\"" + pass + "\"")) return false;
-  return sendAT("AT+QFTPOPEN=\"" + server + "\",21", F("+QFTP"), 15000);
+bool QuectelEC200U::mqttPublish(int client, const String &topic, const String &message, uint8_t qos, bool retain) {
+  return mqttPublish(client, topic, (const uint8_t *)message.c_str(), message.length(), qos, retain);
 }
 
-bool QuectelEC200U::ftpDownload(const String &filename, String &data) {
-  _serial->println("AT+QFTPGET=\"" + filename + "\"");
-  String resp = readResponse(10000);
-  
-  // Response is typically:
-  // +QFTPGET: 1,0
-  // +QFTPGET: 2,77
-  // ... (77 bytes of data) ...
-  // +QFTPGET: 0,0
-  
-  if (resp.indexOf(F("+QFTPGET: 1,0")) == -1) {
+bool QuectelEC200U::mqttPublish(int client, const String &topic, const uint8_t *payload, size_t length, uint8_t qos, bool retain) {
+  if (!_validMqtt(client) || _mqtt[client].state != MQTT_CONNECTED || qos > 2) {
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  MqttSlot &m = _mqtt[client];
+  uint16_t msgId = qos > 0 ? _mqttNextId(client) : 0;
+  m.ackId = msgId;
+  m.ackResult = MQTT_PENDING;
+  if (!_mqttSendPublish(client, msgId, topic, payload, length, qos, retain)) {
+    return false;
+  }
+  // QoS 1/2: wait for the broker's acknowledgement
+  if (qos > 0 && (!_mqttWait(m.ackResult, MQTT_ACK_TIMEOUT) || m.ackResult != 0)) {
+    _lastError = ErrorCode::MQTT_ERROR;
     return false;
   }
+  return true;
+}
 
-  String size_tag = F("+QFTPGET: 2,");
-  int size_tag_index = resp.indexOf(size_tag);
-  if (size_tag_index == -1) {
+// AT+QMTPUB up to the module's OK; the broker's +QMTPUB follows later. The
+// payload length is given in the command, so the module reads exactly that
+// many bytes and any value (0x1A included) goes through. Only an empty
+// message uses the Ctrl-Z terminated form.
+bool QuectelEC200U::_mqttSendPublish(int client, uint16_t msgId, const String &topic, const uint8_t *payload, size_t length, uint8_t qos, bool retain) {
+  String cmd = "AT+QMTPUB=" + String(client) + "," + String(msgId) + "," + String(qos) + "," + String(retain ? 1 : 0) + ",\"" + topic + "\"";
+  if (length > 0) {
+    cmd += "," + String((unsigned long)length);
+  }
+  if (!sendAT(cmd, F("> "), 2000)) {
+    _lastError = ErrorCode::MQTT_ERROR;
     return false;
   }
+  if (length > 0) {
+    _serial->write(payload, length);
+  } else {
+    _serial->write(26);
+  }
 
-  int size_start = size_tag_index + size_tag.length();
-  int size_end = resp.indexOf('\r', size_start);
-  if (size_end == -1) {
+  char resp[64];
+  _readResponse(resp, sizeof(resp), 5000, AT_TOKEN_FINAL_MASK);
+  if (_lastFinal != AT_TOKEN_OK) {
+    _lastError = ErrorCode::MQTT_ERROR;
     return false;
   }
-  String size_str = resp.substring(size_start, size_end);
-  size_str.trim();
-  int size = size_str.toInt();
+  return true;
+}
 
-  if (size > 0) {
-    int data_start = size_end + 2; // Skip \r\n
-    data = resp.substring(data_start, data_start + size);
-    return true;
+int QuectelEC200U::mqttPublishAsync(int client, const String &topic, const String &message, uint8_t qos, bool retain) {
+  return mqttPublishAsync(client, topic, (const uint8_t *)message.c_str(), message.length(), qos, retain);
+}
+
+int QuectelEC200U::mqttPublishAsync(int client, const String &topic, const uint8_t *payload, size_t length, uint8_t qos, bool retain) {
+  if (!mqttCanPublish(client) || qos > 2) {
+    _lastError = ErrorCode::MQTT_ERROR;
+    return -1;
+  }
+  if (qos == 0) {
+    return _mqttSendPublish(client, 0, topic, payload, length, 0, retain) ? 0 : -1;
   }
+  int slot = 0;
+  while (_mqttInFlight[slot].client >= 0) {
+    slot++;   // mqttCanPublish() guarantees a free entry
+  }
+  MqttInFlight &f = _mqttInFlight[slot];
+  f.client = (int8_t)client;
+  f.result = MQTT_PENDING;
+  f.msgId = _mqttNextId(client);
+  f.sentMs = millis();
+  uint16_t msgId = f.msgId;
+  if (!_mqttSendPublish(client, msgId, topic, payload, length, qos, retain)) {
+    if (f.client == client && f.msgId == msgId) {
+      f.client = -1;
+    }
+    return -1;
+  }
+  return msgId;
+}
 
-  return false;
+bool QuectelEC200U::mqttCanPublish(int client) const {
+  if (!_validMqtt(client) || _mqtt[client].state != MQTT_CONNECTED) {
+    return false;
+  }
+  uint8_t used = 0;
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (_mqttInFlight[i].client >= 0) {
+      used++;
+    }
+  }
+  return used < MQTT_MAX_INFLIGHT && mqttInFlight(client) < _mqttWindow;
 }
 
-// ===== Filesystem =====
-bool QuectelEC200U::fsList(String &out) {
-  _serial->println(F("AT+QFLST"));
-  String resp = readResponse(2000);
-  // Response is typically: +QFLST: ...
-  // OK
-  int list_start = resp.indexOf(F("+QFLST:"));
-  if (list_start != -1) {
-    int list_end = resp.indexOf(F("\r\nOK\r\n"), list_start);
-    if (list_end != -1) {
-      out = resp.substring(list_start, list_end);
-      return true;
+uint8_t QuectelEC200U::mqttInFlight(int client) const {
+  uint8_t count = 0;
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (_mqttInFlight[i].client == client && _mqttInFlight[i].result == MQTT_PENDING) {
+      count++;
     }
   }
-  return false;
+  return count;
 }
 
-bool QuectelEC200U::fsUpload(const String &path, const String &content) {
-  String cmd = "AT+QFUPL=\"" + path + "\"," + String(content.length()) + ",100";
-  if (!sendAT(cmd, F("CONNECT"), 3000)) return false;
-  _serial->print(content);
-  
-  // Wait for "OK"
-  String resp = readResponse(5000);
-  return resp.indexOf(F("OK")) != -1;
+void QuectelEC200U::setMqttWindow(uint8_t window) {
+  _mqttWindow = window < 1 ? 1 : (window > MQTT_MAX_INFLIGHT ? MQTT_MAX_INFLIGHT : window);
 }
 
-bool QuectelEC200U::fsRead(const String &path, String &out, size_t length) {
-  // Open file
-  _serial->println("AT+QFOPEN=\"" + path + "\",0");
-  String resp = readResponse(1000);
-  if (resp.indexOf(F("+QFOPEN:")) == -1) {
-    return false;
+void QuectelEC200U::onMqttPublished(MqttPublishCallback callback, void *ctx) {
+  _mqttPublished = callback;
+  _mqttPublishedCtx = ctx;
+}
+
+// Called from the URC handler, possibly in the middle of another command's
+// response: only records the outcome, which poll() reports
+void QuectelEC200U::_mqttPublishDone(int index, bool acked) {
+  MqttInFlight &f = _mqttInFlight[index];
+  if (f.result != MQTT_PENDING) {
+    return;
   }
-  int handle_start = resp.indexOf(":") + 1;
-  int handle_end = resp.indexOf('\r', handle_start);
-  if (handle_end == -1) {
-    return false;
+  f.result = acked ? 0 : 1;
+  f.latencyMs = millis() - f.sentMs;
+}
+
+// Frees each entry before its callback, which may publish again
+void QuectelEC200U::_mqttReportPublished() {
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    MqttInFlight &f = _mqttInFlight[i];
+    if (f.client < 0 || f.result == MQTT_PENDING) {
+      continue;
+    }
+    int client = f.client;
+    f.client = -1;
+    if (_mqttPublished) {
+      _mqttPublished(client, f.msgId, f.result == 0, f.latencyMs, _mqttPublishedCtx);
+    }
   }
-  String handle_str = resp.substring(handle_start, handle_end);
-  handle_str.trim();
-  int handle = handle_str.toInt();
+}
 
-  // Read file
-  _serial->println("AT+QFREAD=" + String(handle) + "," + String(length ? length : 1024));
-  String read_resp = readResponse(5000);
-  
-  // Close file
-  sendAT("AT+QFCLOSE=" + String(handle));
+bool QuectelEC200U::mqttSubscribe(const String &topic) {
+  return mqttSubscribe(0, topic, 0, nullptr, nullptr);
+}
 
-  int content_start = read_resp.indexOf(F("CONNECT\r\n"));
-  if (content_start == -1) {
+bool QuectelEC200U::mqttSubscribe(int client, const String &topic, uint8_t qos, MqttMessageHandler handler, void *ctx) {
+  if (!_validMqtt(client) || _mqtt[client].state != MQTT_CONNECTED || qos > 2) {
+    _lastError = ErrorCode::MQTT_ERROR;
     return false;
   }
-  content_start += 9; // length of "CONNECT\r\n"
+  MqttSubscription *slot = nullptr;
+  for (int i = 0; i < MQTT_MAX_SUBSCRIPTIONS; i++) {
+    MqttSubscription &sub = _mqttSubs[i];
+    if (sub.client == client && sub.filter == topic) {
+      slot = &sub;
+      break;
+    }
+    if (slot == nullptr && sub.client < 0) {
+      slot = &sub;
+    }
+  }
+  if (slot == nullptr) {
+    logError(F("MQTT subscription table full"));
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  if (!_mqttSendSubscribe(client, topic, qos)) {
+    _lastError = ErrorCode::MQTT_ERROR;
+    return false;
+  }
+  slot->client = (int8_t)client;
+  slot->qos = qos;
+  slot->filter = topic;
+  slot->handler = handler;
+  slot->ctx = ctx;
+  return true;
+}
 
-  int content_end = read_resp.indexOf(F("\r\nOK\r\n"), content_start);
-  if (content_end == -1) {
+bool QuectelEC200U::_mqttSendSubscribe(int client, const String &topic, uint8_t qos) {
+  MqttSlot &m = _mqtt[client];
+  uint16_t msgId = _mqttNextId(client);
+  m.ackId = msgId;
+  m.ackResult = MQTT_PENDING;
+  String cmd = "AT+QMTSUB=" + String(client) + "," + String(msgId) + ",\"" + topic + "\"," + String(qos);
+  return sendAT(cmd, F("OK"), 5000) && _mqttWait(m.ackResult, MQTT_ACK_TIMEOUT) && m.ackResult == 0;
+}
+
+bool QuectelEC200U::mqttUnsubscribe(int client, const String &topic) {
+  if (!_validMqtt(client)) {
     return false;
   }
+  for (int i = 0; i < MQTT_MAX_SUBSCRIPTIONS; i++) {
+    MqttSubscription &sub = _mqttSubs[i];
+    if (sub.client == client && sub.filter == topic) {
+      sub.client = -1;
+      sub.filter = String();
+      sub.handler = nullptr;
+    }
+  }
+  MqttSlot &m = _mqtt[client];
+  if (m.state != MQTT_CONNECTED) {
+    return true;
+  }
+  uint16_t msgId = _mqttNextId(client);
+  m.ackId = msgId;
+  m.ackResult = MQTT_PENDING;
+  String cmd = "AT+QMTUNS=" + String(client) + "," + String(msgId) + ",\"" + topic + "\"";
+  return sendAT(cmd, F("OK"), 5000) && _mqttWait(m.ackResult, MQTT_ACK_TIMEOUT) && m.ackResult == 0;
+}
 
-  out = read_resp.substring(content_start, content_end);
-  return true;
+void QuectelEC200U::onMqttMessage(MqttMessageHandler handler, void *ctx) {
+  _mqttHandler = handler;
+  _mqttHandlerCtx = ctx;
 }
 
-bool QuectelEC200U::fsDelete(const String &path) {
-  return sendAT("AT+QFDEL=\"" + path + "\"");
+MqttState QuectelEC200U::mqttState(int client) const {
+  return _validMqtt(client) ? _mqtt[client].state : MQTT_DISCONNECTED;
 }
 
-// ===== SSL/TLS =====
-bool QuectelEC200U::sslConfigure(int ctxId, const String &caPath, bool verify) {
-  if (!sendAT("AT+QSSLCFG=\"cacert\"," + String(ctxId) + ",\"" + caPath + "\"")) return false;
-  return sendAT("AT+QSSLCFG=\"seclevel\"," + String(ctxId) + "," + String(verify ? 2 : 0));
+int QuectelEC200U::mqttError(int client) const {
+  return _validMqtt(client) ? _mqtt[client].error : -1;
 }
 
-bool QuectelEC200U::sslUploadCert(const String &cert, const String &path) {
-  return fsUpload(path, cert);
+// MQTT topic filter match with '+' (one level) and '#' (this level and below)
+bool QuectelEC200U::_mqttTopicMatch(const char *filter, const char *topic) {
+  while (*filter) {
+    if (*filter == '#') {
+      return true;
+    }
+    if (*filter == '+') {
+      while (*topic && *topic != '/') {
+        topic++;
+      }
+      filter++;
+      continue;
+    }
+    if (*topic == '\0' && filter[0] == '/' && filter[1] == '#') {
+      return true;   // "a/#" also matches "a"
+    }
+    if (*filter != *topic) {
+      return false;
+    }
+    filter++;
+    topic++;
+  }
+  return *topic == '\0';
 }
 
-// ===== PSM =====
-bool QuectelEC200U::enablePSM(bool enable) {
-  return sendAT(String("AT+CPSMS=") + (enable ? "1" : "0"));
+void QuectelEC200U::_mqttDeliver(int client, const char *topic, const uint8_t *payload, size_t length) {
+  bool fallback = false;
+  for (int i = 0; i < MQTT_MAX_SUBSCRIPTIONS; i++) {
+    MqttSubscription &sub = _mqttSubs[i];
+    if (sub.client != client || !_mqttTopicMatch(sub.filter.c_str(), topic)) {
+      continue;
+    }
+    if (sub.handler) {
+      sub.handler(client, topic, payload, length, sub.ctx);
+    } else {
+      fallback = true;
+    }
+  }
+  if (fallback && _mqttHandler) {
+    _mqttHandler(client, topic, payload, length, _mqttHandlerCtx);
+  }
 }
 
-// ===== MQTT =====
-bool QuectelEC200U::mqttConnect(const String &server, int port) {
-  if (!sendAT("AT+QMTOPEN=0,\"" + server + "\"," + String(port), "+QMTOPEN: 0,0", 15000)) return false;
-  return sendAT("AT+QMTCONN=0,\"ec200u\"", "+QMTCONN: 0,0", 10000);
+// +QMTOPEN: <c>,<result>          +QMTCONN: <c>,<result>[,<ret_code>]
+// +QMTSUB: <c>,<msgid>,<result>[,<value>]   +QMTUNS / +QMTPUB: <c>,<msgid>,<result>
+// +QMTSTAT: <c>,<err>             +QMTDISC / +QMTCLOSE: <c>,<result>
+// +QMTRECV: <c>,<recv_id>                               (buffered receive)
+// +QMTRECV: <c>,<msgid>,"<topic>",<len>,"<payload>"     (delivered in the URC)
+void QuectelEC200U::_onMqttURC(const char *urc, void *ctx) {
+  QuectelEC200U *self = (QuectelEC200U *)ctx;
+  const char *p = strchr(urc, ':');
+  if (p == nullptr) {
+    return;
+  }
+  p++;
+  long v[4];
+  int n = 0;
+  while (n < 4) {
+    char *end;
+    long value = strtol(p, &end, 10);
+    if (end == p) {
+      break;
+    }
+    v[n++] = value;
+    p = end;
+    if (*p != ',') {
+      break;
+    }
+    p++;
+  }
+  if (n < 2 || !self->_validMqtt((int)v[0])) {
+    return;
+  }
+  int client = (int)v[0];
+  MqttSlot &m = self->_mqtt[client];
+  const char *tag = urc + 4;
+
+  if (strncmp(tag, "OPEN:", 5) == 0) {
+    m.openResult = (int8_t)v[1];
+    if (v[1] != 0 && v[1] != 2) {
+      m.error = (int8_t)v[1];
+    }
+  } else if (strncmp(tag, "CONN:", 5) == 0) {
+    if (v[1] == 1) {
+      return;   // Retransmitting CONNECT
+    }
+    bool accepted = v[1] == 0 && (n < 3 || v[2] == 0);
+    if (!accepted) {
+      m.error = (int8_t)(n >= 3 ? v[2] : v[1]);
+    }
+    m.connResult = accepted ? 0 : 1;
+  } else if (strncmp(tag, "SUB:", 4) == 0 || strncmp(tag, "UNS:", 4) == 0 || strncmp(tag, "PUB:", 4) == 0) {
+    if (tag[0] == 'P' && n >= 3) {
+      for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+        MqttInFlight &f = self->_mqttInFlight[i];
+        if (f.client == client && f.result == MQTT_PENDING && f.msgId == (uint16_t)v[1]) {
+          if (v[2] != 1) {   // 1 = retransmitting, still in flight
+            self->_mqttPublishDone(i, v[2] == 0);
+          }
+          return;
+        }
+      }
+    }
+    if (n < 3 || (uint16_t)v[1] != m.ackId || v[2] == 1) {
+      return;   // Not awaited, or retransmitting
+    }
+    bool refused = tag[0] == 'S' && n >= 4 && v[3] == 128;
+    m.ackResult = (int8_t)(refused ? 2 : v[2]);
+  } else if (strncmp(tag, "STAT:", 5) == 0) {
+    m.state = MQTT_DISCONNECTED;
+    m.error = (int8_t)v[1];
+    m.recvPending = 0;
+    if (m.ackResult == MQTT_PENDING) {
+      m.ackResult = 2;
+    }
+    if (m.connResult == MQTT_PENDING) {
+      m.connResult = 1;
+    }
+    for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+      if (self->_mqttInFlight[i].client == client) {
+        self->_mqttPublishDone(i, false);
+      }
+    }
+  } else if (strncmp(tag, "DISC:", 5) == 0 || strncmp(tag, "CLOSE:", 6) == 0) {
+    m.state = MQTT_DISCONNECTED;
+    m.recvPending = 0;
+    for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+      if (self->_mqttInFlight[i].client == client) {
+        self->_mqttPublishDone(i, false);
+      }
+    }
+  } else if (strncmp(tag, "RECV:", 5) == 0) {
+    if (*p != '"') {
+      if (v[1] >= 0 && v[1] < 8) {
+        m.recvPending |= 1 << v[1];
+      }
+      return;
+    }
+    // The URC may arrive in the middle of another command's response, where a
+    // handler issuing AT commands would interleave with it
+    self->_mqttQueueMessage(urc);
+  }
 }
 
-bool QuectelEC200U::mqttPublish(const String &topic, const String &message) {
-  String cmd = "AT+QMTPUB=0,0,0,0,\"" + topic + "\"";
-  if (!sendAT(cmd, F("> "), 2000)) return false;
-  _serial->print(message);
-  _serial->write(26);
-  
-  // Wait for "OK"
-  String resp = readResponse(5000);
-  return resp.indexOf(F("OK")) != -1;
+void QuectelEC200U::_mqttQueueMessage(const char *urc) {
+  if (_mqttRecvQueue == nullptr) {
+    _mqttRecvQueue = (char *)malloc(MQTT_RECV_QUEUE * URC_LINE_MAX);
+  }
+  if (_mqttRecvQueue == nullptr || _mqttRecvCount >= MQTT_RECV_QUEUE) {
+    logError(F("MQTT receive queue full, message dropped"));
+    return;
+  }
+  char *slot = _mqttRecvQueue + _mqttRecvCount * URC_LINE_MAX;
+  strncpy(slot, urc, URC_LINE_MAX - 1);
+  slot[URC_LINE_MAX - 1] = '\0';
+  _mqttRecvCount++;
+}
+
+// Oldest first; each line is taken off the queue before its handler runs,
+// since the handler's own commands may queue more
+void QuectelEC200U::_mqttDeliverQueued() {
+  while (_mqttRecvCount > 0) {
+    char line[URC_LINE_MAX];
+    memcpy(line, _mqttRecvQueue, URC_LINE_MAX);
+    _mqttRecvCount--;
+    memmove(_mqttRecvQueue, _mqttRecvQueue + URC_LINE_MAX, _mqttRecvCount * URC_LINE_MAX);
+    _mqttDeliverURC(line);
+  }
 }
 
-bool QuectelEC200U::mqttSubscribe(const String &topic) {
-  return sendAT("AT+QMTSUB=0,1,\"" + topic + "\",0", F("+QMTSUB: 0,1,0"), 5000);
+// +QMTRECV: <c>,<msgid>,"<topic>",<len>,"<payload>"
+void QuectelEC200U::_mqttDeliverURC(const char *urc) {
+  char *end;
+  int client = (int)strtol(strchr(urc, ':') + 1, &end, 10);
+  if (*end != ',' || !_validMqtt(client)) {
+    return;
+  }
+  strtol(end + 1, &end, 10);
+  if (*end != ',' || end[1] != '"') {
+    return;
+  }
+  const char *p = end + 1;
+  char topic[MQTT_TOPIC_MAX];
+  const char *t = p + 1;
+  size_t tlen = 0;
+  while (t[tlen] && t[tlen] != '"') {
+    tlen++;
+  }
+  if (t[tlen] != '"') {
+    return;
+  }
+  memcpy(topic, t, tlen < sizeof(topic) ? tlen : sizeof(topic) - 1);
+  topic[tlen < sizeof(topic) ? tlen : sizeof(topic) - 1] = '\0';
+  p = t + tlen + 1;
+  if (*p != ',') {
+    return;
+  }
+  long length = strtol(p + 1, (char **)&p, 10);
+  if (*p != ',' || p[1] != '"') {
+    return;
+  }
+  p += 2;
+  // The line holds at most URC_LINE_MAX - 1 bytes, so long payloads arrive
+  // cut short; use buffered receive for those
+  size_t avail = strlen(p);
+  if (avail > 0 && p[avail - 1] == '"') {
+    avail--;
+  }
+  size_t len = (size_t)length < avail ? (size_t)length : avail;
+  _mqttDeliver(client, topic, (const uint8_t *)p, len);
+}
+
+// Reads one message the module holds for buffered receive. The payload is
+// copied by its announced length, so it may contain quotes, commas and CR/LF.
+bool QuectelEC200U::_mqttReadBuffered(int client, uint8_t recvId) {
+  if (_mqttRx == nullptr) {
+    _mqttRx = (uint8_t *)malloc(MQTT_RX_BUFFER_SIZE);
+    if (_mqttRx == nullptr) {
+      return false;
+    }
+  }
+  sendATRaw("AT+QMTRECV=" + String(client) + "," + String(recvId));
+
+  char head[URC_LINE_MAX];
+  ATTokenizer tok;
+  tok.begin(nullptr, 0);
+  tok.setLineBuffer(head, sizeof(head));
+  char header[MQTT_TOPIC_MAX + 48];
+  size_t headerLen = 0;
+  uint8_t commas = 0;
+  bool quoted = false;
+  long announced = -1;
+  size_t got = 0;
+  bool ok = false;
+  bool done = false;
+  uint32_t start = millis();
+  _rxBusy = true;
+
+  while (!done && millis() - start < 2000) {
+    while (_serial->available()) {
+      if (announced > 0 && got < (size_t)announced) {
+        uint8_t b = (uint8_t)_serial->read();
+        if (got < MQTT_RX_BUFFER_SIZE) {
+          _mqttRx[got] = b;
+        }
+        got++;
+        continue;
+      }
+      char c = (char)_serial->read();
+      if (_captureRaw(c)) {
+        continue;
+      }
+      // Header "+QMTRECV: <c>,<msgid>,"<topic>",<len>," then <len> payload bytes
+      if (c == '\r' || c == '\n') {
+        headerLen = 0;
+        commas = 0;
+        quoted = false;
+      } else if (announced < 0 && headerLen < sizeof(header) - 1) {
+        if (c == '"' && commas == 4 && strncmp(header, "+QMTRECV:", 9) == 0) {
+          header[headerLen - 1] = '\0';   // Drop the ',' before the payload
+          announced = atol(strrchr(header, ',') + 1);
+        } else {
+          if (c == '"') {
+            quoted = !quoted;
+          } else if (c == ',' && !quoted) {
+            commas++;
+          }
+          header[headerLen++] = c;
+        }
+      }
+      ATToken t = tok.feed(c);
+      if (t == AT_TOKEN_NONE) {
+        continue;
+      }
+      if (t == AT_TOKEN_OK) {
+        ok = announced >= 0;
+        done = true;
+        break;
+      }
+      if (t == AT_TOKEN_ERROR || t == AT_TOKEN_CME_ERROR || t == AT_TOKEN_CMS_ERROR) {
+        done = true;
+        break;
+      }
+      ATSlice line = tok.line();
+      if (t == AT_TOKEN_LINE && !line.startsWith("+QMTRECV:")) {
+        _dispatchURC(line);
+      }
+    }
+    if (!done && !_serial->available()) {
+      delay(1);
+    }
+  }
+  _rxBusy = false;
+
+  if (!ok) {
+    return false;
+  }
+  // Topic: between the first pair of quotes of the header
+  char *topic = strchr(header, '"');
+  char *close = topic ? strchr(topic + 1, '"') : nullptr;
+  if (close == nullptr) {
+    return false;
+  }
+  *close = '\0';
+  if (got > MQTT_RX_BUFFER_SIZE) {
+    logError(F("MQTT message truncated"));
+    got = MQTT_RX_BUFFER_SIZE;
+  }
+  _mqttDeliver(client, topic + 1, _mqttRx, got);
+  return true;
+}
+
+void QuectelEC200U::_serviceMqtt() {
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (_mqttInFlight[i].client >= 0 && millis() - _mqttInFlight[i].sentMs >= MQTT_ACK_TIMEOUT) {
+      _mqttPublishDone(i, false);
+    }
+  }
+  if (!_rxBusy) {
+    _mqttDeliverQueued();
+    _mqttReportPublished();
+  }
+  for (int i = 0; i < EC200U_MQTT_CLIENTS; i++) {
+    MqttSlot &m = _mqtt[i];
+    for (uint8_t id = 0; m.recvPending && id < 8; id++) {
+      if (m.recvPending & (1 << id)) {
+        m.recvPending &= ~(1 << id);
+        _mqttReadBuffered(i, id);
+        return;  // One AT+QMTRECV per poll() keeps the caller responsive
+      }
+    }
+  }
 }
 
 String QuectelEC200U::_getSignalStrengthString(int signal) {
@@ -1346,7 +4478,7 @@ bool QuectelEC200U::answer() {
 }
 
 String QuectelEC200U::getCallList() {
-  _serial->println(F("AT+CLCC"));
+  sendATRaw(F("AT+CLCC"));
   String resp = readResponse(2000);
   // Response is typically: +CLCC: ...
   // OK
@@ -1413,7 +4545,7 @@ bool QuectelEC200U::ping(const String &host, int contextID, int timeout, int pin
 bool QuectelEC200U::ping(const String &host, String &report, int contextID, int timeout, int pingnum) {
   String cmd = "AT+QPING=" + String(contextID) + ",\"" + host + "\"," + String(timeout) + "," + String(pingnum);
   flushInput();
-  _serial->println(cmd);
+  sendATRaw(cmd);
   String ack = readResponse(2000);
   if (ack.indexOf(F("OK")) == -1) {
     report = ack;
@@ -1481,21 +4613,28 @@ String QuectelEC200U::getIpByHostName(const String &hostname, int contextID) {
     return "";
 }
 
+// Completes with SUCCESS once the first resolved address line
+// (+QIURC: "dnsgip","<ip>") has been received.
+int QuectelEC200U::getIpByHostNameAsync(const String &hostname, ATCallback callback, void *ctx, int contextID) {
+    String cmd = "AT+QIDNSGIP=" + String(contextID) + ",\"" + hostname + "\"";
+    return sendATAsync(cmd, callback, ctx, 60000, F("+QIURC: \"dnsgip\",\""));
+}
+
 // ===== ADC =====
 int QuectelEC200U::readADC() {
-    _serial->println(F("AT+QADC=0"));
+    sendATRaw(F("AT+QADC=0"));
     String resp = readResponse(1000);
     return _parseCsvInt(resp, F("+QADC: "), 1);
 }
 
 // ===== Packet Domain =====
 String QuectelEC200U::getPacketDataCounter() {
-    _serial->println(F("AT+QGDCNT?"));
+    sendATRaw(F("AT+QGDCNT?"));
     return readResponse(1000);
 }
 
 String QuectelEC200U::readDynamicPDNParameters(int cid) {
-    _serial->println("AT+CGCONTRDP=" + String(cid));
+    sendATRaw("AT+CGCONTRDP=" + String(cid));
     return readResponse(1000);
 }
 
@@ -1503,7 +4642,7 @@ QuectelEC200U::PDPContext QuectelEC200U::getPDPContext(int cid) {
     PDPContext ctx;
     ctx.cid = -1; // Indicate invalid context initially
 
-    _serial->println(F("AT+CGDCONT?"));
+    sendATRaw(F("AT+CGDCONT?"));
     String resp = readResponse(1000); // Read the full response
 
     // Look for a line starting with "+CGDCONT: <cid>"
@@ -1583,14 +4722,14 @@ QuectelEC200U::PDPContext QuectelEC200U::getPDPContext(int cid) {
 
 // ===== Hardware =====
 String QuectelEC200U::getBatteryCharge() {
-    _serial->println(F("AT+CBC"));
+    sendATRaw(F("AT+CBC"));
     return readResponse(1000);
 }
 
 String QuectelEC200U::getWifiScan() {
   sendAT(F("AT+QWIFI=1"), F("OK"), 5000);
   flushInput();
-  _serial->println(F("AT+QWIFISCAN=8"));
+  sendATRaw(F("AT+QWIFISCAN=8"));
   return _collectResponse(30000);
 }
 
@@ -1598,7 +4737,7 @@ String QuectelEC200U::scanBluetooth() {
   sendAT(F("AT+QBTPWR=1"), F("OK"), 2000);
   sendAT(F("AT+QBTVIS=1,1"), F("OK"), 2000);
   flushInput();
-  _serial->println(F("AT+QBTSCAN=8"));
+  sendATRaw(F("AT+QBTSCAN=8"));
   return _collectResponse(30000);
 }
 
@@ -1622,34 +4761,19 @@ bool QuectelEC200U::setBand(const String &gsm_mask, const String &lte_mask) {
 
 // ===== Modem Identification =====
 String QuectelEC200U::getManufacturerIdentification() {
-    _serial->println(F("AT+GMI"));
-  String resp = readResponse(1000);
-  return _extractFirstLine(resp);
+    return String(getDeviceInfo(DeviceInfoField::MANUFACTURER));
 }
 
 String QuectelEC200U::getModelIdentification() {
-    _serial->println(F("AT+GMM"));
-  return _extractFirstLine(readResponse(1000));
+    return String(getDeviceInfo(DeviceInfoField::MODEL));
 }
 
 String QuectelEC200U::getFirmwareRevision() {
-    _serial->println(F("AT+GMR"));
-  return _extractFirstLine(readResponse(1000));
+    return String(getDeviceInfo(DeviceInfoField::FIRMWARE));
 }
 
 String QuectelEC200U::getModuleVersion() {
-  _serial->println(F("ATI"));
-  String resp = readResponse(1000);
-  resp.replace("\r", "\n");
-  int okIdx = resp.lastIndexOf(F("\nOK"));
-  if (okIdx != -1) {
-    resp.remove(okIdx);
-  }
-  while (resp.indexOf("\n\n") != -1) {
-    resp.replace("\n\n", "\n");
-  }
-  resp.trim();
-  return resp;
+    return String(getDeviceInfo(DeviceInfoField::VERSION));
 }
 
 // ===== General Commands =====
@@ -1657,6 +4781,7 @@ bool QuectelEC200U::restoreFactoryDefaults() {
     logDebug(F("Performing factory reset..."));
     bool result = sendAT(F("AT&F"), F("OK"), 5000);
     if (result) {
+        _httpInvalidateConfig();
         _initialized = false;
         _echoDisabled = false;
         _simChecked = false;
@@ -1667,7 +4792,7 @@ bool QuectelEC200U::restoreFactoryDefaults() {
 }
 
 String QuectelEC200U::showCurrentConfiguration() {
-    _serial->println(F("AT&V"));
+    sendATRaw(F("AT&V"));
     return readResponse(2000);
 }
 
@@ -1692,7 +4817,7 @@ bool QuectelEC200U::setCommandEcho(bool enable) {
 }
 
 bool QuectelEC200U::repeatPreviousCommand() {
-    _serial->println(F("A/"));
+    sendATRaw(F("A/"));
     return expectURC(F("OK"), 3000);
 }
 
@@ -1701,6 +4826,14 @@ bool QuectelEC200U::setSParameter(int s, int value) {
 }
 
 bool QuectelEC200U::setFunctionMode(int fun, int rst) {
+    if (rst == 1) {
+        _httpInvalidateConfig();
+        _bootURCs = 0;
+        invalidateDeviceInfo();
+        _initNetworkState();
+        _netURCs = false;
+        _initMqtt(false);
+    }
     return sendAT("AT+CFUN=" + String(fun) + "," + String(rst));
 }
 
@@ -1739,7 +4872,7 @@ bool QuectelEC200U::setUARTBaudRate(long rate) {
 
 // ===== Status Control and Extended Settings =====
 String QuectelEC200U::getActivityStatus() {
-    _serial->println(F("AT+CPAS"));
+    sendATRaw(F("AT+CPAS"));
     return readResponse(1000);
 }
 
@@ -1749,33 +4882,31 @@ bool QuectelEC200U::setURCIndication(const String &urc_type, bool enable) {
 
 // ===== (U)SIM Related Commands =====
 String QuectelEC200U::getIMSI() {
-    _serial->println(F("AT+CIMI"));
-    return readResponse(1000);
+    return String(getDeviceInfo(DeviceInfoField::IMSI));
 }
 
 String QuectelEC200U::getICCID() {
-    _serial->println(F("AT+QCCID"));
-    return readResponse(1000);
+    return String(getDeviceInfo(DeviceInfoField::ICCID));
 }
 
 String QuectelEC200U::getPinRetries() {
-    _serial->println(F("AT+QPINC"));
+    sendATRaw(F("AT+QPINC"));
     return readResponse(1000);
 }
 
 // ===== Network Service Commands =====
 String QuectelEC200U::getDetailedSignalQuality() {
-    _serial->println(F("AT+QCSQ"));
+    sendATRaw(F("AT+QCSQ"));
     return readResponse(1000);
 }
 
 String QuectelEC200U::getNetworkTime() {
-    _serial->println(F("AT+QLTS"));
+    sendATRaw(F("AT+QLTS"));
     return readResponse(1000);
 }
 
 String QuectelEC200U::getNetworkInfo() {
-  _serial->println(F("AT+QNWINFO"));
+  sendATRaw(F("AT+QNWINFO"));
   String resp = _collectResponse(2000);
   return _extractFirstLine(resp);
 }
@@ -1786,12 +4917,12 @@ bool QuectelEC200U::setTCPConfig(const String &param, const String &value) {
 }
 
 String QuectelEC200U::getSocketStatus(int connectID) {
-    _serial->println("AT+QISTATE=" + String(connectID));
+    sendATRaw("AT+QISTATE=" + String(connectID));
     return readResponse(1000);
 }
 
 int QuectelEC200U::getTCPError() {
-    _serial->println(F("AT+QIGETERROR"));
+    sendATRaw(F("AT+QIGETERROR"));
     String resp = readResponse(1000);
     return _parseCsvInt(resp, F("+QIGETERROR: "), 0);
 }
@@ -1831,12 +4962,12 @@ bool QuectelEC200U::setConnectionTimeout(int seconds) {
 
 // ===== Phonebook Commands =====
 String QuectelEC200U::getSubscriberNumber() {
-    _serial->println(F("AT+CNUM"));
+    sendATRaw(F("AT+CNUM"));
     return readResponse(1000);
 }
 
 String QuectelEC200U::findPhonebookEntries(const String &findtext) {
-    _serial->println("AT+CPBF=\"" + findtext + "\"");
+    sendATRaw("AT+CPBF=\"" + findtext + "\"");
     return readResponse(5000);
 }
 
@@ -1845,7 +4976,7 @@ String QuectelEC200U::readPhonebookEntry(int index1, int index2) {
     if (index2 != -1) {
         cmd += "," + String(index2);
     }
-    _serial->println(cmd);
+    sendATRaw(cmd);
     return readResponse(5000);
 }
 
@@ -1867,7 +4998,7 @@ bool QuectelEC200U::setServiceCenterAddress(const String &sca) {
 }
 
 String QuectelEC200U::listMessages(const String &stat) {
-    _serial->println("AT+CMGL=\"" + stat + "\"");
+    sendATRaw("AT+CMGL=\"" + stat + "\"");
     return readResponse(10000);
 }
 
@@ -1934,12 +5065,12 @@ bool QuectelEC200U::sendHexData(int connectID, const String &hex_string) {
 
 // ===== Advanced Error Reporting and SIM =====
 String QuectelEC200U::getExtendedErrorReports() {
-    _serial->println(F("AT+CEER"));
+    sendATRaw(F("AT+CEER"));
     return readResponse(2000);
 }
 
 String QuectelEC200U::getSIMStatus() {
-    _serial->println(F("AT+CPIN?"));
+    sendATRaw(F("AT+CPIN?"));
     return readResponse(1000);
 }
 
@@ -1960,6 +5091,9 @@ void QuectelEC200U::powerOn(int pin) {
 
 // [A] Network & SIM Control
 bool QuectelEC200U::switchSimCard() {
+    _info.imsi[0] = '\0';
+    _info.iccid[0] = '\0';
+    _bootURCs &= ~BOOT_URC_SIM_READY;
     return sendAT(F("AT+QSIMCHK"));
 }
 
@@ -14,11 +14,92 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "ATTokenizer.h"
 
 // Command history for Ctrl+Z functionality
 #define MAX_HISTORY 20
 #define MAX_CMD_LENGTH 256
 #define HTTP_URL_CHUNK_SIZE 2048
+#ifndef HTTP_STREAM_CHUNK_SIZE
+#define HTTP_STREAM_CHUNK_SIZE 256
+#endif
+#ifndef HTTP_UPLOAD_CHUNK_SIZE
+#define HTTP_UPLOAD_CHUNK_SIZE 256
+#endif
+// AT+QHTTPPOST <input_time> (s): how long the module waits for the whole body
+#ifndef HTTP_POST_INPUT_TIME
+#define HTTP_POST_INPUT_TIME 60
+#endif
+
+// Asynchronous AT engine: pending command slots and per-command response buffer
+#define AT_QUEUE_SIZE 8
+#define AT_RESPONSE_BUFFER_SIZE 256
+
+// Unsolicited result code (URC) dispatcher: MAX_URC_HANDLERS is what onURC()
+// may register; the library's own handlers have URC_LIBRARY_HANDLERS slots on top
+#define MAX_URC_HANDLERS 8
+#define URC_LIBRARY_HANDLERS 13
+#define URC_LINE_MAX 160
+
+// MQTT: client indexes of AT+QMT*, subscriptions with a callback, buffered
+// receive (AT+QMTCFG="recv/mode") payload limit and blocking-call timeouts
+#define EC200U_MQTT_CLIENTS 6
+#ifndef MQTT_MAX_SUBSCRIPTIONS
+#define MQTT_MAX_SUBSCRIPTIONS 8
+#endif
+#ifndef MQTT_RX_BUFFER_SIZE
+#define MQTT_RX_BUFFER_SIZE 1024
+#endif
+#ifndef MQTT_TOPIC_MAX
+#define MQTT_TOPIC_MAX 128
+#endif
+#ifndef MQTT_OPEN_TIMEOUT
+#define MQTT_OPEN_TIMEOUT 30000
+#endif
+#ifndef MQTT_ACK_TIMEOUT
+#define MQTT_ACK_TIMEOUT 20000
+#endif
+#ifndef MQTT_MAX_INFLIGHT
+#define MQTT_MAX_INFLIGHT 8           // mqttPublishAsync() messages awaiting +QMTPUB, all clients
+#endif
+#ifndef MQTT_RECV_QUEUE
+#define MQTT_RECV_QUEUE 4             // +QMTRECV messages waiting for poll() to deliver them
+#endif
+
+// Network tracker: waitForNetwork() re-queries this often in case a URC was lost
+#ifndef NETWORK_RECHECK_MS
+#define NETWORK_RECHECK_MS 30000
+#endif
+
+// Socket manager: connectIDs supported by the module and per-socket receive ring
+#define EC200U_MAX_SOCKETS 12
+#ifndef SOCKET_RX_BUFFER_SIZE
+#define SOCKET_RX_BUFFER_SIZE 512
+#endif
+#define SOCKET_READ_MAX 1500
+// Listeners: incoming connections waiting for socketAccept()
+#ifndef SOCKET_ACCEPT_QUEUE
+#define SOCKET_ACCEPT_QUEUE 4
+#endif
+// Largest AT+QISEND frame; bigger writes are split into frames of this size
+#ifndef SOCKET_SEND_MAX
+#define SOCKET_SEND_MAX 1460
+#endif
+
+// Fast boot: how long begin() keeps probing a module that is still starting,
+// and how long it waits for the SIM once the module answers
+#ifndef FAST_BOOT_TIMEOUT
+#define FAST_BOOT_TIMEOUT 10000
+#endif
+#ifndef FAST_BOOT_SIM_TIMEOUT
+#define FAST_BOOT_SIM_TIMEOUT 5000
+#endif
+
+// Per-command metrics, compiled in with -DEC200U_ENABLE_METRICS
+#ifndef EC200U_METRICS_SLOTS
+#define EC200U_METRICS_SLOTS 32
+#endif
+#define EC200U_METRICS_CMD_LEN 16
 
 // Modem states
 enum ModemState {
@@ -58,6 +139,143 @@ enum class ErrorCode {
   FS_ERROR = -70,
 };
 
+// Socket states tracked by the socket manager
+enum SocketState {
+  SOCKET_CLOSED,
+  SOCKET_OPENING,
+  SOCKET_CONNECTED,
+  SOCKET_REMOTE_CLOSED,  // Peer closed; buffered data can still be read
+  SOCKET_LISTENING       // "TCP LISTENER" waiting for incoming connections
+};
+
+// Data access modes of AT+QIOPEN
+#define SOCKET_ACCESS_BUFFER 0
+#define SOCKET_ACCESS_PUSH 1
+#define SOCKET_ACCESS_TRANSPARENT 2
+
+// Outcome of the last tcpWrite()/socketWrite()
+struct SocketSendStats {
+  uint32_t bytes;           // Acknowledged with SEND OK
+  uint16_t frames;          // AT+QISEND frames acknowledged
+  uint16_t failed;          // Frames answered with SEND FAIL or ERROR
+  uint32_t elapsedMs;
+  uint32_t bytesPerSecond;  // Effective upstream throughput
+};
+
+// Lifecycle of a command queued with sendATAsync()
+enum class ATStatus {
+  NONE,       // Unknown handle (never issued or already recycled)
+  QUEUED,
+  RUNNING,
+  SUCCESS,
+  FAILED,
+  TIMEOUT,
+  CANCELLED
+};
+
+// Static module and SIM identity kept by the device-info cache
+enum class DeviceInfoField {
+  IMEI,           // AT+GSN
+  IMSI,           // AT+CIMI
+  ICCID,          // AT+QCCID
+  MANUFACTURER,   // AT+GMI
+  MODEL,          // AT+GMM
+  FIRMWARE,       // AT+GMR
+  VERSION         // ATI, lines joined with '\n'
+};
+
+// Completion callback for sendATAsync(). 'response' holds everything the modem
+// returned for the command and is only valid for the duration of the call.
+typedef void (*ATCallback)(int handle, ATStatus status, const char *response, void *ctx);
+
+// URC handler. 'urc' is the complete line without CR/LF and is only valid for the
+// duration of the call. Handlers run from inside the receive path, so they must
+// not issue blocking AT commands (queue them with sendATAsync() instead).
+typedef void (*URCHandler)(const char *urc, void *ctx);
+
+// Receives an HTTP response body piece by piece. Return false to stop delivery;
+// the rest of the body is still drained from the modem.
+typedef bool (*HttpBodyCallback)(const uint8_t *data, size_t len, void *ctx);
+
+// Supplies an HTTP request body piece by piece: fill up to 'maxLen' bytes of
+// 'buffer' and return how many were written (0 = no more data).
+typedef size_t (*HttpBodySource)(uint8_t *buffer, size_t maxLen, void *ctx);
+
+// Network state kept from the registration (+CREG/+CGREG/+CEREG), signal
+// (+CSQ, +QIND: "csq") and PDP deactivation URCs. Replies to the matching
+// queries update it as well.
+struct NetworkState {
+  int8_t creg;          // <stat> per domain: 1 home, 5 roaming, -1 unknown
+  int8_t cgreg;
+  int8_t cereg;
+  uint8_t csq;          // 0..31, 99 = unknown
+  uint8_t pdpLost;      // Bit (contextID - 1) set by +QIURC: "pdpdeact"
+  uint32_t changedMs;   // millis() of the last change
+};
+
+// 'changed' bits passed to a NetworkCallback
+#define NETWORK_CHANGED_REGISTRATION 0x01
+#define NETWORK_CHANGED_SIGNAL 0x02
+#define NETWORK_CHANGED_PDP 0x04
+
+// Called from the receive path when the network state changes; the same rules
+// as for URC handlers apply.
+typedef void (*NetworkCallback)(const NetworkState &state, uint8_t changed, void *ctx);
+
+enum MqttState {
+  MQTT_DISCONNECTED,
+  MQTT_OPEN,            // Network connection open, CONNECT not (yet) accepted
+  MQTT_CONNECTED
+};
+
+// Session settings applied with AT+QMTCFG before AT+QMTOPEN/AT+QMTCONN. The
+// strings are only read during mqttConnect().
+struct MqttOptions {
+  const char *clientId = "ec200u";
+  const char *username = nullptr;
+  const char *password = nullptr;
+  uint16_t keepAlive = 120;          // Seconds
+  bool cleanSession = true;
+  int8_t sslContext = -1;            // AT+QSSLCFG context for MQTT over TLS, -1 = plain TCP
+  uint8_t pdpContext = 1;
+  uint8_t version = 4;               // 3 = MQTT 3.1, 4 = MQTT 3.1.1
+  const char *willTopic = nullptr;   // Last will, published by the broker if the link dies
+  const char *willMessage = nullptr;
+  uint8_t willQos = 0;
+  bool willRetain = false;
+  bool bufferedReceive = false;      // Messages wait in the module and are read from poll()
+};
+
+// Inbound MQTT message. Runs from poll(), outside any AT exchange, so it may
+// issue AT commands. 'topic' and 'payload' are only valid for the duration of
+// the call.
+typedef void (*MqttMessageHandler)(int client, const char *topic, const uint8_t *payload, size_t length, void *ctx);
+
+// Outcome of a mqttPublishAsync() message: acknowledged by the broker, or
+// failed (rejected, connection lost, no ack within MQTT_ACK_TIMEOUT).
+// 'latencyMs' runs from the AT+QMTPUB command to the acknowledgement. Runs
+// from poll(), outside any AT exchange, so it may publish again.
+typedef void (*MqttPublishCallback)(int client, uint16_t msgId, bool acked, uint32_t latencyMs, void *ctx);
+
+// A listener accepted a connection on 'socketId' (connected, with its own
+// receive ring). Runs from poll(), outside any AT exchange, so it may issue
+// AT commands.
+typedef void (*SocketAcceptCallback)(int listenerId, int socketId, const char *remoteIp, uint16_t remotePort, void *ctx);
+
+// Counters for one AT command (name up to the first '=', '?' or ';'). Row 0,
+// "URC", collects traffic seen outside any command; the last row, "*", takes
+// every command once the table is full.
+struct ATMetrics {
+  char command[EC200U_METRICS_CMD_LEN];
+  uint32_t calls;
+  uint32_t failures;
+  uint32_t timeouts;
+  uint32_t bytesSent;
+  uint32_t bytesReceived;
+  uint32_t totalLatencyMs;
+  uint32_t maxLatencyMs;
+};
+
 class QuectelEC200U {
   public:
     // HardwareSerial constructor (auto-configure on begin). On ESP32, optional RX/TX pins are supported.
@@ -67,6 +285,11 @@ class QuectelEC200U {
     QuectelEC200U(Stream &stream);
 
     bool begin(bool forceReinit = false);
+
+    // Fast boot: begin() skips the settle delay and the informational queries.
+    // Readiness comes from the RDY / +CPIN: READY URCs (or a single probe), the
+    // configuration is one "ATE0V1;+CMEE=2" line and the identity one query.
+    void setFastBoot(bool enable) { _fastBoot = enable; }
     
     // Power Management
     void powerOn(int pin);
@@ -80,6 +303,29 @@ class QuectelEC200U {
     bool sendCommand(const String &cmd, const String &expected, uint32_t timeout = 1000);
     void enableDebug(Stream &debugSerial);
 
+    // Asynchronous AT engine (non-blocking, drive with poll() from loop()).
+    // 'expect' is matched against the start of lines: a final result code
+    // starting with it completes the command, and any other line starting
+    // with it (e.g. "+QNTP: 0") completes it together with the final code.
+    int sendATAsync(const String &cmd, ATCallback callback = nullptr, void *ctx = nullptr, uint32_t timeout = 1000, const String &expect = "OK");
+    void poll();
+    ATStatus getATStatus(int handle) const;
+    bool cancelAT(int handle);
+    bool isBusy() const { return _asyncCount > 0; }
+    size_t pendingCommands() const { return _asyncCount; }
+
+    // URC dispatcher. 'prefix' is matched against the start of each received line
+    // and must stay valid while registered (use a string literal).
+    bool onURC(const char *prefix, URCHandler handler, void *ctx = nullptr);
+    bool removeURC(const char *prefix, URCHandler handler);
+
+    // Per-command metrics (empty unless built with EC200U_ENABLE_METRICS)
+    size_t metricsCount() const;
+    const ATMetrics *metrics(size_t index) const;
+    const ATMetrics *findMetrics(const char *command) const;
+    void resetMetrics();
+    size_t printMetricsJson(Print &out) const;
+
     // Advanced Features
     bool switchSimCard();
     bool toggleISIM(bool enable);
@@ -118,6 +364,12 @@ class QuectelEC200U {
     bool setNetworkScanMode(int mode);
     bool setBand(const String &gsm_mask, const String &lte_mask);
 
+    // Device-info cache: each field is queried once (at boot or on first use)
+    // and then served from memory. The pointer stays valid until the cache is
+    // invalidated; "" when the module did not answer.
+    const char *getDeviceInfo(DeviceInfoField field);
+    void invalidateDeviceInfo();
+
     // Core Utilities
     String getIMEI();
     int getSignalStrength();
@@ -152,6 +404,19 @@ class QuectelEC200U {
 
     [[deprecated("Use begin() instead")]] bool modem_init();
     
+    // Network state tracker. enableNetworkURCs() turns on the unsolicited
+    // registration (and signal) reports and seeds the state with one query;
+    // from then on the getters below cost no UART traffic.
+    bool enableNetworkURCs(bool signal = true);
+    const NetworkState &networkState() const { return _net; }
+    bool isNetworkReady() const { return _networkRegistered; }
+    ModemState getState() const { return _state; }
+    void onNetworkChange(NetworkCallback callback, void *ctx = nullptr);
+    // Clears the "pdpdeact" bit of a context brought back other than by
+    // activatePDP() (e.g. AT+QIACT through sendATAsync()); reports
+    // NETWORK_CHANGED_PDP if it was set
+    void clearPdpLost(int contextId);
+
     // Network + PDP
     bool waitForNetwork(uint32_t timeoutMs = 60000);
     bool attachData(const char* apn, const char* user = "", const char* pass = "", int auth = 0);
@@ -182,21 +447,149 @@ class QuectelEC200U {
     bool httpsPost(const String &url, const String &data, String &response, String headers[] = nullptr, size_t header_size = 0);
     bool httpsPost(const String &url, const JsonDocument &json, String &response, String headers[] = nullptr, size_t header_size = 0);
 
+    // Streaming HTTP(S) download: the body is handed over in HTTP_STREAM_CHUNK_SIZE
+    // pieces while AT+QHTTPREAD runs, so memory use does not depend on its size
+    bool httpGetStream(const String &url, HttpBodyCallback onBody, void *ctx = nullptr, String headers[] = nullptr, size_t header_size = 0);
+    bool httpGetStream(const String &url, Print &sink, String headers[] = nullptr, size_t header_size = 0);
+    bool httpsGetStream(const String &url, HttpBodyCallback onBody, void *ctx = nullptr, String headers[] = nullptr, size_t header_size = 0);
+    bool httpsGetStream(const String &url, Print &sink, String headers[] = nullptr, size_t header_size = 0);
+
+    // Streaming HTTP(S) upload: exactly 'length' body bytes are pulled from 'source'
+    // (or read from 'body') and written after CONNECT in HTTP_UPLOAD_CHUNK_SIZE
+    // pieces. The JsonDocument overloads of httpPost()/httpsPost() stream the same way.
+    // If the source ends early the call blocks until the module drops the upload
+    // (at most HTTP_POST_INPUT_TIME seconds after CONNECT) and returns false.
+    bool httpPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[] = nullptr, size_t header_size = 0);
+    bool httpPostStream(const String &url, Stream &body, size_t length, String &response, String headers[] = nullptr, size_t header_size = 0);
+    bool httpsPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[] = nullptr, size_t header_size = 0);
+    bool httpsPostStream(const String &url, Stream &body, size_t length, String &response, String headers[] = nullptr, size_t header_size = 0);
+    int httpStatusCode() const { return _httpStatus; }
+    long httpContentLength() const { return _httpContentLength; }  // -1 when not announced
+    uint32_t httpRoundTripsSaved() const { return _httpSavedRoundTrips; }
+    // PDP and SSL context of the http*() / https*() requests (1 and 1 by default)
+    void setHttpContext(int contextId, int sslContextId = 1);
+    int httpContextId() const { return _httpContextId; }
+    int httpSslContextId() const { return _httpSslContextId; }
+
+    // One POST in steps, for callers that build the body while the module
+    // waits (HttpSession::postBatch()). httpPostBegin() configures the request
+    // (HTTPS by the URL scheme) and waits for CONNECT; httpPostWrite() takes
+    // exactly 'length' body bytes in all; httpPostEnd() waits for +QHTTPPOST
+    // and reads the response into 'response' when one is given. A body left
+    // short is not padded: httpPostEnd() waits for the module to drop it.
+    bool httpPostBegin(const String &url, size_t length, String headers[] = nullptr, size_t header_size = 0);
+    size_t httpPostWrite(const uint8_t *data, size_t length);
+    bool httpPostEnd(String *response = nullptr);
+
     // Error handling
     ErrorCode getLastError();
     String getLastErrorString();
     
-    // MQTT
+    // MQTT (client 0, clean session, client ID "ec200u", QoS 0)
     bool mqttConnect(const String &server, int port);
     bool mqttPublish(const String &topic, const String &message);
     bool mqttSubscribe(const String &topic);
-    bool mqttDisconnect();
+
+    // MQTT clients 0..EC200U_MQTT_CLIENTS-1. Subscribed messages go to the
+    // subscription's handler, or to the onMqttMessage() handler when it has none.
+    bool mqttConnect(int client, const String &server, int port, const MqttOptions &options);
+    bool mqttDisconnect(int client = 0);
+    bool mqttPublish(int client, const String &topic, const String &message, uint8_t qos = 0, bool retain = false);
+    bool mqttPublish(int client, const String &topic, const uint8_t *payload, size_t length, uint8_t qos = 0, bool retain = false);
+    bool mqttSubscribe(int client, const String &topic, uint8_t qos = 0, MqttMessageHandler handler = nullptr, void *ctx = nullptr);
+    bool mqttUnsubscribe(int client, const String &topic);
+    void onMqttMessage(MqttMessageHandler handler, void *ctx = nullptr);
+    MqttState mqttState(int client = 0) const;
+    bool mqttConnected(int client = 0) const { return mqttState(client) == MQTT_CONNECTED; }
+    int mqttError(int client = 0) const;   // Last +QMTOPEN/+QMTCONN/+QMTSTAT failure code
+
+    // Pipelined publishing: returns once the module has taken the message, and
+    // the broker's acknowledgement is reported to onMqttPublished() from poll().
+    // Returns the message id (QoS 1/2), 0 (QoS 0) or -1 when not sent, e.g.
+    // while the in-flight window is full (mqttCanPublish() is false).
+    int mqttPublishAsync(int client, const String &topic, const String &message, uint8_t qos = 1, bool retain = false);
+    int mqttPublishAsync(int client, const String &topic, const uint8_t *payload, size_t length, uint8_t qos = 1, bool retain = false);
+    bool mqttCanPublish(int client) const;
+    uint8_t mqttInFlight(int client) const;
+    void setMqttWindow(uint8_t window);    // Per client, 1..MQTT_MAX_INFLIGHT
+    void onMqttPublished(MqttPublishCallback callback, void *ctx = nullptr);
     
     // TCP sockets
     int tcpOpen(const String &host, int port, int ctxId = 1, int socketId = 0);
     bool tcpSend(int socketId, const String &data);
     bool tcpRecv(int socketId, String &out, size_t bytes = 512, uint32_t timeout = 5000);
+    // Binary-safe and allocation-free. tcpWrite() returns the bytes accepted
+    // (split into AT+QISEND frames as needed); tcpRead() returns what is
+    // available, waiting up to 'timeout' for the first byte. Buffer-mode reads
+    // copy the AT+QIRD payload (up to SOCKET_READ_MAX) straight into 'buffer'.
+    size_t tcpWrite(int socketId, const uint8_t *data, size_t length, uint32_t timeout = 5000);
+    size_t tcpRead(int socketId, uint8_t *buffer, size_t length, uint32_t timeout = 5000);
+    // With pipelining on (the default), the AT+QISEND of the next frame is
+    // written right behind the payload of the current one, so the module
+    // answers "> " as soon as it has reported SEND OK.
+    void setSendPipelining(bool enable) { _sendPipelining = enable; }
+    const SocketSendStats &sendStats() const { return _sendStats; }
     bool tcpClose(int socketId);
+
+    // Socket manager (all 12 connectIDs, URC-driven receive rings)
+    int socketOpen(const String &host, int port, int socketId = -1, int ctxId = 1, int accessMode = SOCKET_ACCESS_BUFFER);
+    bool socketWaitConnected(int socketId, uint32_t timeout = 15000);
+    SocketState socketState(int socketId) const;
+    int socketError(int socketId) const;
+    size_t socketAvailable(int socketId);
+    int socketRead(int socketId, uint8_t *buf, size_t len);
+    int socketPeek(int socketId);
+    size_t socketWrite(int socketId, const uint8_t *buf, size_t len, uint32_t timeout = 5000);
+    bool socketClose(int socketId);
+    int findFreeSocket() const;
+    // Non-blocking pieces for code driven from poll() (ConnectionSupervisor).
+    // socketOpenAsync() marks the slot SOCKET_OPENING and queues AT+QIOPEN with
+    // sendATAsync(), returning its handle or -1; +QIOPEN completes the open as
+    // for socketOpen(). socketDiscard() frees the slot without waiting for the
+    // module, queueing AT+QICLOSE if asked. socketRxCount() is what the receive
+    // ring holds, without polling.
+    int socketOpenAsync(const String &host, int port, int socketId, int ctxId = 1, int accessMode = SOCKET_ACCESS_BUFFER,
+                        ATCallback callback = nullptr, void *ctx = nullptr);
+    void socketDiscard(int socketId, bool closeOnModule = false);
+    size_t socketRxCount(int socketId) const;
+
+    // UDP datagrams. udpOpen() starts a "UDP SERVICE" on 'localPort' that can
+    // send to and receive from any address; udpConnect() a "UDP" client bound
+    // to one peer. Both use buffer access mode and keep no ring: udpReceive()
+    // reads one datagram with AT+QIRD straight into 'buffer' (a buffer of
+    // SOCKET_READ_MAX bytes holds any datagram) and reports the sender, and
+    // udpSend()/udpSendTo() pass 'data' to AT+QISEND as one datagram of at
+    // most SOCKET_SEND_MAX bytes. udpReceive() returns the datagram length,
+    // 0 when none arrived within 'timeout', -1 on error.
+    int udpOpen(uint16_t localPort, int socketId = -1, int ctxId = 1);
+    int udpConnect(const String &host, int port, int socketId = -1, int ctxId = 1);
+    bool udpSend(int socketId, const uint8_t *data, size_t length, uint32_t timeout = 5000);
+    bool udpSendTo(int socketId, const char *ip, uint16_t port, const uint8_t *data, size_t length, uint32_t timeout = 5000);
+    int udpReceive(int socketId, uint8_t *buffer, size_t length, char *remoteIp = nullptr, size_t ipSize = 0,
+                   uint16_t *remotePort = nullptr, uint32_t timeout = 0);
+
+    // TCP server. tcpListen() opens a "TCP LISTENER" on 'localPort'; each
+    // +QIURC: "incoming" attaches the connectID the module picked as a
+    // connected socket and queues it (up to SOCKET_ACCEPT_QUEUE, further
+    // connections are closed). socketAccept() returns the next one or -1
+    // without blocking; with an onSocketAccept() callback, poll() hands each
+    // one to the callback instead.
+    int tcpListen(uint16_t localPort, int socketId = -1, int ctxId = 1, int accessMode = SOCKET_ACCESS_BUFFER);
+    int socketAccept(int listenerId, char *remoteIp = nullptr, size_t ipSize = 0, uint16_t *remotePort = nullptr);
+    void onSocketAccept(SocketAcceptCallback callback, void *ctx = nullptr);
+
+    // Transparent access mode: the UART carries raw socket data until "+++".
+    // Use TransparentSocket (TransparentSocket.h) to stream through it.
+    bool transparentEnter(int socketId, uint32_t timeout = 5000);
+    bool transparentExit(uint32_t guardTime = 1000);
+    int transparentSocket() const { return _transparentId; }
+    // Raw socket data while in transparent mode (nothing outside it). Reads
+    // watch for NO CARRIER, which marks the socket closed and ends the mode.
+    int transparentAvailable();
+    size_t transparentRead(uint8_t *buf, size_t size);
+    int transparentPeek();
+    size_t transparentWrite(const uint8_t *buf, size_t size);
+    void transparentFlush();
     
     // USSD
     bool sendUSSD(const String &code, String &response);
@@ -227,10 +620,31 @@ class QuectelEC200U {
     bool fsRead(const String &path, String &out, size_t length = 0);
     bool fsDelete(const String &path);
     bool fsExists(const String &path);
+
+    // Byte-level file access through a handle (AT+QFOPEN/QFREAD/QFWRITE/QFSEEK/
+    // QFCLOSE). Modes: 0 = open or create, 1 = create or truncate, 2 = read only.
+    // Origins: 0 = start, 1 = current position, 2 = end of file.
+    int fsOpen(const String &path, int mode = 0);
+    int fsRead(int handle, uint8_t *buffer, size_t length);
+    int fsWrite(int handle, const uint8_t *data, size_t length);
+    bool fsSeek(int handle, long offset, int origin = 0);
+    bool fsClose(int handle);
+    long fsSize(const String &path);   // -1 when the file does not exist
     
     // SSL/TLS
     bool sslConfigure(int ctxId, const String &caPath, bool verify = true);
     bool sslUploadCert(const String &cert, const String &path);
+    bool sslSetSessionResumption(int sslCtxId, bool enable);
+    bool sslSetSNI(int sslCtxId, bool enable);
+    bool sslSetNegotiateTimeout(int sslCtxId, uint16_t seconds);
+
+    // TLS socket (AT+QSSLOPEN) on a connectID of the socket manager, using
+    // the settings of SSL context 'sslCtxId'. Like socketOpen() it returns at
+    // once; wait with socketWaitConnected() (the handshake takes seconds), then
+    // use the socket*() / tcpRead() / tcpWrite() calls or a QuectelClient.
+    // Buffer and direct push access modes only; a connectID already in use
+    // is refused.
+    int sslOpen(const String &host, int port, int sslCtxId = 1, int socketId = -1, int ctxId = 1, int accessMode = SOCKET_ACCESS_BUFFER);
     
     // PSM
     bool enablePSM(bool enable);
@@ -259,10 +673,12 @@ class QuectelEC200U {
     
     // NTP
     bool ntpSync(const String &server, int timezone, int contextID = 1, int port = 123);
+    int ntpSyncAsync(const String &server, int timezone, ATCallback callback, void *ctx = nullptr, int contextID = 1, int port = 123);
 
     // DNS
     bool setDNS(const String &primary, const String &secondary, int contextID = 1);
     String getIpByHostName(const String &hostname, int contextID = 1);
+    int getIpByHostNameAsync(const String &hostname, ATCallback callback, void *ctx = nullptr, int contextID = 1);
 
     // ADC
     int readADC();
@@ -339,6 +755,7 @@ class QuectelEC200U {
     bool deactivatePDPAsync(int ctxId = 1);
 
 
+    String getWifiScan();
     String scanBluetooth();
     String getManufacturerIdentification();
     String getModelIdentification();
@@ -373,21 +790,287 @@ class QuectelEC200U {
     bool _echoDisabled;
     bool _simChecked;
     bool _networkRegistered;
+
+    // Fast boot and the boot URCs seen since the module last started
+    bool _fastBoot;
+    uint8_t _bootURCs;
+
+    // Network state tracker
+    NetworkState _net;
+    bool _netURCs;
+    NetworkCallback _netCallback;
+    void *_netCallbackCtx;
+
+    // Identity read at boot or on first use (empty = not read yet)
+    struct DeviceInfo {
+      char imei[17];
+      char imsi[17];
+      char iccid[24];
+      char manufacturer[24];
+      char model[24];
+      char firmware[40];
+      char version[80];
+    };
+    DeviceInfo _info;
+
+    // Result of the last HTTP(S) request
+    int _httpStatus;
+    long _httpContentLength;
+    int _httpContextId;
+    int _httpSslContextId;
+    size_t _httpBodyLeft;        // Body bytes httpPostWrite() still owes the module
+    uint32_t _httpConnectMs;
+
+    // AT+QHTTPCFG / AT+QHTTPURL state the module is known to hold, so repeated
+    // requests only send what changed. Cleared whenever the module may have lost it.
+    struct HttpConfigCache {
+      int contextId;          // -1 = unknown
+      int sslContextId;       // -1 = unknown
+      int8_t requestHeader;   // -1 = unknown, 0 = off, 1 = on
+      uint32_t headerHash;
+      uint32_t urlHash;
+      size_t urlLength;       // 0 = unknown
+    };
+    HttpConfigCache _httpCfg;
+    uint32_t _httpSavedRoundTrips;
+
+    // Asynchronous AT engine
+    struct PendingCommand {
+      String cmd;
+      String expect;
+      uint32_t timeout;
+      ATCallback callback;
+      void *ctx;
+      int handle;
+    };
+    PendingCommand _asyncQueue[AT_QUEUE_SIZE];
+    size_t _asyncHead;
+    size_t _asyncCount;
+    bool _asyncRunning;
+    bool _asyncMatched;      // A line starting with 'expect' has been seen
+    bool _asyncFinal;        // The command's final result code has been seen
+    bool _inPoll;
+    uint32_t _asyncStart;
+    char _asyncBuf[AT_RESPONSE_BUFFER_SIZE];
+    char _asyncLine[URC_LINE_MAX];   // Start of the line being read, for matching
+    ATTokenizer _asyncTok;
+    int _nextHandle;
+    int _statusHandle[AT_QUEUE_SIZE];
+    ATStatus _statusValue[AT_QUEUE_SIZE];
+    bool _rxBusy;
+
+    // URC dispatcher
+    struct URCEntry {
+      const char *prefix;
+      uint8_t length;
+      URCHandler handler;
+      void *ctx;
+    };
+    URCEntry _urcHandlers[MAX_URC_HANDLERS + URC_LIBRARY_HANDLERS];
+    uint8_t _urcCount;
+    uint8_t _urcLibrary;     // Entries registered by the library itself
+    char _urcBuf[URC_LINE_MAX];
+    ATTokenizer _urcTok;
+
+    // Socket manager
+    struct SocketSlot {
+      SocketState state;
+      uint8_t accessMode;
+      bool datagram;         // UDP: read per datagram with AT+QIRD, no ring
+      bool tls;              // AT+QSSLOPEN client: AT+QSSLSEND / AT+QSSLRECV
+      bool dataPending;
+      int error;
+      uint8_t *rx;
+      size_t rxHead;
+      size_t rxCount;
+      size_t rxOverflow;
+    };
+    SocketSlot _sockets[EC200U_MAX_SOCKETS];
+    bool _socketURCsRegistered;
+    struct PendingAccept {
+      int8_t listener;
+      int8_t socketId;
+      uint16_t port;
+      char ip[16];
+    };
+    PendingAccept _accepts[SOCKET_ACCEPT_QUEUE];
+    uint8_t _acceptCount;
+    SocketAcceptCallback _acceptCallback;
+    void *_acceptCtx;
+    int _rawSocket;
+    size_t _rawRemaining;
+    bool _sendPipelining;
+    SocketSendStats _sendStats;
+
+    // MQTT clients. Results of +QMTOPEN/+QMTCONN/+QMTSUB/+QMTUNS/+QMTPUB are
+    // stored by the URC handler for the blocking call waiting on them.
+    struct MqttSlot {
+      MqttState state;
+      int8_t openResult;
+      int8_t connResult;
+      int8_t error;
+      uint16_t nextMsgId;
+      uint16_t ackId;
+      int8_t ackResult;
+      uint8_t recvPending;   // Buffered receive: recv_id bits announced by +QMTRECV
+    };
+    struct MqttSubscription {
+      int8_t client;         // -1 = free
+      uint8_t qos;
+      String filter;
+      MqttMessageHandler handler;
+      void *ctx;
+    };
+    MqttSlot _mqtt[EC200U_MQTT_CLIENTS];
+    MqttSubscription _mqttSubs[MQTT_MAX_SUBSCRIPTIONS];
+    MqttMessageHandler _mqttHandler;
+    void *_mqttHandlerCtx;
+    bool _mqttURCsRegistered;
+    uint8_t *_mqttRx;
+    char *_mqttRecvQueue;    // MQTT_RECV_QUEUE lines of URC_LINE_MAX, allocated on first use
+    uint8_t _mqttRecvCount;
+    struct MqttInFlight {
+      int8_t client;         // -1 = free
+      int8_t result;         // MQTT_PENDING until +QMTPUB, then 0 acked / 1 failed until poll() reports it
+      uint16_t msgId;
+      uint32_t sentMs;
+      uint32_t latencyMs;
+    };
+    MqttInFlight _mqttInFlight[MQTT_MAX_INFLIGHT];
+    uint8_t _mqttWindow;
+    MqttPublishCallback _mqttPublished;
+    void *_mqttPublishedCtx;
+
+    // Transparent access mode
+    int _transparentId;
+    uint32_t _transparentLastTx;
+    uint8_t _transparentCarrier;   // Progress through "\r\nNO CARRIER\r\n"
+
+    // Final result code that ended the last _readResponse() (NONE = timeout)
+    ATToken _lastFinal;
+
+#ifdef EC200U_ENABLE_METRICS
+    // Sits between the library and the UART and charges every byte to the
+    // current metrics row
+    class MeteredStream : public Stream {
+      public:
+        Stream *inner;
+        QuectelEC200U *owner;
+        int available() override { return inner->available(); }
+        int read() override;
+        int peek() override { return inner->peek(); }
+        size_t write(uint8_t b) override;
+        size_t write(const uint8_t *buf, size_t size) override;
+        void flush() override { inner->flush(); }
+        using Print::write;
+    };
+    MeteredStream _meter;
+    ATMetrics _metrics[EC200U_METRICS_SLOTS];
+    uint8_t _metricsCount;
+    uint8_t _metricRow;           // Row UART traffic is charged to
+    bool _metricTiming;           // Latency of the row's last call still running
+    uint32_t _metricStart;
+#endif
     
     void flushInput();
-    bool expectURC(const String &tag, uint32_t timeout);
+    bool expectURC(const String &tag, uint32_t timeout, char *line = nullptr, size_t lineSize = 0);
     bool initializeModem();
+    bool _fastInitialize();
+    void _readIdentity();
+    static bool _copyDigits(const char *resp, uint8_t nth, char *dst, size_t size);
+    static bool _copyAfter(const char *resp, const char *tag, char *dst, size_t size);
+    static bool _copyLines(const char *resp, uint8_t maxLines, char *dst, size_t size);
+    static void _onBootURC(const char *urc, void *ctx);
+    void _initNetworkState();
+    bool _registerNetworkURCs();
+    void _networkChanged(uint8_t changed);
+    static void _onNetworkURC(const char *urc, void *ctx);
     void logDebug(const String &msg);
     void logError(const String &msg);
     void updateNetworkStatus();
     void _sendHttpHeaders(String headers[], size_t header_size);
     bool _sendHttpRequest(const String &url, const String &data, String &response, String headers[], size_t header_size, bool ssl, bool isPost);
     String _collectResponse(uint32_t timeout);
-    bool _extractHttpPayload(const String &raw, String &payload);
+    bool _httpBegin(const String &url, String headers[], size_t header_size, bool ssl);
+    bool _httpGet();
+    bool _httpPost(const String &data);
+    bool _httpPostBegin(size_t length);
+    bool _httpPostEnd();
+    void _httpPostAbort(uint32_t connectMs);
+    bool _httpFinish(bool sent, String &response);
+    bool _httpPostStream(const String &url, size_t length, HttpBodySource source, void *ctx, String &response, String headers[], size_t header_size, bool ssl);
+    bool _httpPostJson(const String &url, const JsonDocument &json, String &response, String headers[], size_t header_size, bool ssl);
+    static size_t _streamBodySource(uint8_t *buffer, size_t maxLen, void *ctx);
+    bool _httpRead(HttpBodyCallback onBody, void *ctx, uint32_t timeout);
+    void _httpInvalidateConfig();
+    static uint32_t _hashString(const String &s, uint32_t hash = 2166136261UL);
+    bool _httpGetStream(const String &url, HttpBodyCallback onBody, void *ctx, String headers[], size_t header_size, bool ssl);
+    bool _parseHttpResult(const char *fields);
+    static bool _printBodySink(const uint8_t *data, size_t len, void *ctx);
+    static bool _stringBodySink(const uint8_t *data, size_t len, void *ctx);
     String _getSignalStrengthString(int signal);
     String _getRegistrationStatusString(int regStatus);
     int _parseCsvInt(const String& response, const String& tag, int index);
     String _extractFirstLine(const String &resp) const;
+    int _readResponse(char *buffer, size_t length, uint32_t timeout, uint32_t finalMask);
+    void _initAsync();
+    void _startAsync();
+    void _pumpAsync();
+    void _finishAsync(ATStatus status);
+    void _awaitAsyncIdle();
+    void _setATStatus(int handle, ATStatus status);
+    bool _addURC(const char *prefix, URCHandler handler, void *ctx, bool library);
+    bool _dispatchURC(const ATSlice &line);
+    void _drainURCs();
+    bool _captureRaw(char c);
+    void _initSockets();
+    bool _registerSocketURCs();
+    bool _validSocket(int socketId) const;
+    bool _socketAttach(int socketId, SocketState state, int accessMode);
+    void _socketRelease(int socketId);
+    size_t _socketPush(int socketId, const uint8_t *data, size_t len);
+    bool _socketFill(int socketId);
+    void _serviceSockets();
+    void _reportAccepts();
+    void _initMqtt(bool subscriptions);
+    bool _validMqtt(int client) const;
+    uint16_t _mqttNextId(int client);
+    bool _mqttWait(const int8_t &result, uint32_t timeout);
+    bool _mqttSendSubscribe(int client, const String &topic, uint8_t qos);
+    bool _mqttSendPublish(int client, uint16_t msgId, const String &topic, const uint8_t *payload, size_t length, uint8_t qos, bool retain);
+    void _mqttPublishDone(int index, bool acked);
+    void _mqttReportPublished();
+    void _mqttDeliver(int client, const char *topic, const uint8_t *payload, size_t length);
+    void _mqttQueueMessage(const char *urc);
+    void _mqttDeliverQueued();
+    void _mqttDeliverURC(const char *urc);
+    bool _mqttReadBuffered(int client, uint8_t recvId);
+    void _serviceMqtt();
+    static bool _mqttTopicMatch(const char *filter, const char *topic);
+    static void _onMqttURC(const char *urc, void *ctx);
+    bool _writeCommand(const char *cmd);
+    int _readQIRD(int socketId, uint8_t *dst, size_t maxLen, uint32_t timeout,
+                  char *remoteIp = nullptr, size_t ipSize = 0, uint16_t *remotePort = nullptr);
+    size_t _sendData(int socketId, const uint8_t *buf, size_t len, uint32_t timeout);
+    bool _sendFrame(int socketId, size_t length, const char *ip = nullptr, uint16_t port = 0);
+    int _openService(const char *service, const String &host, int port, uint16_t localPort, int socketId, int ctxId, int accessMode);
+    static void _onSocketOpenURC(const char *urc, void *ctx);
+    static void _onSocketEventURC(const char *urc, void *ctx);
+    static void _onSocketRecvURC(const char *urc, void *ctx);
+    static void _onSocketClosedURC(const char *urc, void *ctx);
+    static void _onSocketIncomingURC(const char *urc, void *ctx);
+    void _transparentClosed();
+#ifdef EC200U_ENABLE_METRICS
+    void _initMetrics();
+    void _metricBegin(const char *cmd);
+    void _metricEnd(bool ok, bool timedOut);
+    void _metricIdle() { _metricRow = 0; }
+#else
+    void _initMetrics() {}
+    void _metricBegin(const char *) {}
+    void _metricEnd(bool, bool) {}
+    void _metricIdle() {}
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+  TransparentSocket - transparent access mode stream for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+*/
+
+#include "TransparentSocket.h"
+
+TransparentSocket::TransparentSocket(QuectelEC200U &modem) {
+  _modem = &modem;
+  _socketId = -1;
+}
+
+bool TransparentSocket::begin(int socketId, uint32_t timeout) {
+  if (!_modem->transparentEnter(socketId, timeout)) {
+    return false;
+  }
+  _socketId = socketId;
+  return true;
+}
+
+bool TransparentSocket::end(uint32_t guardTime) {
+  if (!active()) {
+    return true;
+  }
+  return _modem->transparentExit(guardTime);
+}
+
+bool TransparentSocket::connected() const {
+  return _socketId >= 0 && _modem->socketState(_socketId) == SOCKET_CONNECTED;
+}
+
+// Bytes received before begin() (or while escaping) are served from the socket
+// ring first so the stream stays in order.
+int TransparentSocket::available() {
+  if (_socketId < 0) {
+    return 0;
+  }
+  int n = (int)_modem->socketAvailable(_socketId);
+  if (active()) {
+    n += _modem->transparentAvailable();
+  }
+  return n;
+}
+
+int TransparentSocket::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+size_t TransparentSocket::read(uint8_t *buf, size_t size) {
+  if (_socketId < 0 || size == 0) {
+    return 0;
+  }
+  size_t n = 0;
+  if (_modem->socketAvailable(_socketId) > 0) {
+    n = _modem->socketRead(_socketId, buf, size);
+  }
+  if (n < size && active()) {
+    n += _modem->transparentRead(buf + n, size - n);
+  }
+  return n;
+}
+
+int TransparentSocket::peek() {
+  if (_socketId < 0) {
+    return -1;
+  }
+  if (_modem->socketAvailable(_socketId) > 0) {
+    return _modem->socketPeek(_socketId);
+  }
+  return active() ? _modem->transparentPeek() : -1;
+}
+
+size_t TransparentSocket::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t TransparentSocket::write(const uint8_t *buf, size_t size) {
+  return active() ? _modem->transparentWrite(buf, size) : 0;
+}
+
+void TransparentSocket::flush() {
+  if (active()) {
+    _modem->transparentFlush();
+  }
+}
@@ -0,0 +1,44 @@
+/*
+  TransparentSocket - transparent access mode stream for the QuectelEC200U library
+  Repository: https://github.com/MISTERNEGATIVE21/QuectelEC200U
+  License: MIT (see LICENSE)
+
+  Switches an open socket to transparent access mode (AT+QISWTMD=<id>,2) and
+  exposes it as a Stream: writes go straight to the UART and reads come straight
+  from it, with no AT+QISEND / +QIRD framing. end() returns the module to command
+  mode with the "+++" guard-time escape; the socket itself stays open.
+*/
+
+#ifndef TRANSPARENT_SOCKET_H
+#define TRANSPARENT_SOCKET_H
+
+#include <Arduino.h>
+#include "QuectelEC200U.h"
+
+class TransparentSocket : public Stream {
+  public:
+    TransparentSocket(QuectelEC200U &modem);
+
+    // 'socketId' must already be connected (socketOpen() or tcpOpen())
+    bool begin(int socketId, uint32_t timeout = 5000);
+    bool end(uint32_t guardTime = 1000);
+    bool active() const { return _socketId >= 0 && _modem->transparentSocket() == _socketId; }
+    bool connected() const;
+    int socketId() const { return _socketId; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    void flush() override;
+    size_t read(uint8_t *buf, size_t size);
+
+    using Print::write;
+
+  private:
+    QuectelEC200U *_modem;
+    int _socketId;
+};
+
+#endif